@@ -22,13 +22,27 @@
     "proj_exp_fire_file": "demo-data/cru-ts40_ar5_rcp85_ncar-ccsm4_toolik_field_station_10x10/projected-explicit-fire.nc",
     "output_dir":         "output/",
     "restart_from":       "", // default
+    "restart_handoff":    "memory", // Pass state between stages of a cell in memory ("memory"), through the restart file ("file"), or both, checking they match ("verify")
+    "restart_stages":     "pr,eq,sp,tr,sc", // With "memory" handoff, the stages whose restart files are written
+    "restart_format":     "netcdf", // Restart files as NetCDF (restart-XX.nc) or memory mapped binary checkpoints (restart-XX.bin)
     "output_spec_file":   "config/output_spec.csv",
     "output_monthly":     1, //JSON specific
     "output_nc_eq":       0,
     "output_nc_sp":       0,
     "output_nc_tr":       1,
     "output_nc_sc":       1, 
-    "output_interval":    1 
+    "output_interval":    1,
+    "async_output":       false, // Write NetCDF output from a dedicated writer stage
+    "output_queue_size":  4096,  // Max output blocks waiting for the writer
+    "output_io_threads":  1,     // Threads draining the writer queue
+    "mpi_collective_output": false, // MPI builds: write blocks of rows collectively
+    "collective_block_rows": 1,     // Rows of cells per collectively written block
+    "time_major_tile_rows":  1,     // Rows of cells held in memory by --loop-order=time-major
+    "cell_cost_file":     "",       // Copy of an earlier run_status.nc; its total_runtime orders the cells
+    "climate_tile_rows":  0,        // Rows of climate read at once (rounded up to the file's chunks); 0 reads per cell
+    "climate_tile_cache": 2,        // Climate tiles held in memory at once
+    "checkpoint_interval": 0,       // Save each cell's state every N years of a stage, for --resume; 0 for none. Space-major loop only
+    "solver_stats":       false     // Write soil temperature/water solver step counts per cell and month to solver_stats.nc
   },
 
   // Define storage locations for json files generated and used
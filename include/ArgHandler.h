@@ -2,6 +2,7 @@
 #define _ARGHANDLER_H
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
@@ -32,6 +33,10 @@ class ArgHandler {
 
   std::string max_output_volume;
   bool no_output_cleanup;
+  bool resume;
+  bool write_daily_drivers;
+  std::string read_daily_drivers;
+  bool no_forcing_cache;
 
   std::string pid_tag;
 
@@ -45,6 +50,8 @@ class ArgHandler {
   std::string log_scope;
 
   bool print_sha;
+  bool compile_params;
+  std::vector<std::string> convert_restart;
   bool help;
 
 
@@ -74,11 +81,17 @@ public:
 
   inline const std::string get_max_output_volume(){return max_output_volume;};
   inline const bool get_no_output_cleanup(){return no_output_cleanup;};
+  inline const bool get_resume() const {return resume;};
+  inline const bool get_write_daily_drivers() const {return write_daily_drivers;};
+  inline const std::string get_read_daily_drivers() const {return read_daily_drivers;};
+  inline const bool get_no_forcing_cache() const {return no_forcing_cache;};
 
   inline const std::string get_log_level(){return log_level;};
   inline const std::string get_log_scope(){return log_scope;};
 
   inline const bool get_help(){return help;};
   inline const bool get_print_sha(){return print_sha;};
+  inline const bool get_compile_params(){return compile_params;};
+  inline const std::vector<std::string> get_convert_restart(){return convert_restart;};
 };
 #endif /* _ARGHANDLER_H */
@@ -0,0 +1,80 @@
+#ifndef BATCHINTEGRATOR_H_
+#define BATCHINTEGRATOR_H_
+
+/* \file
+ * Integrates the vegetation BGC of several PFTs over a month in lockstep.
+ *
+ * Each PFT (a "lane") is still an independent system with its own
+ * Integrator, Vegetation_Bgc and BgcData, and its own adaptive step
+ * control: every lane keeps its own time, step size and rejection count,
+ * and takes exactly the steps Integrator::adapt() would take for it alone.
+ * What the lanes share is the stage loop of the RKF45 step, so that the
+ * Runge-Kutta arithmetic (the stage combinations, the error estimate and
+ * the state updates) runs over all the lanes at once.
+ *
+ * The state and stage arrays are stored equation-major, lane-minor:
+ * x[ieq][ilane]. The innermost loops run over lanes with a stride of one
+ * and no branches, so the compiler can vectorize them. The derivatives,
+ * pool checks and error bounds are still evaluated one lane at a time by
+ * the lane's own Integrator, so the results are the same as calling
+ * Integrator::updateMonthlyVbgc() for each PFT in turn.
+ */
+
+#include "Integrator.h"
+#include "temconst.h"
+
+class BatchIntegrator {
+public:
+  BatchIntegrator();
+  ~BatchIntegrator();
+
+  void updateMonthlyVbgc(Integrator * lanes[], const int &numlanes);
+
+private:
+
+  int nlanes;
+  Integrator * lane[NUM_PFT];
+
+  // Per lane adaptive step control, as the locals of Integrator::adapt()
+  float time[NUM_PFT];
+  float dt[NUM_PFT];
+  float ptdt[NUM_PFT];
+  int nintmon[NUM_PFT];
+  bool done[NUM_PFT];
+  // false once a lane's trial step has sent a pool negative
+  bool live[NUM_PFT];
+
+  float y[NUMEQ_VEG][NUM_PFT];
+  float oldstate[NUMEQ_VEG][NUM_PFT];
+
+  float dum4[NUMEQ_VEG][NUM_PFT];
+  float dum5[NUMEQ_VEG][NUM_PFT];
+  float ydum[NUMEQ_VEG][NUM_PFT];
+  float yprime[NUMEQ_VEG][NUM_PFT];
+  float rk45[NUMEQ_VEG][NUM_PFT];
+  float error[NUMEQ_VEG][NUM_PFT];
+
+  float f11[NUMEQ_VEG][NUM_PFT];
+  float f2[NUMEQ_VEG][NUM_PFT];
+  float f13[NUMEQ_VEG][NUM_PFT];
+  float f3[NUMEQ_VEG][NUM_PFT];
+  float f14[NUMEQ_VEG][NUM_PFT];
+  float f4[NUMEQ_VEG][NUM_PFT];
+  float f15[NUMEQ_VEG][NUM_PFT];
+  float f5[NUMEQ_VEG][NUM_PFT];
+  float f16[NUMEQ_VEG][NUM_PFT];
+  float f6[NUMEQ_VEG][NUM_PFT];
+
+  void adapt();
+  void rkf45();
+
+  void delta(float pstate[][NUM_PFT], float pdstate[][NUM_PFT]);
+  void checkPools();
+
+  void step(float pstate[][NUM_PFT], float pdstate[][NUM_PFT],
+            float ptstate[][NUM_PFT], const float pdt[]);
+  void step(float pstate[][NUM_PFT], float pdstate[][NUM_PFT],
+            float ptstate[][NUM_PFT], const float& pdt);
+
+};
+#endif /*BATCHINTEGRATOR_H_*/
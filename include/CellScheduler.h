@@ -0,0 +1,80 @@
+/*  CellScheduler.h
+ *
+ *  Hands out the cells of the run mask to the threads (and, under MPI, the
+ *  ranks) running the space-major loop.
+ *
+ *  The cost of a cell varies a lot (deep organic layers, many freezing
+ *  fronts, fire years), and with a fixed order the run ends with a long
+ *  tail where a few expensive cells keep a few threads busy while the rest
+ *  sit idle. So the cells are put in order of an estimated cost, most
+ *  expensive first, and every thread claims the next cell from that order
+ *  as soon as it is free.
+ *
+ *  The cost estimate comes from the total_runtime of a previous run, if a
+ *  copy of that run's run_status.nc is given, and otherwise from a rough
+ *  heuristic based on the drainage class. If climate is being read in
+ *  tiles of rows, the cells of a tile are kept together (tiles in order of
+ *  their most expensive cell) so that each tile is only read once.
+ *
+ *  Under MPI the position in the order is a single counter shared by all
+ *  the ranks, held by rank 0 and claimed from with one-sided atomic
+ *  operations, so a rank that gets cheap cells simply takes more of them.
+ *  This needs MPI_THREAD_MULTIPLE; without it the ranks take every
+ *  ntasks'th cell of the order instead.
+ */
+
+#ifndef CELLSCHEDULER_H_
+#define CELLSCHEDULER_H_
+
+#include <string>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
+
+#ifdef WITHMPI
+#include <mpi.h>
+#endif
+
+class ModelData;
+
+class CellScheduler {
+public:
+
+  CellScheduler(const std::vector< std::vector<int> >& run_mask, const ModelData& md);
+  ~CellScheduler();
+
+  bool next_cell(int& rowidx, int& colidx);
+  void cell_done(double seconds);
+
+  std::string utilization_report();
+
+private:
+
+  int num_cols;
+
+  // Cell indices (row * num_cols + col), most expensive first
+  std::vector<int> order;
+
+  boost::mutex claim_mutex;
+  int next_position;   // Local position in the order, if not shared
+  bool shared_counter; // Positions are claimed from the counter on rank 0
+
+  // For the utilization report
+  double start_time;
+  long cells_run;
+  double busy_seconds;
+
+#ifdef WITHMPI
+  int id;
+  int ntasks;
+  MPI_Win counter_win;
+  int* counter;
+#endif
+
+  void estimate_costs(const std::vector< std::vector<int> >& run_mask,
+                      const ModelData& md, std::vector<double>& cost);
+
+};
+
+#endif /* CELLSCHEDULER_H_ */
@@ -3,12 +3,21 @@
 
 #include <string>
 #include <vector>
+#include <utility>
+#include <map>
+#include <future>
+
+#include <boost/shared_ptr.hpp>
+
+class ClimateTileCache;
+class SolarGeometry;
 
 class Climate {
 public:
 
   Climate();
-  Climate(const std::string& fname, const std::string& co2fname, int y, int x);
+  Climate(const std::string& fname, const std::string& co2fname, int y, int x,
+          ClimateTileCache* tiles = NULL);
 
   // Misc. climate variables
   // The following two values determine the span of historic climate
@@ -21,6 +30,10 @@ public:
   int tseries_start_year;
   int tseries_end_year;
 
+  // Derive the PR/EQ daily forcing and each year of the SP cycle only
+  // once, and copy it after that. See prepare_daily_driving_data(..)
+  bool cache_daily_forcing;
+
   // driving variables
   std::vector<float> co2;
   std::vector<float> tair;
@@ -70,7 +83,7 @@ public:
   std::vector<float> dersvp_d;
   std::vector<float> abshd_d;
   
-  std::vector<float> monthly2daily(const std::vector<float>& mly_vals);
+  void monthly2daily(const float mly_vals[14], std::vector<float>& daily);
 
   void prepare_eq_daily_driving_data(int iy, const std::string& stage);
   void prepare_daily_driving_data(int, const std::string&);
@@ -78,14 +91,62 @@ public:
   void monthlycontainers2log();
   void dailycontainers2log();
 
-  void load_proj_climate(const std::string&, int, int);
+  void load_proj_climate(const std::string&, int, int, ClimateTileCache* tiles = NULL);
   void load_proj_co2(const std::string&);
 
+  // Starts reading the projected climate for a cell in the background, to
+  // be picked up by a later load_proj_climate(..) of the same file.
+  void prefetch_proj_climate(const std::string&, int, int, ClimateTileCache* tiles = NULL);
+
   void prep_avg_climate();
 
 private:
 
-  void load_from_file(const std::string& fname, int y, int x);
+  // The base timeseries of one cell, as read from a climate file
+  struct Series {
+    std::vector<float> tair;
+    std::vector<float> vapo;
+    std::vector<float> prec;
+    std::vector<float> nirr;
+    int start_year;
+    int end_year;
+    std::pair<float, float> latlon;
+  };
+
+  // One year of derived daily forcing, as kept by the cache
+  struct DailyForcing {
+    float co2_d;
+    std::vector<float> tair_d;
+    std::vector<float> prec_d;
+    std::vector<float> nirr_d;
+    std::vector<float> vapo_d;
+    std::vector<float> rain_d;
+    std::vector<float> snow_d;
+    std::vector<float> girr_d;
+    std::vector<float> cld_d;
+    std::vector<float> par_d;
+    std::vector<float> svp_d;
+    std::vector<float> vpd_d;
+  };
+
+  // -1 for PR/EQ, otherwise the year of the SP cycle
+  std::map<int, DailyForcing> daily_forcing_cache;
+
+  void derive_daily_driving_data(int iy, const std::string& stage);
+  void save_daily_forcing(DailyForcing& f) const;
+  void restore_daily_forcing(const DailyForcing& f);
+
+  static Series read_series(const std::string& fname, int y, int x, ClimateTileCache* tiles);
+  void set_series(const Series& s);
+
+  void load_from_file(const std::string& fname, int y, int x, ClimateTileCache* tiles);
+
+  // girr table for the latitude of the current series
+  boost::shared_ptr<const SolarGeometry> solar;
+
+  // projected climate being read ahead by prefetch_proj_climate(..)
+  std::string proj_prefetch_fname;
+  std::shared_future<Series> proj_prefetch;
 
   void split_precip();
 
@@ -94,8 +155,8 @@ private:
 
   std::vector<float> interpolate_daily(const std::vector<float> & var);
 
-  std::vector<float> eq_range(const std::vector<float>& data);
-  std::vector<float> interpolation_range(const std::vector<float>& data, int year);
+  void eq_range(const std::vector<float>& data, float range[14]);
+  void interpolation_range(const std::vector<float>& data, int year, float range[14]);
 
 };
 
@@ -0,0 +1,92 @@
+/*  ClimateTile.h
+ *
+ *  Climate input for a block of whole rows, read from the climate file
+ *  once and shared by every cell in the block.
+ *
+ *  Without tiles, every cell opens the climate file and reads its own
+ *  (time, 1, 1) column of each variable, holding the lock that guards the
+ *  NetCDF library. That serializes the start of every cell and
+ *  reads across the grain of the file's chunking. A tile instead reads
+ *  each variable for (all time, its rows, all columns) with one call, and
+ *  a cell then copies its columns out of memory without touching the
+ *  library at all.
+ *
+ *  Tiles are kept in a small least-recently-used cache shared by all the
+ *  threads, keyed by file and block of rows. The block size is rounded up
+ *  to a whole number of the file's chunks along Y.
+ */
+
+#ifndef CLIMATETILE_H_
+#define CLIMATETILE_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
+
+class ClimateTile {
+public:
+
+  ClimateTile(const std::string& fname, int first_row, int row_count);
+
+  int first_row;
+  int row_count;
+  int num_cols;
+  int time_len;
+
+  int tseries_start_year;
+  int tseries_end_year;
+
+  void column(const std::string& var, int y, int x, std::vector<float>& out) const;
+  std::pair<float, float> latlon(int y, int x) const;
+
+  size_t size_in_bytes() const;
+
+  static int chunk_rows(const std::string& fname, const std::string& var);
+
+private:
+
+  // Each variable is held as read, (time, row, col)
+  std::map<std::string, std::vector<float> > data;
+
+  // (row, col)
+  std::vector<float> lat;
+  std::vector<float> lon;
+
+};
+
+
+class ClimateTileCache {
+public:
+
+  ClimateTileCache(int tile_rows, int capacity);
+
+  boost::shared_ptr<const ClimateTile> get(const std::string& fname, int y);
+
+  int get_tile_rows() const { return tile_rows; }
+
+  std::string stats_report();
+
+private:
+
+  int tile_rows;
+  int capacity;
+
+  struct Entry {
+    boost::shared_ptr<const ClimateTile> tile;
+    long last_used;
+  };
+
+  boost::mutex cache_mutex;
+  std::map<std::pair<std::string, int>, Entry> tiles;
+
+  long lookups;
+  long loads;
+
+};
+
+#endif /* CLIMATETILE_H_ */
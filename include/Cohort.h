@@ -2,6 +2,7 @@
 #define COHORT_H_
 
 #include "Climate.h"
+#include "SolarGeometry.h"
 
 #include "Ground.h"
 #include "Vegetation.h"
@@ -27,6 +28,7 @@
 #include "CohortLookup.h"
 
 #include "Integrator.h"
+#include "BatchIntegrator.h"
 
 // headers for run
 #include "ModelData.h"
@@ -43,6 +45,9 @@ public :
   float lon;
   float lat;
 
+  // day length and girr for this latitude
+  boost::shared_ptr<const SolarGeometry> solar;
+
   // model running status
   int errorid;
   bool failed;    // when an exception is caught, set failed to be true
@@ -113,6 +118,8 @@ public :
 
   // Overwrites/fills climate containers with data from projected climate file
   void load_proj_climate(const std::string&);
+  // Starts reading the projected climate ahead of load_proj_climate(..)
+  void prefetch_proj_climate(const std::string&);
   // Overwrites/fills co2 container with data from projected co2 input file
   void load_proj_co2(const std::string& proj_co2_file);
   // Overwrites/fills explicit fire data containers with data from the projected fire input file.
@@ -121,6 +128,7 @@ private:
 
   Integrator vegintegrator[NUM_PFT];
   Integrator solintegrator;
+  BatchIntegrator vegbatch;
 
 
   void updateMonthly_DIMveg(const int & currmind, const bool & dynamic_lai_module);
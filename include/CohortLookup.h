@@ -7,8 +7,15 @@
 #include <sstream>
 #include <cmath>
 #include <cstdlib>
+#include <map>
+#include <set>
+#include <vector>
 using namespace std;
 
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
+
 #include "cohortconst.h"
 #include "timeconst.h"
 #include "layerconst.h"
@@ -27,6 +34,16 @@ public:
   void init();
   void assignBgcCalpar(string & dirname);
 
+  // Parameters as read from the files, shared by every cohort of a
+  // community type
+  static boost::shared_ptr<const CohortLookup> cached(const std::string& directory,
+                                                      const std::string& code);
+  static void clear_cache();
+
+  // Precompiled parameter file (see compile_parameters())
+  static const std::string COMPILED_FILE;
+  static int compile_parameters(const std::string& directory);
+
   //calibration related
   //vegetation
   double cmax[NUM_PFT];
@@ -271,6 +288,18 @@ private:
 
   void assignFirePar(string & dir);
 
+  // Every numeric parameter, as (address, size) pairs, in the order they
+  // are stored in the compiled file
+  void parameter_fields(std::vector<std::pair<char*, size_t> >& f);
+  static unsigned int layout_hash();
+
+  static bool load_compiled(const std::string& directory);
+
+  static boost::mutex cache_mutex;
+  static std::map<std::pair<std::string, std::string>,
+                  boost::shared_ptr<const CohortLookup> > cache;
+  static std::set<std::string> compiled_checked; // Directories
+
 };
 
 #endif /*COHORTLOOKUP_H_*/
@@ -6,6 +6,8 @@
 #include <iostream>
 using namespace std;
 
+#include "layerconst.h"
+
 class CrankNicholson {
 public:
 
@@ -31,6 +33,16 @@ public:
 
   void tridiagonal(const int ind, const int numsl, double a[], double b[],
                    double c[], double r[], double u[]);
+
+private:
+
+  // Scratch for the elimination. The diagonal and right hand side of each
+  // layer do not depend on the other layers, so they are filled in a first
+  // pass with no loop-carried dependence (which the compiler can vectorize),
+  // leaving only the recurrence through s/e or gamma/u in the second pass.
+  double diag[MAX_GRN_LAY+2];
+  double rhs[MAX_GRN_LAY+2];
+  double gamma[MAX_GRN_LAY+2];
 };
 
 #endif /*CRANKNICHOLSON_H_*/
@@ -0,0 +1,57 @@
+/*  DailyDrivers.h
+ *
+ *  Daily climate forcing, fully derived, stored in NetCDF.
+ *
+ *  Every cell derives its daily forcing from the monthly climate each
+ *  year of every run (interpolation, daily precipitation, the rain/snow
+ *  split, vapor pressure and clouds; see
+ *  Climate::prepare_daily_driving_data). Ensemble and calibration work
+ *  runs the same climate many times over, so a run can write the derived
+ *  forcing out (--write-daily-drivers), and later runs can read it back
+ *  instead of deriving it (--read-daily-drivers).
+ *
+ *  There is one file per stage, daily_drivers_<stage>.nc, with dimensions
+ *  (year, day, Y, X). PR and EQ drive every year with the same averaged
+ *  climate, so they share the one year in the "eq" file; SP cycles
+ *  through its first 30 years; TR and SC have every year. The variables
+ *  are chunked a cell-year at a time, so reading one year for a cell reads
+ *  one chunk per variable.
+ */
+
+#ifndef _DAILYDRIVERS_H_
+#define _DAILYDRIVERS_H_
+
+#include <string>
+
+class Climate;
+class ModelData;
+class OutputSink;
+
+namespace DailyDrivers {
+
+  // The file a stage's forcing is kept in: "eq" for PR and EQ, else the stage
+  std::string file_stage(const std::string& stage);
+  std::string filename(const std::string& dir, const std::string& stage);
+
+  // Years a run needs in a stage's file; 0 if the stage isn't run
+  int file_years(const ModelData& md, const std::string& file_stage);
+
+  // The year of the file that holds the forcing for a stage's climate year
+  int file_year(const std::string& file_stage, int climate_year);
+
+  void create_file(const std::string& fname, int nyears, int ysize, int xsize);
+
+  // Throws if a file is missing or holds fewer than 'nyears' years
+  void check_file(const std::string& fname, int nyears);
+
+  int var_count();
+  const char* var_name(int iv);
+
+  void write_year(OutputSink& sink, const std::string& fname, const Climate& climate,
+                  int year, int row, int col);
+  void read_year(OutputSink& sink, const std::string& fname, Climate& climate,
+                 int year, int row, int col);
+
+}
+
+#endif /* _DAILYDRIVERS_H_ */
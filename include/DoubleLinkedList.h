@@ -20,6 +20,9 @@ public:
   Layer* botlayer;
 
 protected:
+  // Where the layers of the list live; see LayerPool.h
+  LayerPool layerpool;
+
   void insertFront(Layer *l);
   void insertBack(Layer *l);
   void removeFront();
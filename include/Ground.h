@@ -21,6 +21,7 @@ using namespace std;
 #include "MineralLayer.h"
 #include "OrganicLayer.h"
 #include "ParentLayer.h"
+#include "ThermalProperties.h"
 
 #include "CohortLookup.h"
 
@@ -69,6 +70,10 @@ public :
   Layer* fstminel; // first mineral layer
   Layer* lstminel; // last mineral layer
 
+  // thermal conductivity and heat capacity of the layers, for Stefan and
+  //   TemperatureUpdator; forgotten whenever the layers are re-indexed
+  ThermalProperties thermal;
+
   // freezing/thawing fronts
   double frntz[MAX_NUM_FNT];
   int frnttype[MAX_NUM_FNT];
@@ -0,0 +1,81 @@
+/*  InputFiles.h
+ *
+ *  Per-cell reads from the read-only input files.
+ *
+ *  The temutil readers open the file, look up the variable, read one value
+ *  or one (time, 1, 1) column and (mostly) never close it, once for every
+ *  variable, and each caller wraps them in the critical section that guards
+ *  the NetCDF library. Opening a NetCDF4 file is far more expensive than
+ *  reading a cell from it, so setting up a cell spent most of its time
+ *  holding the lock to open files.
+ *
+ *  Here every input file is opened once for the whole process and the
+ *  handle kept until close_all(). The library is not thread safe, so the
+ *  calls into it are still serialized, but the lock is taken once for a
+ *  whole pass over a file and held only for the library calls: a cell
+ *  queues everything it needs from a file on an InputPass and read() gets
+ *  it all at once. Logging and checking are done outside the lock.
+ *
+ *  The lock is the process-wide NetCDF lock (temutil::NetCDFLock), so
+ *  these reads are exclusive with every other call into the library, from
+ *  any thread.
+ */
+
+#ifndef INPUTFILES_H_
+#define INPUTFILES_H_
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <functional>
+
+#include <stdint.h>
+
+class InputPass {
+public:
+
+  InputPass(const std::string& fname, int y, int x);
+
+  // The value of a (Y, X) variable at the cell
+  InputPass& scalar(const std::string& var, int& out);
+  InputPass& scalar(const std::string& var, float& out);
+  InputPass& scalar(const std::string& var, double& out);
+
+  // The whole (time, Y, X) column of a variable at the cell
+  InputPass& series(const std::string& var, std::vector<int>& out);
+  InputPass& series(const std::string& var, std::vector<int64_t>& out);
+  InputPass& series(const std::string& var, std::vector<float>& out);
+
+  // Calendar years covered by the file's time axis
+  InputPass& time_span(int& start_year, int& end_year);
+
+  InputPass& latlon(std::pair<float, float>& out);
+
+  // Reads everything queued above in one pass over the file
+  void read();
+
+private:
+
+  std::string fname;
+  int y;
+  int x;
+
+  // Each queued read, run against the file's handle with the lock held
+  std::vector<std::function<void(int)> > reads;
+
+  template <typename DTYPE>
+  InputPass& queue_scalar(const std::string& var, DTYPE& out);
+
+  template <typename DTYPE>
+  InputPass& queue_series(const std::string& var, std::vector<DTYPE>& out);
+
+};
+
+namespace InputFiles {
+
+  // Closes every input file opened for an InputPass
+  void close_all();
+
+}
+
+#endif /* INPUTFILES_H_ */
@@ -31,6 +31,10 @@ using namespace std;
 #include "temconst.h"
 
 class Integrator {
+  // Runs the vegetation integration of several PFTs in lockstep through
+  // their Integrators' delta(), checkPools() and boundcon()
+  friend class BatchIntegrator;
+
 public :
   Integrator();
   ~Integrator();
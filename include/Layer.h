@@ -14,6 +14,7 @@ using namespace std;
 #include "errorcode.h"
 #include "physicalconst.h"
 #include "layerconst.h"
+#include "LayerPool.h"
 
 class Layer {
 private:
@@ -21,6 +22,12 @@ private:
 public:
   Layer();
   virtual ~Layer();
+
+  // Layers are allocated from their column's LayerPool: new (pool) SnowLayer()
+  static void* operator new(size_t size, LayerPool& pool);
+  static void* operator new(size_t size);
+  static void operator delete(void* p, LayerPool& pool);
+  static void operator delete(void* p);
   enum TYPEKEY {I_SNOW, I_MOSS, I_FIB, I_HUM, I_MINE, I_ROCK, I_UNKNOWN};
 
   Layer* nextl;   // point to next layer
@@ -0,0 +1,65 @@
+/*! \file
+ * Storage for the layers of one ground column.
+ *
+ * The layers of a column are walked top to bottom through nextl/prevl by
+ * every daily process (fronts, temperatures, soil water, reporting). When
+ * each layer is a separate heap allocation those walks hop around memory;
+ * with a pool the layers of a column sit in one fixed block of
+ * CAPACITY equally sized slots, so a walk stays within a few pages. The
+ * block and every slot start on a cache line.
+ *
+ * Layers are still created with new and removed with delete: Layer's
+ * class operator new takes the pool as a placement argument, and its
+ * operator delete finds the owning pool from a small header in front of
+ * each layer. A column that needs more layers than the pool holds (only
+ * transiently, while layers are split or combined) gets the extras from
+ * the heap, as does a layer created without a pool.
+ *
+ * This is only an allocator. The column is still a linked list of Layer
+ * objects with virtual property methods, and the split/combine code in
+ * Ground still relinks and copies whole layers. It is not a flat, index
+ * based column with per-property arrays and type tags: every process
+ * (Stefan, TemperatureUpdator, Richards, Soil_Env, Ground, restart I/O)
+ * is written against Layer pointers, and moving them all over is a
+ * separate piece of work. ThermalProperties takes the virtual calls out
+ * of the temperature and fronts loops in the meantime.
+ */
+#ifndef LAYERPOOL_H_
+#define LAYERPOOL_H_
+
+#include <cstddef>
+
+#include "layerconst.h"
+
+class LayerPool {
+public:
+  LayerPool();
+  ~LayerPool();
+
+  // Copying a column copies its layer pointers, never its layers, so a
+  // column is only ever copied before it has any (Cohort and Runner
+  // assign freshly built ones). A copied pool is a new, empty one, and
+  // assigning over a pool that still holds layers throws.
+  LayerPool(const LayerPool& other);
+  LayerPool& operator=(const LayerPool& other);
+
+  // Snow, soil and rock layers, plus room to split a layer before the
+  // old one is removed
+  static const int CAPACITY = MAX_GRN_LAY + 4;
+
+  static void* allocate(size_t size, LayerPool* pool);
+  static void release(void* p);
+
+  int slots_in_use() const { return CAPACITY - nfree; }
+
+private:
+
+  char* block;
+  int free_slots[CAPACITY]; // stack of free slot indices
+  int nfree;
+
+  static size_t slot_bytes();
+  void reset();
+};
+
+#endif /*LAYERPOOL_H_*/
@@ -20,6 +20,11 @@
 
 using namespace std;
 
+class OutputWriter;
+class OutputSink;
+class ClimateTileCache;
+class RestartCheckpointCache;
+
 class ModelData {
 public:
 
@@ -28,15 +33,27 @@ public:
   ModelData();
   ~ModelData();
 
+  bool persist_restart(const std::string& stage) const;
   void update(ArgHandler const * arghandler);
   std::string describe_module_settings();
 
   void create_netCDF_output_files(int ysize, int xsize, const std::string & stage, int stage_year_count, bool copy_grid_mapping);
+  void read_output_spec();
 
   string loop_order; // time-major or space-major
 
   int force_cmt; // used to override the veg map (calibration mode only)
 
+  bool resume; // Continue an interrupted run (--resume)
+
+  // Daily climate forcing files: written by this run (--write-daily-drivers)
+  //   or read instead of deriving the forcing (--read-daily-drivers)
+  bool write_daily_drivers;
+  std::string daily_drivers_dir;
+
+  // Reuse the PR/EQ and SP daily forcing (unless --no-forcing-cache)
+  bool cache_daily_forcing;
+
   int eq_yrs;
   int pr_yrs;
   int sp_yrs;
@@ -81,6 +98,9 @@ public:
   string runmask_file;
   string output_dir;
   string restart_from;      // Restart from a previous run
+  string restart_handoff;   // "memory", "file" or "verify"; see config.js
+  string restart_stages;    // Stages whose restart files are written
+  string restart_format;    // "netcdf" or "binary" (memory mapped checkpoints)
   string output_spec_file;
   bool output_monthly;
   bool nc_eq; // NetCDF output flags for each stage
@@ -88,6 +108,17 @@ public:
   bool nc_tr;
   bool nc_sc;
   int output_interval; //How many years to store for output
+  bool async_output; // Hand NetCDF writes off to a dedicated writer stage
+  int output_queue_size; // Max number of blocks waiting in the writer queue
+  int output_io_threads; // Number of threads draining the writer queue
+  bool collective_output; // MPI only: gather rows of cells, write collectively
+  int collective_block_rows; // Rows of cells in each collectively written block
+  int time_major_tile_rows; // Rows of cells held in memory by the time-major loop
+  std::string cell_cost_file; // Previous run_status.nc, to order cells by runtime
+  int climate_tile_rows; // Rows of climate read at once; 0 reads per cell
+  int climate_tile_cache; // Climate tiles held in memory at once
+  int checkpoint_interval; // Years between mid-stage checkpoints of a cell; 0 for none
+  bool solver_stats; // Write solver step counts to solver_stats.nc
   //The following two config values are temporarily stored in
   // ModelData, to be transferred to Climate.
   int baseline_start;//Start year for baseline EQ climate
@@ -100,6 +131,18 @@ public:
   std::map<std::string, OutputSpec> monthly_netcdf_outputs;
   std::map<std::string, OutputSpec> yearly_netcdf_outputs;
 
+  // Shared by all copies of this ModelData and set up in main(). The sink
+  // holds the open output files; the writer is null unless async_output
+  // is set.
+  OutputSink* output_sink;
+  OutputWriter* output_writer;
+
+  // Shared climate tiles, null unless climate_tile_rows is set
+  ClimateTileCache* climate_tiles;
+
+  // Open binary restart checkpoints, null unless restart_format is "binary"
+  RestartCheckpointCache* restart_checkpoints;
+
   std::string pid_tag;
   std::string caldata_tree_loc;
   int last_n_json_files;
@@ -173,6 +216,10 @@ private:
   //       change. With dsl module OFF, the C and N content will change, but
   //       the thickness and number of layers should not change.
 
+  void load_output_spec(int ysize, int xsize, const std::string & stage,
+                        int stage_year_count, bool copy_grid_mapping,
+                        bool create_files);
+
 };
 
 #endif /*MODELDATA_H_*/
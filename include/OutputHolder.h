@@ -1,182 +1,81 @@
-
 /* When running a region with many concurrent batches, outputting at every
  * year timestep creates a bottleneck in the run. Output at the monthly
  * timestep is correspondingly worse.
  *
  * This class is a basic repository for output data to be held until
  * outputting is triggered based on the user's specifications.
+ *
+ * There is one column of held data for each output variable enabled in
+ * output_spec.csv. A column knows which variable it holds (from the
+ * OutputRegistry) and how many values make up one timestep, and holds
+ * the values for all the timesteps since the last write back to back,
+ * in the order they will be written to the file.
+ *
+ * All the columns live in a single arena that is sized once, in setup(),
+ * from the output interval: enough timesteps for one write of every
+ * enabled variable. Nothing is allocated while the model runs. When the
+ * holder is destroyed the arena is handed back to a per-thread pool so
+ * that the next cell run on the same thread can reuse the memory. The
+ * pool is capped at the number of holders the thread has had alive at
+ * once; arenas beyond that, or destroyed on another thread, are freed.
  * */
 
 
 #ifndef OUTPUTHOLDER_H
 #define OUTPUTHOLDER_H
 
-#include "temconst.h"
-#include "layerconst.h"
+#include <vector>
+#include <iostream>
+
+#include "util_structs.h"
+#include "OutputRegistry.h"
+
+class ModelData;
+struct ArenaPool;
+
+struct OutputColumn {
+  const OutputVarDef* def; // NULL if the variable has been disabled
+  OutputSpec spec;
+  int values_per_timestep;
+  int timestep_capacity; // Timesteps held between writes
+  int timesteps_held;
+  size_t offset;         // Start of the column in the arena
+};
 
 class OutputHolder{
 public:
 
-//  OutputHolder();
-//  ~OutputHolder();
+  OutputHolder();
+  ~OutputHolder();
 
+  // The arena belongs to one holder, so holders are not copied
+  OutputHolder(const OutputHolder&) = delete;
+  OutputHolder& operator=(const OutputHolder&) = delete;
+
+  std::vector<OutputColumn> yearly;
+  std::vector<OutputColumn> monthly;
+  std::vector<OutputColumn> daily;
+
+  void setup(const ModelData& md);
   void clear();
 
-  int months_held;
-  int years_held;
-
-  std::vector<int> cmtnum_for_output;
-  std::vector<int> ysd_for_output;
-
-  std::vector<double> ald_for_output;
-  std::vector<double> burnsoil2airc_for_output;
-  std::vector<double> burnthick_for_output;
-  std::vector<double> burnveg2airc_for_output;
-  std::vector<double> burnveg2deadc_for_output;
-  std::vector<double> burnveg2soilabvc_for_output;
-  std::vector<double> burnveg2soilblwc_for_output;
-  std::vector<double> deadc_for_output;
-  std::vector<double> deepc_for_output;
-  std::vector<double> deepdz_for_output;
-  std::vector<float> driving_rainfall_for_output;
-  std::vector<float> driving_snowfall_for_output;
-  std::vector<double> dwdc_for_output;
-  std::vector<double> minec_for_output;
-  std::vector<double> lfnvc_for_output; //non-vascular litterfall C
-  std::vector<double> lfnvn_for_output; //non-vascular litterfall N
-  std::vector<double> mossdz_for_output;
-  std::vector<double> nlost_for_output;
-  std::vector<double> qdrain_for_output;
-  std::vector<double> qinfil_for_output;
-  std::vector<double> qrunoff_for_output;
-  std::vector<double> rainfall_for_output;
-  std::vector<double> reco_for_output;
-  std::vector<double> rhdwd_for_output;
-  std::vector<double> socfrozen_for_output;
-  std::vector<double> socunfrozen_for_output;
-  std::vector<double> shlwc_for_output;
-  std::vector<double> shlwdz_for_output;
-  std::vector<double> snowfall_for_output;
-  std::vector<double> snowthick_for_output;
-  std::vector<double> swe_for_output;
-  std::vector<double> vegntot_for_output;
-  std::vector<double> watertab_for_output;
-
-  //Variables by layer
-  std::vector<double> netnmin_tot_for_output;
-  std::vector<std::array<double, MAX_SOI_LAY>> netnmin_for_output;
-
-  std::vector<double> rh_tot_for_output;
-  std::vector<std::array<double, MAX_SOI_LAY>> rh_for_output;
-
-  std::vector<double> soma_tot_for_output;
-  std::vector<std::array<double, MAX_SOI_LAY>> soma_for_output;
-
-  std::vector<double> somcr_tot_for_output;
-  std::vector<std::array<double, MAX_SOI_LAY>> somcr_for_output;
-
-  std::vector<double> sompr_tot_for_output;
-  std::vector<std::array<double, MAX_SOI_LAY>> sompr_for_output;
-
-  std::vector<double> somrawc_tot_for_output;
-  std::vector<std::array<double, MAX_SOI_LAY>> somrawc_for_output;
-
-  std::vector<double> soc_tot_for_output;
-  std::vector<double> soc_0_30_for_output;
-  std::vector<double> soc_0_100_for_output;
-  std::vector<double> soc_0_200_for_output;
-  std::vector<double> soc_0_300_for_output;
-  std::vector<std::array<double, MAX_SOI_LAY>> soc_for_output;
-
-  std::vector<double> avln_tot_for_output;
-  std::vector<std::array<double, MAX_SOI_LAY>> avln_for_output;
-
-  std::vector<std::array<double, MAX_SOI_LAY>> layerdepth_for_output;
-  std::vector<std::array<double, MAX_SOI_LAY>> layerdz_for_output;
-  std::vector<std::array<int, MAX_SOI_LAY>> layertype_for_output;
-  std::vector<std::array<double, MAX_SOI_LAY>> lwclayer_for_output;
-
-  std::vector<double> orgn_tot_for_output;
-  std::vector<std::array<double, MAX_SOI_LAY>> orgn_for_output;
-
-  std::vector<double> tsoil_30_for_output;
-  std::vector<double> tsoil_100_for_output;
-  std::vector<double> tsoil_200_for_output;
-  std::vector<double> tsoil_300_for_output;
-  std::vector<std::array<double, MAX_SOI_LAY>> tlayer_for_output;
-
-  std::vector<double> vwc_30_for_output;
-  std::vector<double> vwc_100_for_output;
-  std::vector<double> vwc_200_for_output;
-  std::vector<double> vwc_300_for_output;
-  std::vector<std::array<double, MAX_SOI_LAY>> vwclayer_for_output;
-
-  std::vector<std::array<double, MAX_SNW_LAY>> snowlayerdz_for_output;
-  std::vector<std::array<double, MAX_SNW_LAY>> snowlayertemp_for_output;
-
-  //Variables by PFT
-  std::vector<double> eet_tot_for_output;
-  std::vector<std::array<double, NUM_PFT>> eet_for_output;
-
-  std::vector<double> lai_tot_for_output;
-  std::vector<std::array<double, NUM_PFT>> lai_for_output;
-
-  std::vector<double> pet_tot_for_output;
-  std::vector<std::array<double, NUM_PFT>> pet_for_output;
-
-  std::vector<double> trans_tot_for_output;
-  std::vector<std::array<double, NUM_PFT>> trans_for_output;
-
-  //Variables by PFT and Compartment both
-  std::vector<double> gpp_tot_for_output;
-  std::vector<std::array<double, NUM_PFT_PART>> gpp_part_for_output;
-  std::vector<std::array<double, NUM_PFT>> gpp_pft_for_output;
-  std::vector<std::array<std::array<double, NUM_PFT>, NUM_PFT_PART>> gpp_for_output; 
-
-  std::vector<double> lfvc_tot_for_output;
-  std::vector<std::array<double, NUM_PFT_PART>> lfvc_part_for_output;
-  std::vector<std::array<double, NUM_PFT>> lfvc_pft_for_output;
-  std::vector<std::array<std::array<double, NUM_PFT>, NUM_PFT_PART>> lfvc_for_output; 
-
-  std::vector<double> ingpp_tot_for_output;
-  std::vector<std::array<double, NUM_PFT_PART>> ingpp_part_for_output;
-  std::vector<std::array<double, NUM_PFT>> ingpp_pft_for_output;
-  std::vector<std::array<std::array<double, NUM_PFT>, NUM_PFT_PART>> ingpp_for_output; 
-
-  std::vector<double> innpp_tot_for_output;
-  std::vector<std::array<double, NUM_PFT_PART>> innpp_part_for_output;
-  std::vector<std::array<double, NUM_PFT>> innpp_pft_for_output;
-  std::vector<std::array<std::array<double, NUM_PFT>, NUM_PFT_PART>> innpp_for_output; 
-
-  std::vector<double> npp_tot_for_output;
-  std::vector<std::array<double, NUM_PFT_PART>> npp_part_for_output;
-  std::vector<std::array<double, NUM_PFT>> npp_pft_for_output;
-  std::vector<std::array<std::array<double, NUM_PFT>, NUM_PFT_PART>> npp_for_output; 
-
-  std::vector<double> nuptakest_tot_for_output;
-  std::vector<std::array<double, NUM_PFT_PART>> nuptakest_part_for_output;
-  std::vector<std::array<double, NUM_PFT>> nuptakest_pft_for_output;
-  std::vector<std::array<std::array<double, NUM_PFT>, NUM_PFT_PART>> nuptakest_for_output;
-
-  std::vector<double> nuptakelab_tot_for_output;
-  std::vector<std::array<double, NUM_PFT>> nuptakelab_pft_for_output;
-
-  std::vector<double> rg_tot_for_output;
-  std::vector<std::array<double, NUM_PFT_PART>> rg_part_for_output;
-  std::vector<std::array<double, NUM_PFT>> rg_pft_for_output;
-  std::vector<std::array<std::array<double, NUM_PFT>, NUM_PFT_PART>> rg_for_output; 
+  double* data(const OutputColumn& column);
+  const void* typed_data(const OutputColumn& column);
 
-  std::vector<double> vegc_tot_for_output;
-  std::vector<std::array<double, NUM_PFT_PART>> vegc_part_for_output;
-  std::vector<std::array<double, NUM_PFT>> vegc_pft_for_output;
-  std::vector<std::array<std::array<double, NUM_PFT>, NUM_PFT_PART>> vegc_for_output; 
-
-  std::vector<double> rm_tot_for_output;
-  std::vector<std::array<double, NUM_PFT_PART>> rm_part_for_output;
-  std::vector<std::array<double, NUM_PFT>> rm_pft_for_output;
-  std::vector<std::array<std::array<double, NUM_PFT>, NUM_PFT_PART>> rm_for_output; 
+  // For cell checkpoints: the held data, not the column setup
+  void save(std::ostream& out) const;
+  void load(std::istream& in);
 
-};
+private:
+
+  std::vector<double> arena;
 
+  // Pool of the thread that set the holder up, NULL before setup()
+  ArenaPool* pool;
+
+  // Scratch space for converting a column to its NetCDF type
+  std::vector<char> convert_buffer;
+
+};
 
 #endif /* OUTPUTHOLDER_H */
@@ -0,0 +1,45 @@
+/*  OutputRegistry.h
+ *
+ *  Table of the NetCDF output variables the model knows how to produce.
+ *
+ *  Each variable is declared once, by name, along with the length of its
+ *  layer dimension (if it can be output by layer) and a fill function that
+ *  copies the values for the current timestep out of a Cohort. Which
+ *  timestep (daily, monthly, yearly) and which extra dimensions (PFT,
+ *  compartment, layer) are wanted is taken from the OutputSpec that was
+ *  read from output_spec.csv.
+ *
+ *  Values are always handed back as doubles; they are converted to the
+ *  variable's NetCDF type when they are written.
+ */
+
+#ifndef OUTPUTREGISTRY_H_
+#define OUTPUTREGISTRY_H_
+
+#include <string>
+
+#include "util_structs.h"
+
+class Cohort;
+
+/** Copies the values for one call into 'out' and returns true, or returns
+ *  false if the variable is not available for the requested combination of
+ *  timestep and dimensions. Daily variables fill every day of 'month',
+ *  day-major. The fastest varying index is the last NetCDF dimension, so
+ *  PFT and compartment data is laid out [compartment][pft].
+ */
+typedef bool (*OutputFillFunc)(Cohort& cohort, const OutputSpec& spec,
+                               int month, double* out);
+
+struct OutputVarDef {
+  const char* name;
+  int layer_count; // Length of the layer dimension, if any
+  OutputFillFunc fill;
+};
+
+const OutputVarDef* find_output_var(const std::string& name);
+
+int output_values_per_timestep(const OutputVarDef& def, const OutputSpec& spec);
+int output_timesteps_per_fill(const OutputSpec& spec, int month);
+
+#endif /* OUTPUTREGISTRY_H_ */
@@ -0,0 +1,101 @@
+/*  OutputSink.h
+ *
+ *  Registry of open NetCDF output files.
+ *
+ *  Opening an HDF5 backed NetCDF file is expensive, especially on parallel
+ *  file systems, so rather than opening and closing the target file (and
+ *  looking up the variable id) for every write, the OutputSink opens each
+ *  file the first time it is written to and caches the ncid along with the
+ *  varids of the variables written so far. Files stay open until the stage
+ *  they belong to is closed, or until the end of the run.
+ *
+ *  The library is not thread safe, so every call the sink makes into it
+ *  holds temutil's process-wide NetCDF lock, the same lock the input
+ *  readers take. Files that are read as well as written during the run
+ *  (the restart files) are read through the sink too, with the same
+ *  handle; a file that is only read is opened read-only.
+ *
+ *  Writes can also be gathered a block of whole rows at a time: writes
+ *  for the cells in the block are held in memory and then written with a
+ *  single call per variable. MPI builds have a collective flavour of this,
+ *  where every rank opens the output files once, on MPI_COMM_WORLD, and
+ *  the ranks write their blocks together.
+ */
+
+#ifndef OUTPUTSINK_H_
+#define OUTPUTSINK_H_
+
+#include <string>
+#include <vector>
+#include <map>
+
+class OutputSink {
+public:
+
+  OutputSink();
+  ~OutputSink();
+
+  void put(const std::string& filename, const std::string& var_name,
+           const size_t* start, const size_t* count, const void* data);
+
+  void put_int(const std::string& filename, const std::string& var_name,
+               const size_t* start, int value);
+
+  void get(const std::string& filename, const std::string& var_name,
+           const size_t* start, const size_t* count, void* data);
+
+  void close_stage(const std::string& stage_suffix);
+  void close_all();
+  void sync_all();
+
+  int open_file_count();
+
+  void open_gathered(const std::map<std::string, std::vector<std::string> >& file_vars);
+#ifdef WITHMPI
+  void open_collective(const std::map<std::string, std::vector<std::string> >& file_vars);
+#endif
+  void begin_block(int first_row, int row_count);
+  void write_block();
+
+private:
+
+  // A variable whose writes are gathered. The data for the current block
+  // of rows is held here, in the variable's type, until it is written.
+  struct HeldVar {
+    int varid;
+    std::vector<size_t> dimlens;
+    size_t value_size;
+    std::vector<char> fill_value;
+    std::vector<char> data;
+  };
+
+  struct OpenFile {
+    int ncid;
+    bool writable; // False if only opened to be read
+    std::map<std::string, int> varids;
+    std::map<std::string, HeldVar> held_vars; // Gathered variables only
+  };
+
+  std::map<std::string, OpenFile> files;
+
+  long file_opens;
+
+  bool collective; // Gathered writes are MPI collective
+
+  // Rows of the block being gathered
+  int block_first_row;
+  int block_row_count;
+
+  OpenFile& get_file(const std::string& filename);
+  OpenFile& get_file_for_read(const std::string& filename);
+  int get_varid(OpenFile& file, const std::string& var_name);
+
+  void add_held_var(OpenFile& file, const std::string& filename, const std::string& var_name);
+  HeldVar* find_held_var(OpenFile& file, const std::string& var_name);
+  void hold(HeldVar& held, const std::string& var_name,
+            const size_t* start, const size_t* count, const void* data);
+  void reset_held_var(HeldVar& held);
+
+};
+
+#endif /* OUTPUTSINK_H_ */
@@ -0,0 +1,92 @@
+/*  OutputWriter.h
+ *
+ *  A dedicated writer stage for NetCDF output.
+ *
+ *  When a Runner flushes held output data, instead of opening the output
+ *  file and writing from the compute thread, the data is copied into an
+ *  OutputBlock and pushed onto a bounded lock-free queue. One or more I/O
+ *  threads drain the queue and write the blocks through an OutputSink,
+ *  which keeps the output files open between writes. Compute threads only
+ *  block if the queue is full.
+ *
+ *  The NetCDF library is not thread safe, so the writes hold the same
+ *  process-wide NetCDF lock (taken by the sink) as the compute threads'
+ *  input reads. If more than one I/O thread is requested the library calls
+ *  are still serialized; extra threads only help to overlap queue handling
+ *  with the writes.
+ */
+
+#ifndef OUTPUTWRITER_H_
+#define OUTPUTWRITER_H_
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <atomic>
+
+#include <boost/thread.hpp>
+#include <boost/lockfree/queue.hpp>
+
+#include "OutputSink.h"
+
+/** One hyperslab worth of data bound for a single variable in a single
+ *  output file. The data is an owned, untyped copy whose element type
+ *  matches the NetCDF type of the target variable.
+ */
+struct OutputBlock {
+  std::string filename;
+  std::string var_name;
+  int ndims;
+  size_t start[5];
+  size_t count[5];
+  std::vector<char> data;
+};
+
+class OutputWriter {
+public:
+
+  OutputWriter(OutputSink* sink, int queue_capacity, int io_thread_count);
+  ~OutputWriter();
+
+  void enqueue(OutputBlock* block);
+  void finish();
+
+  // (row, col) of the cells with output that could not be written, each
+  // handed out once
+  std::vector<std::pair<int, int> > take_failed_cells();
+
+  std::string stats_report();
+
+private:
+
+  OutputSink* sink;
+  int io_thread_count;
+
+  boost::lockfree::queue<OutputBlock*, boost::lockfree::fixed_sized<true> > queue;
+  boost::thread_group io_threads;
+
+  std::atomic<bool> done;
+
+  // Idle I/O threads wait on this until a block is queued or finish() is
+  // called
+  boost::mutex idle_mutex;
+  boost::condition_variable idle_cond;
+
+  // Counters for monitoring the writer stage
+  std::atomic<long> blocks_written;
+  std::atomic<long> bytes_written;
+  std::atomic<long> write_failures;
+  std::atomic<int> queue_depth;
+  std::atomic<int> max_queue_depth;
+  std::atomic<long> stall_count;
+  std::atomic<long> stall_microseconds;
+
+  std::vector<std::pair<int, int> > failed_cells;
+  boost::mutex failed_cells_mutex;
+
+  void drain();
+  void write_block(OutputBlock* block);
+
+};
+
+#endif /* OUTPUTWRITER_H_ */
@@ -0,0 +1,114 @@
+/*  RestartCheckpoint.h
+ *
+ *  A binary restart file: one fixed size record per (row, col) of the run
+ *  mask, each holding the bytes of a RestartData, mapped into memory for
+ *  both reading and writing.
+ *
+ *  Reading a cell's state from a NetCDF restart file costs nine variable
+ *  reads, each through the library and its lock. With a checkpoint the
+ *  state for a cell is a memcpy out of the mapping, so restarting a large
+ *  grid is a page-fault-driven bulk load, and cells can read and write
+ *  their own records from any thread without taking a lock.
+ *
+ *  The file starts with a header, padded to HEADER_BYTES, that records the
+ *  layout version, sizeof(RestartData) and the array dimensions it was
+ *  built with. A file written by a build with a different RestartData is
+ *  refused rather than misread. Records are padded to whole pages so that
+ *  processes on different nodes never write into the same page.
+ *
+ *  A record carries a flag that is set when it is written; an unwritten
+ *  record reads back as RestartData::reinitValue(), the same values a
+ *  cell missing from a NetCDF restart file would get.
+ *
+ *  The converters translate to and from the NetCDF restart-*.nc files.
+ */
+
+#ifndef RESTARTCHECKPOINT_H_
+#define RESTARTCHECKPOINT_H_
+
+#include <string>
+#include <map>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "RestartData.h"
+
+class RestartCheckpoint {
+public:
+
+  static const unsigned int VERSION = 1;
+  static const size_t HEADER_BYTES = 4096;
+  static const std::string EXTENSION;
+
+  RestartCheckpoint(const std::string& fname, bool writable);
+
+  int get_rows() const { return rows; }
+  int get_cols() const { return cols; }
+  bool is_writable() const { return writable; }
+
+  bool has_record(int row, int col) const;
+  void read(RestartData& rd, int row, int col) const;
+  void write(const RestartData& rd, int row, int col);
+  void flush();
+
+  static bool is_checkpoint(const std::string& fname);
+  static void create(const std::string& fname, int rows, int cols);
+
+  static void netcdf_to_checkpoint(const std::string& nc_fname, const std::string& bin_fname);
+  static void checkpoint_to_netcdf(const std::string& bin_fname, const std::string& nc_fname);
+
+private:
+
+  struct Header {
+    char magic[8];
+    unsigned int version;
+    unsigned int restartdata_bytes;
+    unsigned int record_bytes;
+    int rows;
+    int cols;
+    int num_pft;
+    int num_pft_part;
+    int max_snw_lay;
+    int max_soi_lay;
+    int max_rot_lay;
+    int max_roc_lay;
+    int max_num_fnt;
+  };
+
+  static Header expected_header(int rows, int cols);
+  static size_t record_bytes();
+
+  char* record(int row, int col) const;
+
+  std::string fname;
+  bool writable;
+  int rows;
+  int cols;
+
+  boost::interprocess::file_mapping mapping;
+  boost::interprocess::mapped_region region;
+
+};
+
+
+/** The checkpoints a run has open, mapped the first time they are used
+ *  and shared by every thread. */
+class RestartCheckpointCache {
+public:
+
+  boost::shared_ptr<RestartCheckpoint> get(const std::string& fname, bool writable);
+
+  void flush_all();
+
+private:
+
+  boost::mutex cache_mutex;
+  std::map<std::string, boost::shared_ptr<RestartCheckpoint> > checkpoints;
+
+};
+
+#endif /* RESTARTCHECKPOINT_H_ */
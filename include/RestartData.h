@@ -11,6 +11,8 @@
 #include "cohortconst.h"
 #include "layerconst.h"
 
+class OutputSink;
+
 class RestartData {
 public :
   RestartData();
@@ -21,32 +23,32 @@ public :
   #endif
 
   void reinitValue();
-  void write_pixel_to_ncfile(const std::string& fname, const int rowidx, const int colidx);
-  void update_from_ncfile(const std::string& fname, const int rowidx, const int colidx);
+  void write_pixel_to_ncfile(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx);
+  void update_from_ncfile(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx);
   //The following two functions should probably be replaced with
   //something that does not require manually adding new members.
   void verify_logical_values();
   void restartdata_to_log();
 
-  void read_px_vars(const std::string& fname, const int rowidx, const int colidx);
-  void read_px_pft_vars(const std::string& fname, const int rowidx, const int colidx);
-  void read_px_pftpart_pft_vars(const std::string& fname, const int rowidx, const int colidx);
-  void read_px_snow_vars(const std::string& fname, const int rowidx, const int colidx);
-  void read_px_root_pft_vars(const std::string& fname, const int rowidx, const int colidx);
-  void read_px_soil_vars(const std::string& fname, const int rowidx, const int colidx);
-  void read_px_rock_vars(const std::string& fname, const int rowidx, const int colidx);
-  void read_px_front_vars(const std::string& fname, const int rowidx, const int colidx);
-  void read_px_prev_pft_vars(const std::string& fname, const int rowidx, const int colidx);
-
-  void write_px_vars(const std::string& fname, const int rowidx, const int colidx);
-  void write_px_pft_vars(const std::string& fname, const int rowidx, const int colidx);
-  void write_px_pftpart_pft_vars(const std::string& fname, const int rowidx, const int colidx);
-  void write_px_snow_vars(const std::string& fname, const int rowidx, const int colidx);
-  void write_px_root_pft_vars(const std::string& fname, const int rowidx, const int colidx);
-  void write_px_soil_vars(const std::string& fname, const int rowidx, const int colidx);
-  void write_px_rock_vars(const std::string& fname, const int rowidx, const int colidx);
-  void write_px_front_vars(const std::string& fname, const int rowidx, const int colidx);
-  void write_px_prev_pft_vars(const std::string& fname, const int rowidx, const int colidx);
+  void read_px_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx);
+  void read_px_pft_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx);
+  void read_px_pftpart_pft_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx);
+  void read_px_snow_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx);
+  void read_px_root_pft_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx);
+  void read_px_soil_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx);
+  void read_px_rock_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx);
+  void read_px_front_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx);
+  void read_px_prev_pft_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx);
+
+  void write_px_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx);
+  void write_px_pft_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx);
+  void write_px_pftpart_pft_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx);
+  void write_px_snow_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx);
+  void write_px_root_pft_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx);
+  void write_px_soil_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx);
+  void write_px_rock_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx);
+  void write_px_front_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx);
+  void write_px_prev_pft_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx);
 
   static void create_empty_file(const std::string& fname, const int ysize, const int xsize);
 
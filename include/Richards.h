@@ -7,6 +7,7 @@
 
 #include <cmath>
 #include <limits>
+#include <string>
 
 #include "CohortData.h"
 #include "EnvData.h"
@@ -14,6 +15,7 @@
 #include "Layer.h"
 #include "SoilLayer.h"
 #include "CrankNicholson.h"
+#include "util_structs.h"
 
 class Richards {
 public :
@@ -41,6 +43,9 @@ public :
 
   CrankNicholson cn;
 
+  // Sub-stepping done by update(), collected by the Runner each month
+  SolverStats stats;
+
 private:
 
   EnvData ed;
@@ -54,8 +54,39 @@ public:
   int chtid;    /* currently-running 'cohort' id */
   int error;    /* error index */
 
+  // The restart file whose record cohort.restartdata holds, if the stage
+  // that wrote it finished in this Runner. Empty otherwise.
+  std::string restartdata_fname;
+
+  // Set by load_checkpoint(..) when the cell is resuming part way through
+  // a stage: the stage, and the first year of it still to run.
+  std::string checkpoint_stage;
+  int checkpoint_year;
+
+  // Cell state that a year takes from the year before but that isn't in
+  // RestartData, so a checkpoint has to carry it as well
+  struct CarriedState {
+    snwstate_env snws;
+    soidiag_env soid;
+    int prvltrfcn_months[MAX_SOI_LAY];
+    double prvltrfcn[12][MAX_SOI_LAY];
+  };
+  CarriedState checkpoint_carried;
+
+  void save_checkpoint(const std::string& fname, const std::string& stage, int next_year);
+  bool load_checkpoint(const std::string& fname);
+  void set_state_from_checkpoint();
+
+  // Soil temperature and soil water solver step counts for every month
+  // this cell has run, summed by calendar month
+  SolverStats soil_temp_stats[12];
+  SolverStats soil_water_stats[12];
+
 
   void run_years(int year_start, int year_end, const std::string& stage);
+  void run_year(int year, int year_start, int year_end, const std::string& stage);
+  void prepare_daily_drivers(int year, const std::string& stage);
+  void collect_solver_stats(const int month);
   void modeldata_module_settings_from_args(const ArgHandler &args);
   void output_caljson_yearly(int year, std::string, boost::filesystem::path p);
   void output_caljson_monthly(int year, int month, std::string, boost::filesystem::path p);
@@ -64,17 +95,10 @@ public:
   //void output_netCDF(int year, boost::filesystem::path p);
   void output_netCDF_monthly(int year, int month, std::string stage, int endyr);
   void output_netCDF_yearly(int year, std::string stage, int endyr);
-  void output_netCDF(std::map<std::string, OutputSpec> &outputs, int year, int month, std::string stage, int endyr);
-
-
-  template<typename PTYPE>
-  void output_nc_3dim(OutputSpec* out_spec, std::string stage_suffix, PTYPE data, int max_var_count, int start_timestep, int timesteps);
-
-  template<typename PTYPE>
-  void output_nc_4dim(OutputSpec* out_spec, std::string stage_suffix, PTYPE data, int max_var_count, int start_timestep, int timesteps);
+  void output_netCDF(std::vector<OutputColumn>& columns, int year, int month, std::string stage, int endyr);
 
-  template<typename PTYPE>
-  void output_nc_5dim(OutputSpec* out_spec, std::string stage_suffix, PTYPE data, int max_var_count_1, int max_var_count_2, int start_timestep, int timesteps);
+  void output_nc_column(OutputColumn& column, const std::string& stage_suffix, int start_timestep);
+  void output_nc_block(OutputSpec* out_spec, const std::string& stage_suffix, int ndims, const size_t* datastart, const size_t* datacount, const void* data);
 
 
 private:
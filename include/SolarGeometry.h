@@ -0,0 +1,47 @@
+/*  SolarGeometry.h
+ *
+ *  Day length and gross irradiance (girr) for a latitude.
+ *
+ *  Both depend only on latitude and the day of the year, yet were worked
+ *  out again for every day of every year of a run (day length), and for
+ *  every climate file loaded for a cell (girr, with sin/cos/pow for every
+ *  hour of every day of the year). A SolarGeometry holds both for one
+ *  latitude, computed once.
+ *
+ *  Tables are shared between cells at exactly the same latitude: the
+ *  cache holds them weakly, so a table lives as long as some cell is
+ *  using it and memory does not grow with the number of cells in a run.
+ */
+
+#ifndef _SOLARGEOMETRY_H_
+#define _SOLARGEOMETRY_H_
+
+#include <map>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "timeconst.h"
+
+class SolarGeometry {
+public:
+
+  explicit SolarGeometry(float lat);
+
+  // The table for a latitude, shared with other cells at that latitude
+  static boost::shared_ptr<const SolarGeometry> at_latitude(float lat);
+
+  float lat;
+
+  float daylength[DINY]; // hours, by (zero based) day of year
+  float girr[MINY];      // gross irradiance (W/m^2), by month
+
+private:
+
+  static boost::mutex cache_mutex;
+  static std::map<float, boost::weak_ptr<const SolarGeometry> > cache;
+
+};
+
+#endif /* _SOLARGEOMETRY_H_ */
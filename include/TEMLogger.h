@@ -19,6 +19,8 @@
 
 #include <boost/log/attributes/current_process_id.hpp>
 #include <boost/log/attributes/scoped_attribute.hpp>
+#include <boost/log/attributes/named_scope.hpp>
+#include <boost/log/sources/record_ostream.hpp>
 
 
 namespace logging = boost::log;
@@ -55,6 +57,27 @@ public:
 
 BOOST_LOG_GLOBAL_LOGGER(my_logger, src::severity_logger< severity_level >);
 
+/** Compile-time minimum severity.
+ *
+ * Built with -DTEM_LOG_MIN_SEVERITY=<level> (e.g. "make LOG_MIN_SEVERITY=warn"),
+ * records below that level are removed at compile time: the message is
+ * never formatted and the logging core is never asked whether to keep it.
+ * Named scopes are compiled out too, so scope push/pop in the daily and
+ * solver loops goes away, and --log-scope no longer restricts output.
+ *
+ * Without the define every level stays available to --log-level at run time.
+ */
+#ifdef TEM_LOG_MIN_SEVERITY
+
+#undef BOOST_LOG_SEV
+#define BOOST_LOG_SEV(logger, lvl) \
+  if ((lvl) < TEM_LOG_MIN_SEVERITY) {} else BOOST_LOG_STREAM_SEV(logger, lvl)
+
+#undef BOOST_LOG_NAMED_SCOPE
+#define BOOST_LOG_NAMED_SCOPE(name)
+
+#endif
+
 /** Send string representing an enum value to stream 
  */
 std::ostream& operator<< (std::ostream& strm, severity_level lvl);
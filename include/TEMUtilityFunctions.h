@@ -18,6 +18,8 @@
 #include <json/value.h>
 
 #include <boost/lexical_cast.hpp>
+#include <boost/thread/recursive_mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
 
 #include "cohortconst.h" // needed for NUM_PFT
 #include "TEMLogger.h"
@@ -128,11 +130,14 @@ namespace temutil {
 
   bool onoffstr2bool(const std::string &s);
 
+  double wall_seconds();
+
   std::string file2string(const char *filename);
 
   Json::Value parse_control_file(const std::string &filepath);
 
-  std::vector< std::vector<int> > read_run_mask(const std::string &filename);
+  std::vector< std::vector<int> > read_run_mask(const std::string &filename,
+                                                const std::string &var_name = "run");
 
   std::string report_on_netcdf_file(const std::string& fname, const std::string& varname);
 
@@ -143,6 +148,15 @@ namespace temutil {
   void handle_error(int status, const std::string& filepath = "");
   
   void nc(int status, const std::string& filepath = "");
+
+  // The NetCDF library is not thread safe. Every call into it, whether
+  // reading inputs, writing output from a compute thread or from the
+  // writer's I/O threads, is made holding this one process-wide lock. It is
+  // recursive so that a reader may be called with the lock already held.
+  boost::recursive_mutex& netcdf_mutex();
+  typedef boost::lock_guard<boost::recursive_mutex> NetCDFLock;
+
+  size_t nc_type_size(int nc_data_type);
   
   double interpolate(double value_1, double value_2, double position_1, double position_2, double position_new, int method);
 
@@ -162,6 +176,8 @@ namespace temutil {
 
   int get_timeseries_start_year(const std::string &filename);
   int get_timeseries_end_year(const std::string &filename);
+  int get_timeseries_start_year(int ncid);
+  int get_timeseries_end_year(int ncid);
 
   // draft - reads all timesteps co2 data
   std::vector<float> get_timeseries(const std::string &filename,
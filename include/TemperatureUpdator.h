@@ -9,6 +9,7 @@
 #define TEMPERATUREUPDATOR_H_
 
 #include <cmath>
+#include <string>
 
 #include "Ground.h"
 #include "Layer.h"
@@ -21,6 +22,7 @@
 
 #include "EnvData.h"
 #include "CrankNicholson.h"
+#include "util_structs.h"
 
 class TemperatureUpdator {
 public:
@@ -29,6 +31,9 @@ public:
 
   int itsumall;
 
+  // Sub-stepping done by iterate(), collected by the Runner each month
+  SolverStats stats;
+
   //update temperatures for valid layers
   void updateTemps(const double & tdrv, Layer *frontl, Layer *backl,
                    Layer *fstsoill, Layer* fstfntl, Layer*lstfntl,
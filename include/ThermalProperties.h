@@ -0,0 +1,65 @@
+/*! \file
+ * Thermal conductivity and volumetric heat capacity of the layers of one
+ * ground column.
+ *
+ * Stefan and TemperatureUpdator ask every layer for its frozen and
+ * unfrozen conductivity and heat capacity through Layer's virtuals, several
+ * times a day and often more than once for the same layer. Here the five
+ * properties of a layer are evaluated together, dispatching on the layer's
+ * TYPEKEY to the SoilLayer, SnowLayer or ParentLayer versions directly, and
+ * kept until the layer's water, ice, thickness, density or porosity
+ * changes. The values are exactly those the virtuals return.
+ */
+#ifndef THERMALPROPERTIES_H_
+#define THERMALPROPERTIES_H_
+
+#include "Layer.h"
+#include "LayerPool.h"
+
+class ThermalProperties {
+public:
+  ThermalProperties();
+
+  struct LayerValues {
+    double frz_tc;  // frozen thermal conductivity
+    double unf_tc;  // unfrozen thermal conductivity
+    double frz_vhc; // frozen volumetric heat capacity
+    double unf_vhc; // unfrozen volumetric heat capacity
+    double mix_vhc; // partially frozen volumetric heat capacity
+  };
+
+  // Brings every layer from 'toplayer' down up to date in one pass
+  void update(Layer* toplayer);
+
+  // Forgets everything, e.g. after the column's layers are rearranged
+  void invalidate();
+
+  const LayerValues& of(Layer* l);
+
+  // As Layer::getThermalConductivity() and Layer::getHeatCapacity()
+  double thermalConductivity(Layer* l);
+  double heatCapacity(Layer* l);
+
+private:
+
+  // A layer's values, and the state they were evaluated from
+  struct Entry {
+    const Layer* layer;
+    Layer::TYPEKEY tkey;
+    double liq;
+    double ice;
+    double dz;
+    double rho;
+    double poro;
+    LayerValues values;
+  };
+
+  // indexed by Layer::indl, which starts from 1
+  Entry entries[LayerPool::CAPACITY + 1];
+  Entry scratch; // for a layer whose index is out of range
+
+  bool current(const Entry& e, const Layer* l) const;
+  void evaluate(Entry& e, Layer* l);
+};
+
+#endif /*THERMALPROPERTIES_H_*/
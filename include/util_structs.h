@@ -21,5 +21,32 @@ struct OutputSpec{
   bool daily;
 };
 
+// Work done by an adaptive sub-stepping solver (the soil temperature
+// and soil water solvers), counted while a cell runs.
+struct SolverStats{
+  long solves;          // calls to the solver, each over one day
+  long substeps;        // accepted sub-steps
+  long rejections;      // sub-steps thrown away and retried with half the step
+  long min_steps;       // sub-steps accepted only because the step hit its minimum
+  long iterations;      // trial solutions computed, accepted or not
+  long max_iterations;  // most trial solutions in any one solve
+
+  SolverStats(): solves(0), substeps(0), rejections(0), min_steps(0),
+                 iterations(0), max_iterations(0) {}
+
+  void add(const SolverStats& other) {
+    solves += other.solves;
+    substeps += other.substeps;
+    rejections += other.rejections;
+    min_steps += other.min_steps;
+    iterations += other.iterations;
+    if (other.max_iterations > max_iterations) {
+      max_iterations = other.max_iterations;
+    }
+  }
+
+  void reset() { *this = SolverStats(); }
+};
+
 
 #endif /* UTIL_STRUCTS_H_ */
@@ -0,0 +1,158 @@
+/*  batch_integrator_check.cpp
+ *
+ *  Checks that BatchIntegrator gives exactly the vegetation state that
+ *  Integrator::updateMonthlyVbgc() gives for a single PFT, including when
+ *  trial steps send a pool negative at the minimum step size.
+ *
+ *  The vegetation fluxes all shrink with the pool they drain, so with the
+ *  model's own parameters a pool never goes negative. Here one
+ *  compartment's litterfall rate is raised until it does, however small
+ *  the step. The step size then hits its minimum, where steps are
+ *  accepted anyway, until after 100 of them the state is put back to
+ *  where they started.
+ *
+ *  The first cell of the default config is spun up for a few EQ years,
+ *  and the check is made after each month of the following year. Each
+ *  case is integrated once with the PFT's own Integrator and once as a
+ *  batch of one lane, and the resulting states, fluxes and diagnostics
+ *  must be bitwise identical.
+ *
+ *  Built with 'make batch-integrator-check' and run from the top of the
+ *  repo by legacy_tests/test-batch-integrator.sh.
+ */
+
+#include <cstring>
+#include <cmath>
+#include <iostream>
+
+#include <json/value.h>
+
+#include "../include/Runner.h"
+#include "../include/BatchIntegrator.h"
+#include "../include/Integrator.h"
+#include "../include/TEMUtilityFunctions.h"
+#include "../include/TEMLogger.h"
+
+extern src::severity_logger< severity_level > glg;
+
+namespace {
+
+const int EQ_YEARS = 5;
+
+// Litterfall rates tried, as powers of two (per month). The smallest step
+// is 2^-20 of a month, so at these rates a trial step sends the pool
+// negative at some stage however small it is. Slower rates are still
+// integrated, in up to a million steps a month.
+const int MIN_RATE_EXP = 21;
+const int MAX_RATE_EXP = 24;
+
+// What Integrator::y2cstate_veg() and y2cflux_veg() write back, and the
+// diagnostics delta() leaves behind
+bool same_result(const BgcData& a, const BgcData& b) {
+  return std::memcmp(&a.m_vegs, &b.m_vegs, sizeof(a.m_vegs)) == 0
+      && std::memcmp(&a.m_a2v, &b.m_a2v, sizeof(a.m_a2v)) == 0
+      && std::memcmp(&a.m_v2a, &b.m_v2a, sizeof(a.m_v2a)) == 0
+      && std::memcmp(&a.m_v2soi, &b.m_v2soi, sizeof(a.m_v2soi)) == 0
+      && std::memcmp(&a.m_soi2v, &b.m_soi2v, sizeof(a.m_soi2v)) == 0
+      && std::memcmp(&a.m_v2v, &b.m_v2v, sizeof(a.m_v2v)) == 0
+      && std::memcmp(&a.m_vegd, &b.m_vegd, sizeof(a.m_vegd)) == 0;
+}
+
+/** Integrates a month of PFT ip's vegetation with each compartment's
+ *  litterfall in turn made too fast for the integrator, with Integrator
+ *  and with BatchIntegrator. Leaves the PFT as it found it.
+ */
+void check_pft(Cohort& cohort, int ip, int& checked, int& failed) {
+
+  cohort.vegbgc[ip].prepareIntegration(cohort.md->get_nfeed());
+
+  const BgcData start_bd = cohort.bd[ip];
+  const Vegetation_Bgc start_vegbgc = cohort.vegbgc[ip];
+
+  Integrator integrator;
+  integrator.setBgcData(&cohort.bd[ip]);
+  integrator.setVegetation_Bgc(&cohort.vegbgc[ip]);
+  Integrator* lanes[] = { &integrator };
+  BatchIntegrator batch;
+
+  for (int i = 0; i < NUM_PFT_PART; i++) {
+    if (!(start_vegbgc.calpar.cfall[i] > 0.) || !(start_bd.m_vegs.c[i] > 0.)) {
+      continue;
+    }
+
+    for (int e = MIN_RATE_EXP; e <= MAX_RATE_EXP; e++) {
+      cohort.bd[ip] = start_bd;
+      cohort.vegbgc[ip] = start_vegbgc;
+      cohort.vegbgc[ip].calpar.cfall[i] = std::pow(2.0, e);
+      integrator.updateMonthlyVbgc();
+      BgcData single = cohort.bd[ip];
+
+      cohort.bd[ip] = start_bd;
+      cohort.vegbgc[ip] = start_vegbgc;
+      cohort.vegbgc[ip].calpar.cfall[i] = std::pow(2.0, e);
+      batch.updateMonthlyVbgc(lanes, 1);
+
+      checked++;
+      if (!same_result(single, cohort.bd[ip])) {
+        failed++;
+        std::cout << "DIFFERS: PFT " << ip << ", compartment " << i
+                  << ", litterfall rate 2^" << e << "\n";
+      }
+    }
+  }
+
+  cohort.bd[ip] = start_bd;
+  cohort.vegbgc[ip] = start_vegbgc;
+}
+
+} // end anonymous namespace
+
+int main(int argc, char* argv[]) {
+
+  setup_logging("fatal", "");
+
+  Json::Value controldata = temutil::parse_control_file("config/config.js");
+  ModelData modeldata(controldata);
+
+  Runner runner(modeldata, false, 0, 0);
+  Cohort& cohort = runner.cohort;
+  ModelData* md = cohort.md;
+
+  md->set_envmodule(md->eq_env);
+  md->set_bgcmodule(md->eq_bgc);
+  md->set_nfeed(md->eq_nfeed);
+  md->set_avlnflg(md->eq_avln);
+  md->set_baseline(md->eq_baseline);
+  md->set_dsbmodule(false);
+  md->set_dslmodule(md->eq_dsl);
+  md->set_dynamic_lai_module(md->eq_dyn_lai);
+
+  cohort.climate.prepare_daily_driving_data(0, "eq");
+  cohort.initialize_internal_pointers();
+  cohort.initialize_state_parameters();
+
+  for (int iy = 0; iy < EQ_YEARS; iy++) {
+    runner.run_year(iy, 0, EQ_YEARS, "eq-run");
+  }
+
+  int checked = 0;
+  int failed = 0;
+
+  runner.prepare_daily_drivers(EQ_YEARS, "eq-run");
+  for (int im = 0; im < 12; im++) {
+    cohort.updateMonthly(EQ_YEARS, im, DINM[im], "eq-run");
+
+    for (int ip = 0; ip < NUM_PFT; ip++) {
+      if (cohort.cd.m_veg.vegcov[ip] > 0.) {
+        check_pft(cohort, ip, checked, failed);
+      }
+    }
+  }
+
+  std::cout << checked << " months integrated both ways, " << failed << " differ.\n";
+  if (checked == 0) {
+    std::cout << "No PFT had any litterfall, so nothing was checked.\n";
+    return 1;
+  }
+  return failed > 0 ? 1 : 0;
+}
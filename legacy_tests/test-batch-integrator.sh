@@ -0,0 +1,14 @@
+#!/bin/bash
+
+# Checks that integrating the PFTs' vegetation C and N together with
+# BatchIntegrator gives bitwise the same state as integrating each PFT on
+# its own with Integrator, including when a pool goes negative and the
+# step size has been cut to its minimum. See
+# legacy_tests/batch_integrator_check.cpp.
+#
+# Run from the top of the repo. Builds the checker with the same settings
+# as the model, so pass the same variables as for 'make', e.g.
+#   legacy_tests/test-batch-integrator.sh SITE_SPECIFIC_INCLUDES=...
+
+make batch-integrator-check "$@" || exit 1
+./batch-integrator-check
@@ -0,0 +1,40 @@
+#!/bin/bash
+
+# Checks that reusing the daily climate forcing for PR, EQ and SP does not
+# change the results. Runs the cells in the default config once with the
+# forcing cache and once with --no-forcing-cache, and compares every NetCDF
+# file in the output directory, restart files included. run_status.nc is
+# left out, as it holds each cell's runtime.
+#
+# Run from the top of the repo after building. Requires nccmp, found at
+# http://nccmp.sourceforge.net/
+
+YEARS="--pr-yrs 10 --eq-yrs 100 --sp-yrs 60 --tr-yrs 10 --sc-yrs 0"
+OUTPUT_DIR="output"
+SAVE_DIR="$(mktemp -d)"
+
+echo "Run with the forcing cache..."
+time ./dvmdostem $YEARS --log-level warn || exit 1
+cp -r "$OUTPUT_DIR" "$SAVE_DIR/cached"
+
+echo "Run without the forcing cache..."
+time ./dvmdostem $YEARS --log-level warn --no-forcing-cache || exit 1
+cp -r "$OUTPUT_DIR" "$SAVE_DIR/uncached"
+
+status=0
+for file in "$SAVE_DIR"/cached/*.nc; do
+  filename=${file##*/}
+  if [ "$filename" == "run_status.nc" ]; then
+    continue
+  fi
+  if ! nccmp -d "$SAVE_DIR/cached/$filename" "$SAVE_DIR/uncached/$filename"; then
+    echo "DIFFERS: $filename"
+    status=1
+  fi
+done
+
+if [ $status -eq 0 ]; then
+  echo "All output is identical with and without the forcing cache."
+fi
+rm -rf "$SAVE_DIR"
+exit $status
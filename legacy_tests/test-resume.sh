@@ -0,0 +1,75 @@
+#!/bin/bash
+
+# Checks that a run interrupted part way through TR and carried on with
+# --resume gives the same output as a run that was never interrupted.
+#
+# Both runs use the default config with checkpoint_interval set. The first
+# runs to the end. The second is killed as soon as a cell has saved a
+# checkpoint in TR, then resumed. Every NetCDF file in the output
+# directory, restart files included, is then compared. run_status.nc is
+# left out, as it holds each cell's runtime.
+#
+# Run from the top of the repo after building. Requires nccmp, found at
+# http://nccmp.sourceforge.net/
+
+YEARS="--pr-yrs 10 --eq-yrs 100 --sp-yrs 60 --tr-yrs 40 --sc-yrs 0"
+INTERVAL=5
+OUTPUT_DIR="output"
+SAVE_DIR="$(mktemp -d)"
+CONFIG="$SAVE_DIR/config.js"
+
+sed -e "s/\"checkpoint_interval\": *[0-9]*/\"checkpoint_interval\": $INTERVAL/" \
+    config/config.js > "$CONFIG"
+
+# Stage a checkpoint was saved in, from its header (see Runner.cpp)
+checkpoint_stage() {
+  dd if="$1" bs=1 skip=24 count=2 2>/dev/null
+}
+
+echo "Uninterrupted run..."
+./dvmdostem $YEARS --ctrl-file "$CONFIG" --log-level warn || exit 1
+cp -r "$OUTPUT_DIR" "$SAVE_DIR/uninterrupted"
+
+echo "Run to be interrupted during TR..."
+./dvmdostem $YEARS --ctrl-file "$CONFIG" --log-level warn &
+pid=$!
+interrupted=0
+while kill -0 $pid 2>/dev/null; do
+  for ckpt in "$OUTPUT_DIR"/checkpoints/*.ckpt; do
+    if [ -f "$ckpt" ] && [ "$(checkpoint_stage "$ckpt")" == "tr" ]; then
+      kill -9 $pid
+      interrupted=1
+      break 2
+    fi
+  done
+  sleep 0.2
+done
+wait $pid 2>/dev/null
+
+if [ $interrupted -eq 0 ]; then
+  echo "The run finished before it saved a TR checkpoint. Use more TR years."
+  rm -rf "$SAVE_DIR"
+  exit 1
+fi
+
+echo "Resuming..."
+./dvmdostem $YEARS --ctrl-file "$CONFIG" --log-level warn --resume || exit 1
+cp -r "$OUTPUT_DIR" "$SAVE_DIR/resumed"
+
+status=0
+for file in "$SAVE_DIR"/uninterrupted/*.nc; do
+  filename=${file##*/}
+  if [ "$filename" == "run_status.nc" ]; then
+    continue
+  fi
+  if ! nccmp -d "$SAVE_DIR/uninterrupted/$filename" "$SAVE_DIR/resumed/$filename"; then
+    echo "DIFFERS: $filename"
+    status=1
+  fi
+done
+
+if [ $status -eq 0 ]; then
+  echo "The resumed run's output is identical to the uninterrupted run's."
+fi
+rm -rf "$SAVE_DIR"
+exit $status
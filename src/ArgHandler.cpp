@@ -44,6 +44,32 @@ void ArgHandler::parse(int argc, char** argv) {
      "such as PEcAn that makes assumptions about the presence of an output "
      "directory and may perform its own cleanup.")
 
+    ("resume", boost::program_options::bool_switch(&resume),
+     "Continue an interrupted run in the same output directory. Cells that "
+     "run_status.nc shows as finished are skipped; the rest start again from "
+     "their last checkpoint (see checkpoint_interval in the control file), "
+     "or from the beginning if they have none. Nothing in the output "
+     "directory is cleaned up or re-created.")
+
+    ("write-daily-drivers", boost::program_options::bool_switch(&write_daily_drivers),
+     "Write the daily climate forcing derived for every cell to "
+     "daily_drivers_<stage>.nc in the output directory: one year for EQ "
+     "(which PR shares), the 30 year cycle for SP, and every year of TR and "
+     "SC. A later run can read them back with --read-daily-drivers.")
+
+    ("read-daily-drivers", boost::program_options::value<std::string>(&read_daily_drivers)
+     ->default_value(""),
+     "Read each cell's daily climate forcing from the daily_drivers_<stage>.nc "
+     "files in this directory (written by --write-daily-drivers) instead of "
+     "deriving it from the monthly climate. The files must cover the same "
+     "cells, and at least as many years of each stage as are being run.")
+
+    ("no-forcing-cache", boost::program_options::bool_switch(&no_forcing_cache),
+     "Derive the daily climate forcing afresh for every year. By default "
+     "each cell derives the PR/EQ forcing once and each year of the SP "
+     "cycle once, and reuses them. The results are the same either way; "
+     "this is for checking that they are.")
+
     ("inter-stage-pause", boost::program_options::bool_switch(&inter_stage_pause),
      "With this flag, (and when in calibration mode), the model will pause and "
      "wait for user input at the end of each run-stage.")
@@ -132,6 +158,19 @@ void ArgHandler::parse(int argc, char** argv) {
     ("sha", boost::program_options::bool_switch(&print_sha),
      "Prints the SHA of the commit used to build this binary then exits")
 
+    ("compile-params", boost::program_options::bool_switch(&compile_params),
+     "Checks every community type in the parameter directory named in the "
+     "control file and writes them to a compiled binary file in that "
+     "directory, then exits. Later runs read the compiled file instead of "
+     "the text files for as long as it is newer than all of them.")
+
+    ("convert-restart",
+     boost::program_options::value<std::vector<std::string> >(&convert_restart)
+       ->multitoken(),
+     "Takes two files, IN and OUT, and converts a restart file between the "
+     "NetCDF (.nc) and binary checkpoint (.bin) formats, then exits. The "
+     "direction is chosen by the file extensions. Run as a single process.")
+
     ("help,h",
      boost::program_options::bool_switch(&help),
      "Produces helps message, then quits")
@@ -170,6 +209,11 @@ void ArgHandler::verify() {
     BOOST_LOG_SEV(glg, warn) << "Invalid argument combination!: --inter-stage-pause is not effective without --cal-mode!";
   }
 
+  if (this->write_daily_drivers && !this->read_daily_drivers.empty()) {
+    BOOST_LOG_SEV(glg, fatal) << "Invalid argument combination!: --write-daily-drivers and --read-daily-drivers can't be used together!";
+    exit(-1);
+  }
+
   if (this->force_cmt >= 0) {
     BOOST_LOG_SEV(glg, warn) << "Forcing cmt number to " << this->force_cmt << "!";
   }
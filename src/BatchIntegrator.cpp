@@ -0,0 +1,314 @@
+/*! \file
+*
+* Lockstep RKF45 integration of the vegetation BGC of several PFTs.
+* See BatchIntegrator.h. The step size control and the Runge-Kutta
+* coefficients are those of Integrator::adapt() and Integrator::rkf45(),
+* applied to each lane separately.
+*/
+
+#include "../include/TEMLogger.h"
+
+extern src::severity_logger< severity_level > glg;
+
+#include "../include/BatchIntegrator.h"
+
+// Defined with the rest of the step acceptance logic in Integrator.cpp
+extern int REJECT;
+extern int ACCEPT;
+
+BatchIntegrator::BatchIntegrator() {
+  nlanes = 0;
+};
+
+BatchIntegrator::~BatchIntegrator() {
+};
+
+/** Integrates one month of vegetation BGC for each of the lanes.
+ *
+ *  Each lane must have been set up as for Integrator::updateMonthlyVbgc(),
+ *  i.e. its Vegetation_Bgc prepared for integration, and the results are
+ *  saved back to each lane's 'bd' the same way.
+ */
+void BatchIntegrator::updateMonthlyVbgc(Integrator * lanes[], const int &numlanes) {
+  nlanes = numlanes;
+
+  for (int l = 0; l < nlanes; l++) {
+    lane[l] = lanes[l];
+    lane[l]->vegbgc = true;
+    lane[l]->soibgc = false;
+
+    // initialize the state from each lane's 'bd'
+    for (int iv = 0; iv < NUMEQ; iv++) {
+      lane[l]->y[iv] = 0.0;
+    }
+
+    lane[l]->c2ystate_veg(lane[l]->y);
+
+    for (int i = 0; i < NUMEQ_VEG; i++) {
+      y[i][l] = lane[l]->y[i];
+    }
+  }
+
+  adapt();
+
+  // after integration, save results back to each lane's 'bd'
+  for (int l = 0; l < nlanes; l++) {
+    for (int i = 0; i < NUMEQ_VEG; i++) {
+      lane[l]->y[i] = y[i][l];
+    }
+
+    lane[l]->y2cstate_veg(lane[l]->y);
+    lane[l]->y2cflux_veg(lane[l]->y);
+  }
+};
+
+/** Integrator::adapt(), with every lane taking one trial step per pass.
+ *
+ *  A lane that has reached the end of the month sits out the remaining
+ *  passes; its stage arrays are still computed but never used.
+ */
+void BatchIntegrator::adapt() {
+  float ptol = 0.01;
+  int remaining = nlanes;
+
+  for (int l = 0; l < nlanes; l++) {
+    time[l] = 0.0;
+    dt[l] = 1.0;
+    nintmon[l] = 0;
+    done[l] = false;
+    lane[l]->blackhol = 0;
+  }
+
+  while (remaining > 0) {
+    rkf45();
+
+    for (int l = 0; l < nlanes; l++) {
+      if (done[l]) {
+        continue;
+      }
+
+      Integrator * ln = lane[l];
+      int test = REJECT;
+
+      if (live[l]) {
+        for (int i = 0; i < NUMEQ_VEG; i++) {
+          ln->dum4[i] = dum4[i][l];
+          ln->error[i] = error[i][l];
+        }
+
+        test = ln->boundcon(ln->dum4, ln->error, ptol);
+      }
+
+      // Step size is already super small - accept the result
+      if ( dt[l] <= pow(0.5, ln->maxit) ) {
+        test = ACCEPT;
+
+        if ( nintmon[l] == 0 ) {
+          for (int i = 0; i < NUMEQ_VEG; i++) {
+            oldstate[i][l] = y[i][l];
+          }
+        }
+
+        ++nintmon[l];
+      }
+
+      if ( test == ACCEPT ) {
+        for (int i = 0; i < NUMEQ_VEG; i++) {
+          y[i][l] = dum4[i][l];
+        }
+
+        time[l] += dt[l];
+
+        float ipart; // split into intger and fractional parts...
+        float fpart;
+        fpart = modf( (0.01 + (time[l]/(2.0*dt[l]))), &ipart );
+        if ( fpart < 0.1 && dt[l] < 1.0) {
+          dt[l] *= 2.0;
+        }
+      } else {
+        dt[l] *= 0.500;
+      }
+
+      if ( nintmon[l] == ln->maxitmon ) {
+        time[l] = 1.0;
+        ln->blackhol = 1;
+
+        for (int i = 0; i < NUMEQ_VEG; i++) {
+          y[i][l] = oldstate[i][l];
+        }
+      }
+
+      if ( time[l] == 1.0 ) {
+        done[l] = true;
+        --remaining;
+      }
+    }
+  }
+};
+
+/** One trial step of Integrator::rkf45() for every lane still integrating.
+ *
+ *  A lane whose trial step sends a pool negative drops out of the rest of
+ *  the step (live[l] is false), ends it with dum4 equal to its starting
+ *  state and has the step rejected by adapt(), unless the step size is
+ *  already at its minimum.
+ */
+void BatchIntegrator::rkf45() {
+  for (int l = 0; l < nlanes; l++) {
+    live[l] = !done[l];
+    ptdt[l] = dt[l] * 0.25;
+  }
+
+  // initialize stuff to zero
+  for (int i = 0; i < NUMEQ_VEG; i++) {
+    for (int l = 0; l < nlanes; l++) {
+      dum4[i][l] = dum5[i][l] = y[i][l];
+      yprime[i][l] = rk45[i][l] = error[i][l] = 0.0;
+      f11[i][l] = f3[i][l] = f4[i][l] = f5[i][l] = f6[i][l] = 0.0;
+    }
+  }
+
+  delta(dum4, f11);
+  step(yprime, f11, yprime, Integrator::a1);
+  step(rk45, f11, rk45, Integrator::b1);
+  step(dum4, f11, ydum, ptdt);
+  checkPools();
+
+  delta(ydum, f2);
+
+  for (int i = 0; i < NUMEQ_VEG; i++) {
+    for (int l = 0; l < nlanes; l++) {
+      f13[i][l] = Integrator::a31*f11[i][l] + Integrator::a32*f2[i][l];
+    }
+  }
+
+  step(dum4, f13, ydum, dt);
+  checkPools();
+
+  delta(ydum, f3);
+  step(yprime, f3, yprime, Integrator::a3);
+  step(rk45, f3, rk45, Integrator::b3);
+
+  for (int i = 0; i < NUMEQ_VEG; i++) {
+    for (int l = 0; l < nlanes; l++) {
+      f14[i][l] = Integrator::a41*f11[i][l] + Integrator::a42*f2[i][l]
+                  + Integrator::a43*f3[i][l];
+    }
+  }
+
+  step(dum4, f14, ydum, dt);
+  checkPools();
+
+  delta(ydum, f4);
+  step(yprime, f4, yprime, Integrator::a4);
+  step(rk45, f4, rk45, Integrator::b4);
+
+  for (int i = 0; i < NUMEQ_VEG; i++) {
+    for (int l = 0; l < nlanes; l++) {
+      f15[i][l] = Integrator::a51*f11[i][l] + Integrator::a52*f2[i][l]
+                  + Integrator::a53*f3[i][l] + Integrator::a54*f4[i][l];
+    }
+  }
+
+  step(dum4, f15, ydum, dt);
+  checkPools();
+
+  delta(ydum, f5);
+  step(yprime, f5, yprime, Integrator::a5);
+  step(rk45, f5, rk45, Integrator::b5);
+
+  for (int i = 0; i < NUMEQ_VEG; i++) {
+    for (int l = 0; l < nlanes; l++) {
+      f16[i][l] = Integrator::b61*f11[i][l] + Integrator::b62*f2[i][l]
+                  + Integrator::b63*f3[i][l] + Integrator::b64*f4[i][l]
+                  + Integrator::b65*f5[i][l];
+    }
+  }
+
+  step(dum4, f16, ydum, dt);
+  checkPools();
+
+  delta(ydum, f6);
+  step(rk45, f6, rk45, Integrator::b6);
+  step(dum4, yprime, dum4, dt);
+  step(dum5, rk45, dum5, dt);
+
+  for (int i = 0; i < NUMEQ_VEG; i++) {
+    for (int l = 0; l < nlanes; l++) {
+      error[i][l] = fabs( dum4[i][l] - dum5[i][l] );
+    }
+  }
+
+  // Integrator::rkf45() returns as soon as a pool goes negative, leaving
+  // dum4 at the starting state. A lane that dropped out has only part of
+  // its step in dum4 here, so it is put back, or adapt() could accept the
+  // partial step at the minimum step size.
+  for (int l = 0; l < nlanes; l++) {
+    if (live[l]) {
+      continue;
+    }
+
+    for (int i = 0; i < NUMEQ_VEG; i++) {
+      dum4[i][l] = y[i][l];
+      error[i][l] = 0.0;
+    }
+  }
+};
+
+/** Evaluates the derivatives of each live lane with its own Integrator. */
+void BatchIntegrator::delta(float pstate[][NUM_PFT], float pdstate[][NUM_PFT]) {
+  for (int l = 0; l < nlanes; l++) {
+    if (!live[l]) {
+      continue;
+    }
+
+    Integrator * ln = lane[l];
+
+    for (int i = 0; i < NUMEQ_VEG; i++) {
+      ln->dumy[i] = pstate[i][l];
+    }
+
+    ln->delta(ln->dumy, ln->f2);
+
+    for (int i = 0; i < NUMEQ_VEG; i++) {
+      pdstate[i][l] = ln->f2[i];
+    }
+  }
+};
+
+/** Drops any lane whose trial state 'ydum' has a negative pool. */
+void BatchIntegrator::checkPools() {
+  for (int l = 0; l < nlanes; l++) {
+    if (!live[l]) {
+      continue;
+    }
+
+    Integrator * ln = lane[l];
+
+    for (int i = 0; i < NUMEQ_VEG; i++) {
+      ln->ydum[i] = ydum[i][l];
+    }
+
+    if (ln->checkPools() >= 0) {
+      live[l] = false;
+    }
+  }
+};
+
+void BatchIntegrator::step(float pstate[][NUM_PFT], float pdstate[][NUM_PFT],
+                           float ptstate[][NUM_PFT], const float pdt[]) {
+  for (int i = 0; i < NUMEQ_VEG; i++) {
+    for (int l = 0; l < nlanes; l++) {
+      ptstate[i][l] = pstate[i][l] + (pdt[l] * pdstate[i][l]);
+    }
+  }
+};
+
+void BatchIntegrator::step(float pstate[][NUM_PFT], float pdstate[][NUM_PFT],
+                           float ptstate[][NUM_PFT], const float& pdt) {
+  for (int i = 0; i < NUMEQ_VEG; i++) {
+    for (int l = 0; l < nlanes; l++) {
+      ptstate[i][l] = pstate[i][l] + (pdt * pdstate[i][l]);
+    }
+  }
+};
@@ -605,6 +605,7 @@ void CalController::continue_simulation() {
 void CalController::reload_all_cmt_files() {
   BOOST_LOG_SEV(glg, info) << "Executing reload_cmt_files callback...";
   BOOST_LOG_SEV(glg, debug) << "Use cohort pointer to reload all cmt files...";
+  CohortLookup::clear_cache();
   this->cohort_ptr->chtlu.init();
   BOOST_LOG_SEV(glg, info) << "Done reloading config/parameter files.";
 }
@@ -0,0 +1,288 @@
+/*  CellScheduler.cpp
+ *
+ *  Cost ordered distribution of cells. See CellScheduler.h
+ */
+
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+
+#include <netcdf.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "../include/CellScheduler.h"
+#include "../include/ModelData.h"
+#include "../include/ClimateTile.h"
+#include "../include/TEMUtilityFunctions.h"
+#include "../include/TEMLogger.h"
+
+extern src::severity_logger< severity_level > glg;
+
+namespace {
+
+/** Read a whole 2D (Y, X) integer variable. Returns false, with a warning,
+ *  if the file or variable can't be read or doesn't match the run mask.
+ */
+bool read_int_grid(const std::string& filename, const std::string& var_name,
+                   int num_rows, int num_cols, std::vector<int>& values) {
+  int ncid = -1;
+  try {
+    temutil::NetCDFLock lock(temutil::netcdf_mutex());
+    temutil::nc( nc_open(filename.c_str(), NC_NOWRITE, &ncid), filename );
+
+    int varid, ndims;
+    int dimids[NC_MAX_VAR_DIMS];
+    temutil::nc( nc_inq_varid(ncid, var_name.c_str(), &varid), filename );
+    temutil::nc( nc_inq_var(ncid, varid, NULL, NULL, &ndims, dimids, NULL) );
+
+    size_t ylen = 0, xlen = 0;
+    if (ndims == 2) {
+      temutil::nc( nc_inq_dimlen(ncid, dimids[0], &ylen) );
+      temutil::nc( nc_inq_dimlen(ncid, dimids[1], &xlen) );
+    }
+    if (ndims != 2 || (int)ylen != num_rows || (int)xlen != num_cols) {
+      BOOST_LOG_SEV(glg, warn) << var_name << " in " << filename << " does not "
+                               << "match the size of the run mask. Not using it "
+                               << "to order the cells.";
+      temutil::nc( nc_close(ncid) );
+      return false;
+    }
+
+    values.resize(num_rows * num_cols);
+    temutil::nc( nc_get_var_int(ncid, varid, &values[0]) );
+    temutil::nc( nc_close(ncid) );
+
+  } catch (std::exception& e) {
+    BOOST_LOG_SEV(glg, warn) << "Could not read " << var_name << " from " << filename
+                             << " to order the cells: " << e.what();
+    if (ncid >= 0) {
+      nc_close(ncid);
+    }
+    return false;
+  }
+  return true;
+}
+
+// Sorts cell indices by cost, highest first. If the cells are grouped
+// into tiles the tiles are kept together, in order of their most
+// expensive cell.
+struct CostGreater {
+  const std::vector<double>& cost;
+  const std::vector<double>& tile_cost;
+  int tile_size; // Cells per tile
+  CostGreater(const std::vector<double>& cost, const std::vector<double>& tile_cost,
+              int tile_size): cost(cost), tile_cost(tile_cost), tile_size(tile_size) {}
+  bool operator()(int a, int b) const {
+    int ta = a / tile_size;
+    int tb = b / tile_size;
+    if (ta != tb) {
+      if (tile_cost[ta] != tile_cost[tb]) {
+        return tile_cost[ta] > tile_cost[tb];
+      }
+      return ta < tb;
+    }
+    return cost[a] > cost[b];
+  }
+};
+
+} // end anonymous namespace
+
+
+CellScheduler::CellScheduler(const std::vector< std::vector<int> >& run_mask,
+                             const ModelData& md):
+    num_cols(run_mask[0].size()), next_position(0), shared_counter(false),
+    cells_run(0), busy_seconds(0.0) {
+
+  std::vector<double> cost;
+  estimate_costs(run_mask, md, cost);
+
+  // When climate is read in tiles of rows, the cells of a tile are run
+  // together so that each tile only has to be read once.
+  int tile_size = cost.size();
+  if (md.climate_tiles) {
+    tile_size = md.climate_tiles->get_tile_rows() * num_cols;
+  }
+  std::vector<double> tile_cost((cost.size() + tile_size - 1) / tile_size, -1.0);
+  for (unsigned int ic=0; ic<cost.size(); ic++) {
+    tile_cost[ic / tile_size] = std::max(tile_cost[ic / tile_size], cost[ic]);
+  }
+
+  // Cells that are masked out only need their status written, so they go
+  // last (their cost is set below any real cost).
+  order.resize(cost.size());
+  for (unsigned int ic=0; ic<order.size(); ic++) {
+    order[ic] = ic;
+  }
+  std::stable_sort(order.begin(), order.end(), CostGreater(cost, tile_cost, tile_size));
+
+#ifdef WITHMPI
+  MPI_Comm_rank(MPI_COMM_WORLD, &id);
+  MPI_Comm_size(MPI_COMM_WORLD, &ntasks);
+
+  int thread_support;
+  MPI_Query_thread(&thread_support);
+  shared_counter = (thread_support >= MPI_THREAD_MULTIPLE);
+
+  // Created by every rank, whether or not it ends up being used
+  MPI_Win_allocate(sizeof(int), sizeof(int), MPI_INFO_NULL, MPI_COMM_WORLD,
+                   &counter, &counter_win);
+  MPI_Win_lock(MPI_LOCK_EXCLUSIVE, id, 0, counter_win);
+  *counter = 0;
+  MPI_Win_unlock(id, counter_win);
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  if (!shared_counter) {
+    next_position = id;
+    if (id == 0) {
+      BOOST_LOG_SEV(glg, warn) << "MPI was not initialized with MPI_THREAD_MULTIPLE. "
+                               << "Cells will be dealt out to the ranks in a fixed "
+                               << "order instead of on demand.";
+    }
+  }
+#endif
+
+  start_time = temutil::wall_seconds();
+}
+
+CellScheduler::~CellScheduler() {
+#ifdef WITHMPI
+  MPI_Win_free(&counter_win);
+#endif
+}
+
+/** Cost estimate for every cell of the run mask, indexed row * num_cols +
+ *  col. Only the relative sizes matter.
+ */
+void CellScheduler::estimate_costs(const std::vector< std::vector<int> >& run_mask,
+                                   const ModelData& md, std::vector<double>& cost) {
+
+  int num_rows = run_mask.size();
+  cost.assign(num_rows * num_cols, 1.0);
+
+  std::vector<int> values;
+
+  if (!md.cell_cost_file.empty() &&
+      read_int_grid(md.cell_cost_file, "total_runtime", num_rows, num_cols, values)) {
+
+    // Cells without a runtime in the previous run (masked, failed or timed
+    // out) are assumed to cost as much as the average cell.
+    double total = 0.0;
+    long known = 0;
+    for (unsigned int ic=0; ic<values.size(); ic++) {
+      if (values[ic] >= 0) {
+        total += values[ic];
+        known++;
+      }
+    }
+    double mean = (known > 0) ? total / known : 1.0;
+    for (unsigned int ic=0; ic<values.size(); ic++) {
+      cost[ic] = (values[ic] >= 0) ? values[ic] : mean;
+    }
+    BOOST_LOG_SEV(glg, info) << "Ordering cells by the runtimes in " << md.cell_cost_file;
+
+  } else if (read_int_grid(md.drainage_file, "drainage_class", num_rows, num_cols, values)) {
+
+    // Wet soils take the thermal and hydrology solvers more iterations,
+    // so poorly drained cells are started first.
+    for (unsigned int ic=0; ic<values.size(); ic++) {
+      cost[ic] = (values[ic] == 1) ? 2.0 : 1.0; // 0: well-drained; 1: poorly-drained
+    }
+    BOOST_LOG_SEV(glg, info) << "Ordering cells by drainage class.";
+  }
+
+  for (int rowidx=0; rowidx<num_rows; rowidx++) {
+    for (int colidx=0; colidx<num_cols; colidx++) {
+      if (!run_mask[rowidx][colidx]) {
+        cost[rowidx * num_cols + colidx] = -1.0;
+      }
+    }
+  }
+}
+
+/** Claim the next cell to run. Returns false once every cell has been
+ *  handed out. Safe to call from any thread.
+ */
+bool CellScheduler::next_cell(int& rowidx, int& colidx) {
+
+  int position;
+  {
+    boost::lock_guard<boost::mutex> lock(claim_mutex);
+#ifdef WITHMPI
+    if (shared_counter) {
+      int one = 1;
+      MPI_Win_lock(MPI_LOCK_SHARED, 0, 0, counter_win);
+      MPI_Fetch_and_op(&one, &position, MPI_INT, 0, 0, MPI_SUM, counter_win);
+      MPI_Win_unlock(0, counter_win);
+    } else {
+      position = next_position;
+      next_position += ntasks;
+    }
+#else
+    position = next_position++;
+#endif
+  }
+
+  if (position >= (int)order.size()) {
+    return false;
+  }
+  rowidx = order[position] / num_cols;
+  colidx = order[position] % num_cols;
+  return true;
+}
+
+/** Record the time spent running a cell, for the utilization report. */
+void CellScheduler::cell_done(double seconds) {
+  boost::lock_guard<boost::mutex> lock(claim_mutex);
+  cells_run++;
+  busy_seconds += seconds;
+}
+
+/** How busy the threads were while cells were being handed out. Under MPI
+ *  this is collective and the report, one line per rank, is only returned
+ *  on rank 0.
+ */
+std::string CellScheduler::utilization_report() {
+
+  double wall_seconds = temutil::wall_seconds() - start_time;
+  int threads = 1;
+#ifdef _OPENMP
+  threads = omp_get_max_threads();
+#endif
+
+  std::vector<double> stats(4);
+  stats[0] = cells_run;
+  stats[1] = busy_seconds;
+  stats[2] = wall_seconds;
+  stats[3] = threads;
+
+  int rank_count = 1;
+  std::vector<double> all_stats(stats);
+
+#ifdef WITHMPI
+  rank_count = ntasks;
+  all_stats.resize(4 * ntasks);
+  MPI_Gather(&stats[0], 4, MPI_DOUBLE, &all_stats[0], 4, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+  if (id != 0) {
+    return "";
+  }
+#endif
+
+  std::stringstream s;
+  s << "Cell scheduler utilization:\n"
+    << std::setw(6) << "rank" << std::setw(10) << "cells"
+    << std::setw(14) << "busy (s)" << std::setw(14) << "wall (s)"
+    << std::setw(9) << "threads" << std::setw(13) << "utilization\n";
+  s << std::fixed << std::setprecision(1);
+  for (int ir=0; ir<rank_count; ir++) {
+    const double* r = &all_stats[4 * ir];
+    double capacity = r[2] * r[3];
+    s << std::setw(6) << ir << std::setw(10) << (long)r[0]
+      << std::setw(14) << r[1] << std::setw(14) << r[2]
+      << std::setw(9) << (int)r[3]
+      << std::setw(11) << ((capacity > 0) ? 100.0 * r[1] / capacity : 0.0) << " %\n";
+  }
+  return s.str();
+}
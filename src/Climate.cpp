@@ -1,12 +1,20 @@
 #include <numeric> // for accumulate
 #include <vector>
 #include <algorithm>
+#include <map>
+#include <atomic>
+#include <system_error>
 
 #include <assert.h> // for assert? need C++ library?
 
 #include <boost/filesystem.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
 
 #include "../include/Climate.h"
+#include "../include/ClimateTile.h"
+#include "../include/InputFiles.h"
+#include "../include/SolarGeometry.h"
 
 #include "../include/errorcode.h"
 #include "../include/timeconst.h"
@@ -105,67 +113,6 @@ std::pair<float, float> willmot_split(const float t, const float p) {
   return std::make_pair(r,s);
 }
 
-/** GIRR (W/m^2) as a function of latitude and month.
-*
-*  More information and formulas can be found here:
-*  http://www.fao.org/docrep/X0490E/x0490e07.htm
-*  (section "Extraterrestrial radiation for daily periods")
-* 
-*  And a table of expected values here:
-*  http://www.fao.org/docrep/X0490E/x0490e0j.htm#annex%202.%20meteorological%20tables
-* 
-*  NOTE: To convert from MJ/m^2/day to W/m^2:
-*        multiply by (1,000,000)/(60*60*24) or ~11.57
-*/
-float calculate_girr(const float lat, const int im) {
-  const float pi = 3.141592654;                // Greek "pi" TODO: fix this to use constant from math library?
-  const float sp = 1368.0 * 3600.0 / 41860.0;  // solar constant
-  float lambda;
-  float sumd;
-  float sig;
-  float eta;
-  float sinbeta;
-  float sb;
-  float sotd;
-  int hour;
-  lambda = lat * pi / 180.0;
-  float gross = 0.0;
-
-  for ( int day = 0; day < DINM[im]; ++day ) {
-
-    // find julian day
-    // http://www.fao.org/docrep/X0490E/x0490e0j.htm#annex%202.%20meteorological%20tables
-    float jd = 0.0;
-    jd = (275 * (im+1)/9) - 30 + (day+1);
-    if( (im+1) < 3 ) {
-      jd = jd + 2;
-    }
-    int julianday = int(jd);
-
-    sumd = 0;
-    sig = -23.4856*cos(2 * pi * (julianday + 10.0)/365.25);
-    sig *= pi / 180.0;
-
-    for ( hour = 0; hour < 24; hour++ ) {
-      eta = (float) ((hour+1) - 12) * pi / 12.0;
-      sinbeta = sin(lambda)*sin(sig) + cos(lambda)*cos(sig)*cos(eta);
-      sotd = 1 - (0.016729 * cos(0.9856 * (julianday - 4.0)
-                                 * pi / 180.0));
-      sb = sp * sinbeta / pow((double)sotd,2.0);
-
-      if (sb >= 0.0) {
-        sumd += sb;
-      }
-    }
-
-    gross += sumd;
-  }
-
-  gross /= (float)DINM[im];
-  gross *= 0.484; // convert from cal/cm2day to W/m^2
-  return gross;
-}
-
 std::vector<float> calculate_daily_prec(const int midx, const float mta, const float mprec) {
                                   
   // input are monthly precipitation, monthly temperature
@@ -369,45 +316,118 @@ std::vector<float> calculate_daily_prec(const int midx, const float mta, const f
 
 
 
-Climate::Climate() {
+namespace {
+
+// co2 is not spatially explicit, so each co2 file is read once per process
+// and every cell is handed a copy of the same series.
+boost::mutex co2_mutex;
+std::map<std::string, std::vector<float> > co2_series;
+
+std::vector<float> shared_co2(const std::string& fname) {
+  boost::lock_guard<boost::mutex> lock(co2_mutex);
+
+  std::map<std::string, std::vector<float> >::const_iterator it = co2_series.find(fname);
+  if (it != co2_series.end()) {
+    return it->second;
+  }
+
+  // get_timeseries(..) takes the NetCDF lock for the read
+  std::vector<float> co2 = temutil::get_timeseries(fname, "co2");
+
+  co2_series[fname] = co2;
+  return co2;
+}
+
+// projected climate reads running ahead, see prefetch_proj_climate(..)
+const int MAX_PREFETCHES = 2;
+std::atomic<int> prefetches_in_flight(0);
+
+} // end anonymous namespace
+
+Climate::Climate(): cache_daily_forcing(true) {
   BOOST_LOG_SEV(glg, info) << "--> CLIMATE --> empty ctor";
 }
 
 
-Climate::Climate(const std::string& fname, const std::string& co2fname, int y, int x) {
+Climate::Climate(const std::string& fname, const std::string& co2fname, int y, int x,
+                 ClimateTileCache* tiles): cache_daily_forcing(true) {
   BOOST_LOG_SEV(glg, info) << "--> CLIMATE --> BETTER CTOR";
-  this->load_from_file(fname, y, x);
+  this->load_from_file(fname, y, x, tiles);
 
-  // co2 is not spatially explicit
-  #pragma omp critical(load_input)
-  {
-    this->co2 = temutil::get_timeseries(co2fname, "co2");
-  }
+  this->co2 = shared_co2(co2fname);
+}
+
+/** Loads the base climate timeseries for a cell and derives girr, cld and
+ *  par from it.
+ */
+void Climate::load_from_file(const std::string& fname, int y, int x,
+                             ClimateTileCache* tiles) {
+  this->set_series(read_series(fname, y, x, tiles));
 }
 
-void Climate::load_from_file(const std::string& fname, int y, int x) {
+/** Reads the base climate timeseries for a cell. With a tile cache the
+ *  data is copied out of a tile of rows held in memory, otherwise it is
+ *  read from the file for just this cell. Touches no Climate state, so it
+ *  can run on another thread.
+ */
+Climate::Series Climate::read_series(const std::string& fname, int y, int x,
+                                     ClimateTileCache* tiles) {
 
   if(!boost::filesystem::exists(fname)){
     BOOST_LOG_SEV(glg, fatal) << "Input file "<<fname<<" does not exist";
   }
 
-  #pragma omp critical(load_input)
-  {
+  Series s;
+
+  if (tiles) {
+    boost::shared_ptr<const ClimateTile> tile = tiles->get(fname, y);
+
+    BOOST_LOG_SEV(glg, info) << "Loading climate for (y, x) point: "
+                             << "(" << y <<","<< x <<") from a tile of "
+                             << fname;
+
+    tile->column("tair", y, x, s.tair);
+    tile->column("vapor_press", y, x, s.vapo);
+    tile->column("precip", y, x, s.prec);
+    tile->column("nirr", y, x, s.nirr);
+
+    s.start_year = tile->tseries_start_year;
+    s.end_year = tile->tseries_end_year;
+
+    s.latlon = tile->latlon(y, x);
+  }
+  else {
     BOOST_LOG_SEV(glg, info) << "Loading climate from file: " << fname;
     BOOST_LOG_SEV(glg, info) << "Loading climate for (y, x) point: "
                              << "(" << y <<","<< x <<"), all timesteps.";
 
     BOOST_LOG_SEV(glg, info) << "Read in the base climate data timeseries ...";
 
-    tair = temutil::get_timeseries<float>(fname, "tair", y, x);
-    vapo = temutil::get_timeseries<float>(fname, "vapor_press", y, x);
-    prec = temutil::get_timeseries<float>(fname, "precip", y, x);
-    nirr = temutil::get_timeseries<float>(fname, "nirr", y, x);
+    InputPass(fname, y, x).series("tair", s.tair)
+                          .series("vapor_press", s.vapo)
+                          .series("precip", s.prec)
+                          .series("nirr", s.nirr)
+                          .time_span(s.start_year, s.end_year)
+                          .latlon(s.latlon)
+                          .read();
+  }
 
-    tseries_start_year = temutil::get_timeseries_start_year(fname);
-    tseries_end_year = temutil::get_timeseries_end_year(fname);
+  return s;
+}
+
+/** Takes over a series read by read_series(..) and derives girr, cld and
+ *  par from it.
+ */
+void Climate::set_series(const Series& s) {
+  daily_forcing_cache.clear();
+
+  tair = s.tair;
+  vapo = s.vapo;
+  prec = s.prec;
+  nirr = s.nirr;
 
-  }//End critical(load_climate)
+  tseries_start_year = s.start_year;
+  tseries_end_year = s.end_year;
 
   // Report on sizes...
   BOOST_LOG_SEV(glg, info) << "  -->sizes (tair, vapor_press, precip, nirr): ("
@@ -432,12 +452,13 @@ void Climate::load_from_file(const std::string& fname, int y, int x) {
   BOOST_LOG_SEV(glg, debug) << "tair = [" << temutil::vec2csv(tair) << "]";
   BOOST_LOG_SEV(glg, debug) << "prec = [" << temutil::vec2csv(prec) << "]";
 
-  // find girr as a function of month and latitude
-  std::pair<float, float> latlon = temutil::get_latlon(fname, y, x);
-  for (int im = 0; im < 12; ++im) {
-    float g = calculate_girr(latlon.first, im);
-    girr[im] = g;
+  // find girr as a function of month and latitude, from the table shared
+  // by all the cells at this latitude. The projected climate is for the
+  // same cell, so the table from the historic climate is usually kept.
+  if (!solar || solar->lat != s.latlon.first) {
+    solar = SolarGeometry::at_latitude(s.latlon.first);
   }
+  girr.assign(solar->girr, solar->girr + MINY);
   BOOST_LOG_SEV(glg, debug) << "nirr = [" << temutil::vec2csv(nirr) << "]";
   BOOST_LOG_SEV(glg, debug) << "girr = [" << temutil::vec2csv(girr) << "]";
 
@@ -504,6 +525,8 @@ void Climate::prep_avg_climate(){
     exit(EXIT_FAILURE);
   }
 
+  daily_forcing_cache.clear();
+
   avgX_tair = avg_over(tair, baseline_start, baseline_end);
   avgX_prec = avg_over(prec, baseline_start, baseline_end);
   avgX_nirr = avg_over(nirr, baseline_start, baseline_end);
@@ -512,14 +535,58 @@ void Climate::prep_avg_climate(){
 
 
 /** This loads data from a projected climate data file, overwriting any old climate data*/
-void Climate::load_proj_climate(const std::string& fname, int y, int x){
+void Climate::load_proj_climate(const std::string& fname, int y, int x,
+                                ClimateTileCache* tiles){
   BOOST_LOG_SEV(glg, info) << "Climate, loading projected data";
 
-  this->load_from_file(fname, y, x);
+  if (proj_prefetch.valid() && proj_prefetch_fname == fname) {
+    BOOST_LOG_SEV(glg, debug) << "Using projected climate read ahead from " << fname;
+    Series s = proj_prefetch.get(); // waits if the read is still going
+    proj_prefetch = std::shared_future<Series>();
+    this->set_series(s);
+  } else {
+    this->load_from_file(fname, y, x, tiles);
+  }
+}
+
+/** Reads the projected climate for a cell on a separate thread, typically
+ *  started at the beginning of TR so the read overlaps the TR years rather
+ *  than holding up the switch to SC. The read takes the NetCDF lock like
+ *  any other, so it is serialized with the model threads and the output
+ *  writer. Since the reads queue on that lock anyway, only a few are kept
+ *  in flight; a cell that finds them all busy, or that can't start a
+ *  thread, simply reads when load_proj_climate(..) is called.
+ */
+void Climate::prefetch_proj_climate(const std::string& fname, int y, int x,
+                                    ClimateTileCache* tiles){
+  proj_prefetch = std::shared_future<Series>();
+
+  if (++prefetches_in_flight > MAX_PREFETCHES) {
+    --prefetches_in_flight;
+    BOOST_LOG_SEV(glg, debug) << "Not reading projected climate ahead, "
+                              << MAX_PREFETCHES << " reads already in flight";
+    return;
+  }
+
+  try {
+    proj_prefetch = std::async(std::launch::async, [fname, y, x, tiles]() {
+      struct Done {
+        ~Done() { --prefetches_in_flight; }
+      } done;
+      return read_series(fname, y, x, tiles);
+    }).share();
+    proj_prefetch_fname = fname;
+  } catch (const std::system_error& e) {
+    --prefetches_in_flight;
+    BOOST_LOG_SEV(glg, warn) << "Unable to read projected climate ahead: "
+                             << e.what();
+  }
 }
+
 void Climate::load_proj_co2(const std::string& fname){
   BOOST_LOG_SEV(glg, info) << "CO2, loading projected data!";
-  this->co2 = temutil::get_timeseries(fname, "co2");
+  this->co2 = shared_co2(fname);
+  daily_forcing_cache.clear();
 }
 
 std::vector<float> Climate::avg_over(const std::vector<float> & var, const int start_yr, const int end_yr) {
@@ -559,108 +626,174 @@ std::vector<float> Climate::avg_over(const std::vector<float> & var, const int s
 }
 
 
-// Interpolate from monthly values to daily. Does NOT account for leap years!
-std::vector<float> Climate::monthly2daily(const std::vector<float>& mly_vals) {
+namespace {
 
-  // setup a container for the daily data
-  std::vector<float> daily_container;
+// Month midpoints as days from Jan 1, for D J F M A M J J A S O N D J
+const float MID_DAYS[14] = { -15.5, 15.5, 45.0, 74.5, 105.0,
+                             135.5, 166, 196.5, 227.5, 258, 288.5,
+                             319, 349.5, 380.5 };
 
-  // set up the "month midpoint to relative days" vector
-  static const float arr[] = { -15.5, 15.5, 45.0, 74.5, 105.0,
-                                135.5, 166, 196.5, 227.5, 258, 288.5,
-                                319, 349.5, 380.5 };
-  std::vector<float> rel_days;
-  rel_days.assign( arr, arr + sizeof(arr) / sizeof(arr[0]) );
+// Days filled by monthly2daily(): day 0 (Jan 1) through day 365
+const int DAILY_LEN = 366;
 
-  assert(mly_vals.size() == 14 && "Monthly values must be size 14 (D J F M A M J J A S O N D J)");
-  assert(rel_days.size() == 14 && "Relative days vector must be size 14: (D J F M A M J J A S O N D J)");
+} // end anonymous namespace
 
-  for (std::vector<float>::iterator it = rel_days.begin()+1; it != rel_days.end(); ++it) {
-    int idx = it - rel_days.begin();
+/** Interpolate from monthly values to daily. Does NOT account for leap years!
+ *
+ *  'mly_vals' are the 14 values D J F M A M J J A S O N D J (see eq_range()
+ *  and interpolation_range()). Day x of the year lies on the line between
+ *  the midpoints of the months either side of it and is (m*x)+b, with m and
+ *  b from temutil::line(), as temutil::resample() would give. 'daily' is
+ *  resized only the first time and is then written in place; each month's
+ *  days are a contiguous run with one m and b.
+ */
+void Climate::monthly2daily(const float mly_vals[14], std::vector<float>& daily) {
 
-    // find our range to work over
-    float x0 = *(it-1);
-    float x1 = *it;
+  // TODO: Probably need to fix this? mostly works, but gives 366 values,
+  // even on non-leap years. Also when plotting, there appears to be a
+  // slight discontinutiy in the interpolation from month to month
+  daily.resize(DAILY_LEN);
+  float* out = &daily[0];
 
-    std::vector<float> psd = temutil::resample(
-        std::make_pair( x0, mly_vals.at(idx-1) ),   // first point on line
-        std::make_pair( x1, mly_vals.at(idx) ),                // second point on line
-        int(floor(x0)),     // begining of interval to interpolate
-        int(floor(x1)),     // end of iterval to interpolate
-        1                   // step size
-    );
+  for (int idx = 1; idx < 14; ++idx) {
+    float x0 = MID_DAYS[idx-1];
+    float x1 = MID_DAYS[idx];
 
-    // Add this month's interpolated values to the back of the
-    // temporary storage...
-    daily_container.insert(daily_container.end(), psd.begin(), psd.end());
-  }
+    std::pair<float, float> mb = temutil::line(
+        std::make_pair( x0, mly_vals[idx-1] ),  // first point on line
+        std::make_pair( x1, mly_vals[idx] )     // second point on line
+    );
+    float m = mb.first;
+    float b = mb.second;
 
-  // TODO: Probably need to fix this? mostly works, but returns a container
-  // that has 366 elements, even on non-leap years. Also when plotting, there
-  // appears to be a slight discontinutiy in the interpolation from month to month
-  std::vector<float> cal_yr_daily(daily_container.begin()+16, daily_container.end()-14);
+    // this month's days, clipped to the calendar year
+    int begin = std::max(int(floor(x0)), 0);
+    int end = std::min(int(floor(x1)), DAILY_LEN);
 
-  return cal_yr_daily;
+    for (int x = begin; x < end; ++x) {
+      out[x] = temutil::point_on_line(m, float(x), b);
+    }
+  }
 }
 
-// rough draft method to get "prev" Dec, this year, and "next" Jan that are
-// needed for monthly2daily interpolation...
-std::vector<float> Climate::eq_range(const std::vector<float>& data) {
-  std::vector<float> foo;
+// get "prev" Dec, this year, and "next" Jan that are needed for
+// monthly2daily interpolation...
+void Climate::eq_range(const std::vector<float>& data, float range[14]) {
 
   // recycle Dec as the "previous" Dec
-  foo.push_back(data.at(11));
+  range[0] = data.at(11);
 
   // get Jan - Dec values
-  foo.insert(foo.end(), data.begin(), data.begin()+12);
+  std::copy(data.begin(), data.begin()+12, range+1);
 
   // use this Jan as "next" Jan
-  foo.push_back(data.at(0));
-
-  return foo;
+  range[13] = data.at(0);
 }
 
-/** Method to build a vector of 14 monthly data points for interpolation.
+/** Method to fill the 14 monthly data points for interpolation.
 * In order to interpolate out to the ends of the year, you need the 12 months
 * of data, plus the preceeding Dec and following Jan.
 */
-std::vector<float> Climate::interpolation_range(const std::vector<float>& data, int year){
-  //BOOST_LOG_SEV(glg, fatal) << "interpolation_range, year: "<<year;
-
-  std::vector<float> foo;
+void Climate::interpolation_range(const std::vector<float>& data, int year,
+                                  float range[14]){
 
   int curr_jan = year*12;
 
   // Copy in previous Dec, unless in year 0
   if(year==0){
-    foo.push_back(data.at(11));
+    range[0] = data.at(11);
   }
   else{
-    foo.push_back(data.at(curr_jan-1));
+    range[0] = data.at(curr_jan-1);
   }
 
   // Get Jan - Dec values
-  foo.insert(foo.end(), &data[curr_jan], &data[curr_jan+12]);
+  std::copy(&data[curr_jan], &data[curr_jan+12], range+1);
 
   // Copy in next Jan, unless it is the last year's worth of data
   if(year == data.size()/12-1){
-    foo.push_back(data.at(curr_jan));
+    range[13] = data.at(curr_jan);
   }
   else{
-    foo.push_back(data.at(curr_jan+13));
+    range[13] = data.at(curr_jan+13);
   }
-
-  return foo;
 }
 
 
 /** Prepares a single year of daily driving data. 
 * 
-* iy is the run's index year, not the calendar year!
+* iy is the run's index year, not the calendar year! For SP it is the year
+* within the repeated cycle.
 * stage is a 2 letter code for the run stage, one of: pr, eq, sp, tr, sc.
+*
+* PR and EQ derive the same year every time, from the averaged climate,
+* and SP goes round the same cycle of years, so unless cache_daily_forcing
+* is off each of those years is derived once and copied after that. The
+* copy is exactly what deriving it again would give. TR and SC years are
+* never repeated, so they are always derived, and the first of them drops
+* the cache.
 */
 void Climate::prepare_daily_driving_data(int iy, const std::string& stage) {
 
+  bool eq_or_pr = (stage.find("pre") != std::string::npos)
+                  || (stage.find("eq") != std::string::npos);
+  bool cacheable = eq_or_pr || (stage.find("sp") != std::string::npos);
+  int cache_key = eq_or_pr ? -1 : iy;
+
+  if (!cacheable) {
+    daily_forcing_cache.clear();
+  }
+  else if (cache_daily_forcing) {
+    std::map<int, DailyForcing>::const_iterator it = daily_forcing_cache.find(cache_key);
+    if (it != daily_forcing_cache.end()) {
+      restore_daily_forcing(it->second);
+      return;
+    }
+  }
+
+  derive_daily_driving_data(iy, stage);
+
+  if (cacheable && cache_daily_forcing) {
+    save_daily_forcing(daily_forcing_cache[cache_key]);
+  }
+}
+
+void Climate::save_daily_forcing(DailyForcing& f) const {
+  f.co2_d = co2_d;
+  f.tair_d = tair_d;
+  f.prec_d = prec_d;
+  f.nirr_d = nirr_d;
+  f.vapo_d = vapo_d;
+  f.rain_d = rain_d;
+  f.snow_d = snow_d;
+  f.girr_d = girr_d;
+  f.cld_d = cld_d;
+  f.par_d = par_d;
+  f.svp_d = svp_d;
+  f.vpd_d = vpd_d;
+}
+
+void Climate::restore_daily_forcing(const DailyForcing& f) {
+  co2_d = f.co2_d;
+  tair_d = f.tair_d;
+  prec_d = f.prec_d;
+  nirr_d = f.nirr_d;
+  vapo_d = f.vapo_d;
+  rain_d = f.rain_d;
+  snow_d = f.snow_d;
+  girr_d = f.girr_d;
+  cld_d = f.cld_d;
+  par_d = f.par_d;
+  svp_d = f.svp_d;
+  vpd_d = f.vpd_d;
+}
+
+/** Derives one year of daily driving data from the monthly climate. */
+void Climate::derive_daily_driving_data(int iy, const std::string& stage) {
+
+  // D J F M A M J J A S O N D J values of the variable being interpolated
+  float range[14];
+
   if( (stage.find("pre") != std::string::npos)
       || (stage.find("eq") != std::string::npos) ){
 
@@ -669,12 +802,16 @@ void Climate::prepare_daily_driving_data(int iy, const std::string& stage) {
     co2_d = co2.at(0);
 
     // Create daily data by interpolating
-    tair_d = monthly2daily(eq_range(avgX_tair));
-    vapo_d = monthly2daily(eq_range(avgX_vapo));
-    nirr_d = monthly2daily(eq_range(avgX_nirr));
+    eq_range(avgX_tair, range);
+    monthly2daily(range, tair_d);
+    eq_range(avgX_vapo, range);
+    monthly2daily(range, vapo_d);
+    eq_range(avgX_nirr, range);
+    monthly2daily(range, nirr_d);
 
     // Not totally sure if this is right to interpolate (girr and par) 
-    par_d = monthly2daily(eq_range(par));
+    eq_range(par, range);
+    monthly2daily(range, par_d);
 
   } else {
 
@@ -684,19 +821,24 @@ void Climate::prepare_daily_driving_data(int iy, const std::string& stage) {
 
     // Create daily data by interpolating
     // straight up interpolated....
-    tair_d = monthly2daily(interpolation_range(tair, iy));
-    vapo_d = monthly2daily(interpolation_range(vapo, iy));
-    nirr_d = monthly2daily(interpolation_range(nirr, iy));
+    interpolation_range(tair, iy, range);
+    monthly2daily(range, tair_d);
+    interpolation_range(vapo, iy, range);
+    monthly2daily(range, vapo_d);
+    interpolation_range(nirr, iy, range);
+    monthly2daily(range, nirr_d);
 
     // Not totally sure if this is right to interpolate (girr and par) 
-    par_d = monthly2daily(interpolation_range(par, iy));
+    interpolation_range(par, iy, range);
+    monthly2daily(range, par_d);
   }
 
   //BOOST_LOG_SEV(glg, debug) << stage << " tair_d = [" << temutil::vec2csv(tair_d) << "]";
 
   // Not totally sure if this is right to interpolate (girr and par)
   // GIRR is passed to eq_range for all stages as it has only twelve values.
-  girr_d = monthly2daily(eq_range(girr));
+  eq_range(girr, range);
+  monthly2daily(range, girr_d);
 
   // The interpolation is slightly broken, so it 'overshoots' when the
   // slope is negative, and can result in negative values.
@@ -0,0 +1,212 @@
+/*  ClimateTile.cpp
+ *
+ *  Climate input read a block of rows at a time. See ClimateTile.h
+ */
+
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+
+#include <netcdf.h>
+
+#include "../include/ClimateTile.h"
+#include "../include/TEMUtilityFunctions.h"
+#include "../include/TEMLogger.h"
+
+extern src::severity_logger< severity_level > glg;
+
+namespace {
+
+// The variables read from a climate file, by their names in the file
+const char* tile_vars[] = { "tair", "vapor_press", "precip", "nirr" };
+const int tile_var_count = 4;
+
+} // end anonymous namespace
+
+
+/** Reads every climate variable for (all time, the given rows, all
+ *  columns), along with lat and lon for those rows.
+ */
+ClimateTile::ClimateTile(const std::string& fname, int first_row, int row_count):
+    first_row(first_row), row_count(row_count), num_cols(0), time_len(0) {
+
+  {
+    temutil::NetCDFLock lock(temutil::netcdf_mutex());
+    BOOST_LOG_SEV(glg, info) << "Loading climate tile from " << fname << ", rows "
+                             << first_row << " to " << first_row + row_count - 1;
+
+    // The years come from the time variable's units and last value
+    tseries_start_year = temutil::get_timeseries_start_year(fname);
+    tseries_end_year = temutil::get_timeseries_end_year(fname);
+
+    int ncid;
+    temutil::nc( nc_open(fname.c_str(), NC_NOWRITE, &ncid), fname );
+
+    int timeD, xD;
+    size_t timeD_len, xD_len;
+    temutil::nc( nc_inq_dimid(ncid, "time", &timeD) );
+    temutil::nc( nc_inq_dimlen(ncid, timeD, &timeD_len) );
+    temutil::nc( nc_inq_dimid(ncid, "X", &xD) );
+    temutil::nc( nc_inq_dimlen(ncid, xD, &xD_len) );
+
+    time_len = timeD_len;
+    num_cols = xD_len;
+
+    size_t start[3] = { 0, (size_t)first_row, 0 };
+    size_t count[3] = { timeD_len, (size_t)row_count, xD_len };
+
+    for (int iv=0; iv<tile_var_count; iv++) {
+      int varid;
+      temutil::nc( nc_inq_varid(ncid, tile_vars[iv], &varid) );
+      std::vector<float>& values = data[tile_vars[iv]];
+      values.resize(timeD_len * row_count * xD_len);
+      temutil::nc( nc_get_vara_float(ncid, varid, start, count, &values[0]) );
+    }
+
+    int latV, lonV;
+    temutil::nc( nc_inq_varid(ncid, "lat", &latV) );
+    temutil::nc( nc_inq_varid(ncid, "lon", &lonV) );
+    lat.resize(row_count * xD_len);
+    lon.resize(row_count * xD_len);
+    temutil::nc( nc_get_vara_float(ncid, latV, &start[1], &count[1], &lat[0]) );
+    temutil::nc( nc_get_vara_float(ncid, lonV, &start[1], &count[1], &lon[0]) );
+
+    temutil::nc( nc_close(ncid) );
+  }//End NetCDF lock
+}
+
+/** Copy the timeseries of one variable for a single cell. */
+void ClimateTile::column(const std::string& var, int y, int x, std::vector<float>& out) const {
+
+  std::map<std::string, std::vector<float> >::const_iterator itr = data.find(var);
+  if (itr == data.end()) {
+    throw std::runtime_error("Climate variable is not held in tiles: " + var);
+  }
+
+  const float* values = &itr->second[(y - first_row) * num_cols + x];
+  size_t stride = row_count * num_cols;
+
+  out.resize(time_len);
+  for (int it=0; it<time_len; it++) {
+    out[it] = values[it * stride];
+  }
+}
+
+std::pair<float, float> ClimateTile::latlon(int y, int x) const {
+  int idx = (y - first_row) * num_cols + x;
+  return std::pair<float, float>(lat[idx], lon[idx]);
+}
+
+size_t ClimateTile::size_in_bytes() const {
+  size_t bytes = (lat.size() + lon.size()) * sizeof(float);
+  std::map<std::string, std::vector<float> >::const_iterator itr;
+  for (itr = data.begin(); itr != data.end(); ++itr) {
+    bytes += itr->second.size() * sizeof(float);
+  }
+  return bytes;
+}
+
+/** The chunk length along Y of a variable, or 1 if it is not chunked. */
+int ClimateTile::chunk_rows(const std::string& fname, const std::string& var) {
+
+  int rows = 1;
+
+  {
+    temutil::NetCDFLock lock(temutil::netcdf_mutex());
+    int ncid;
+    temutil::nc( nc_open(fname.c_str(), NC_NOWRITE, &ncid), fname );
+
+    int varid, ndims;
+    temutil::nc( nc_inq_varid(ncid, var.c_str(), &varid) );
+    temutil::nc( nc_inq_varndims(ncid, varid, &ndims) );
+
+    int storage;
+    std::vector<size_t> chunks(ndims);
+    temutil::nc( nc_inq_var_chunking(ncid, varid, &storage, &chunks[0]) );
+    if (storage == NC_CHUNKED && ndims == 3) {
+      rows = chunks[1];
+    }
+
+    temutil::nc( nc_close(ncid) );
+  }//End NetCDF lock
+
+  return rows;
+}
+
+
+ClimateTileCache::ClimateTileCache(int tile_rows, int capacity):
+    tile_rows(tile_rows), capacity(capacity), lookups(0), loads(0) {
+  if (this->tile_rows < 1) {
+    this->tile_rows = 1;
+  }
+  if (this->capacity < 1) {
+    this->capacity = 1;
+  }
+}
+
+/** Returns the tile holding row y of the given file, reading it if it is
+ *  not already held. When the cache is full the least recently used tile
+ *  is dropped; cells that still hold a pointer to it keep it alive.
+ *
+ *  A tile is read with the cache locked, so threads that want a tile
+ *  that is being read wait for it instead of reading it again.
+ */
+boost::shared_ptr<const ClimateTile> ClimateTileCache::get(const std::string& fname, int y) {
+
+  boost::lock_guard<boost::mutex> lock(cache_mutex);
+
+  lookups++;
+
+  std::pair<std::string, int> key(fname, y / tile_rows);
+  std::map<std::pair<std::string, int>, Entry>::iterator itr = tiles.find(key);
+  if (itr != tiles.end()) {
+    itr->second.last_used = lookups;
+    return itr->second.tile;
+  }
+
+  if ((int)tiles.size() >= capacity) {
+    std::map<std::pair<std::string, int>, Entry>::iterator oldest = tiles.begin();
+    for (itr = tiles.begin(); itr != tiles.end(); ++itr) {
+      if (itr->second.last_used < oldest->second.last_used) {
+        oldest = itr;
+      }
+    }
+    BOOST_LOG_SEV(glg, debug) << "Dropping climate tile " << oldest->first.second
+                              << " of " << oldest->first.first;
+    tiles.erase(oldest);
+  }
+
+  // The last tile can be short
+  int first_row = key.second * tile_rows;
+  int num_rows;
+  {
+    temutil::NetCDFLock lock(temutil::netcdf_mutex());
+    int ncid, yD;
+    size_t yD_len;
+    temutil::nc( nc_open(fname.c_str(), NC_NOWRITE, &ncid), fname );
+    temutil::nc( nc_inq_dimid(ncid, "Y", &yD) );
+    temutil::nc( nc_inq_dimlen(ncid, yD, &yD_len) );
+    temutil::nc( nc_close(ncid) );
+    num_rows = yD_len;
+  }//End NetCDF lock
+  int row_count = std::min(tile_rows, num_rows - first_row);
+
+  Entry entry;
+  entry.tile.reset(new ClimateTile(fname, first_row, row_count));
+  entry.last_used = lookups;
+  tiles[key] = entry;
+  loads++;
+
+  BOOST_LOG_SEV(glg, info) << "Climate tile holds " << entry.tile->size_in_bytes() / (1024.0 * 1024.0)
+                           << " MiB.";
+
+  return entry.tile;
+}
+
+std::string ClimateTileCache::stats_report() {
+  boost::lock_guard<boost::mutex> lock(cache_mutex);
+  std::stringstream s;
+  s << "Climate tiles: " << loads << " tiles of " << tile_rows << " rows read for "
+    << lookups << " cell loads.";
+  return s.str();
+}
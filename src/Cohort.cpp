@@ -22,6 +22,7 @@
 
 #include "../include/TEMLogger.h"
 #include "../include/TEMUtilityFunctions.h"
+#include "../include/InputFiles.h"
 
 #include "../include/Cohort.h"
 
@@ -37,9 +38,11 @@ Cohort::Cohort(int y, int x, ModelData* modeldatapointer):
   BOOST_LOG_SEV(glg, info) << "Cohort constructor NEW STYLE!";
   
   BOOST_LOG_SEV(glg, info) << "Looking up and setting lat/lon for cohort...";
-  std::pair<float, float> latlon = temutil::get_latlon(modeldatapointer->hist_climate_file, y, x);
+  std::pair<float, float> latlon;
+  InputPass(modeldatapointer->hist_climate_file, y, x).latlon(latlon).read();
   this->lat = latlon.first;
   this->lon = latlon.second;
+  this->solar = SolarGeometry::at_latitude(this->lat);
 
   BOOST_LOG_SEV(glg, info) << "Make a CohortData...";
   this->cd = CohortData(); // empty? / uninitialized? / undefined? values...
@@ -47,12 +50,13 @@ Cohort::Cohort(int y, int x, ModelData* modeldatapointer):
   if (modeldatapointer->force_cmt >= 0) {
     this->cd.cmttype = modeldatapointer->force_cmt;
   } else {
-    this->cd.cmttype = temutil::get_veg_class(modeldatapointer->veg_class_file, y, x);
+    InputPass(modeldatapointer->veg_class_file, y, x).scalar("veg_class", this->cd.cmttype).read();
   }
-  this->cd.drainage_type = temutil::get_drainage_class(modeldatapointer->drainage_file, y, x);
-  this->cd.cell_slope = temutil::get_scalar<double>(modeldatapointer->topo_file, "slope", y, x);
-  this->cd.cell_aspect = temutil::get_scalar<double>(modeldatapointer->topo_file, "aspect", y, x);
-  this->cd.cell_elevation = temutil::get_scalar<double>(modeldatapointer->topo_file, "elevation", y, x);
+  InputPass(modeldatapointer->drainage_file, y, x).scalar("drainage_class", this->cd.drainage_type).read();
+  InputPass(modeldatapointer->topo_file, y, x).scalar("slope", this->cd.cell_slope)
+                                              .scalar("aspect", this->cd.cell_aspect)
+                                              .scalar("elevation", this->cd.cell_elevation)
+                                              .read();
 
   BOOST_LOG_SEV(glg, info) << "Next, we build a CohortLookup object, properly configured with parameter directory and community type.";
   this->chtlu = CohortLookup( modeldatapointer->parameter_dir, temutil::cmtnum2str(cd.cmttype) );
@@ -67,8 +71,10 @@ Cohort::Cohort(int y, int x, ModelData* modeldatapointer):
 
   //On construction we assume historic climate, which will be
   // overwritten by projected climate later when necessary.
-  this->climate = Climate(modeldatapointer->hist_climate_file, modeldatapointer->co2_file, y, x);
+  this->climate = Climate(modeldatapointer->hist_climate_file, modeldatapointer->co2_file, y, x,
+                          modeldatapointer->climate_tiles);
 
+  this->climate.cache_daily_forcing = modeldatapointer->cache_daily_forcing;
   this->climate.baseline_start = modeldatapointer->baseline_start;
   this->climate.baseline_end = modeldatapointer->baseline_end;
   //Prepare averaged input set for EQ stage
@@ -136,7 +142,11 @@ void Cohort::load_proj_explicit_fire(const std::string& proj_exp_fire_file){
 
 /** Provides necessary data to Climate for loading projected climate data*/
 void Cohort::load_proj_climate(const std::string& proj_climate_file){
-  climate.load_proj_climate(proj_climate_file, y, x);
+  climate.load_proj_climate(proj_climate_file, y, x, md->climate_tiles);
+}
+
+void Cohort::prefetch_proj_climate(const std::string& proj_climate_file){
+  climate.prefetch_proj_climate(proj_climate_file, y, x, md->climate_tiles);
 }
 
 void Cohort::load_proj_co2(const std::string& proj_co2_file){
@@ -485,7 +495,7 @@ void Cohort::updateMonthly_Env(const int & currmind, const int & dinmcurr) {
                               << " id=" << id
                               << " doy=" << doy << ground.layer_report_string("depth thermal hydro ptr");
 
-    daylength = temutil::length_of_day(this->lat, doy);
+    daylength = solar->daylength[doy];
 
     //Kade 2006 found summer nfactors of 1.17-1.24 for undisturbed tundra
     // and winter nfactors ~0.38-0.57 (for soil, not snow)
@@ -713,11 +723,22 @@ void Cohort::updateMonthly_Bgc(const int & currmind) {
     bdall->land_beginOfYear();
   }
 
-  // vegetation BGC module calling
+  // vegetation BGC module calling. The PFTs are independent of each
+  // other here, so all of them are integrated together in one batch.
+  Integrator * veglanes[NUM_PFT];
+  int numlanes = 0;
+
   for (int ip=0; ip<NUM_PFT; ip++) {
     if (cd.m_veg.vegcov[ip]>0.) {
       vegbgc[ip].prepareIntegration(md->get_nfeed());
-      vegintegrator[ip].updateMonthlyVbgc();
+      veglanes[numlanes++] = &vegintegrator[ip];
+    }
+  }
+
+  vegbatch.updateMonthlyVbgc(veglanes, numlanes);
+
+  for (int ip=0; ip<NUM_PFT; ip++) {
+    if (cd.m_veg.vegcov[ip]>0.) {
       vegbgc[ip].afterIntegration();
       bd[ip].veg_endOfMonth(currmind); // yearly data accumulation
 
@@ -6,6 +6,12 @@
 #include <fstream>
 #include <vector> 
 #include <list>
+#include <algorithm>
+#include <iterator>
+#include <cstring>
+#include <stdexcept>
+
+#include <boost/filesystem.hpp>
 
 #include "../include/TEMLogger.h"
 
@@ -19,21 +25,15 @@ CohortLookup::CohortLookup() {
   cmtcode = "CMT00"; // the default community code (5 alphnumerics)
 };
 
-/** New constructor...*/
-CohortLookup::CohortLookup(std::string directory, std::string code) :
-    dir(directory), cmtcode(code)  {
-
-  BOOST_LOG_SEV(glg, info) << "Building a CohortLookup: set directory, "
-                           << "community type, then read " << dir << "/* files "
-                           << "and set data members.";
-  assignBgcCalpar(this->dir);
-  assignVegDimension(this->dir);
-  assignGroundDimension(this->dir);
-  assignEnv4Canopy(this->dir);
-  assignBgc4Vegetation(this->dir);
-  assignEnv4Ground(this->dir);
-  assignBgc4Ground(this->dir);
-  assignFirePar(this->dir);
+/** New constructor. The parameter files are only parsed the first time a
+ *  community type is asked for; after that the values are copied from the
+ *  cached lookup.
+ */
+CohortLookup::CohortLookup(std::string directory, std::string code) {
+
+  BOOST_LOG_SEV(glg, info) << "Building a CohortLookup for community type "
+                           << code << " from the parameters in " << directory;
+  *this = *CohortLookup::cached(directory, code);
 
 };
 
@@ -51,6 +51,413 @@ void CohortLookup::init() {
   assignFirePar(dir);
 }
 
+namespace {
+
+// The text files a compiled parameter file is built from
+const char* parameter_files[] = {
+  "cmt_calparbgc.txt", "cmt_dimvegetation.txt", "cmt_dimground.txt",
+  "cmt_envcanopy.txt", "cmt_bgcvegetation.txt", "cmt_envground.txt",
+  "cmt_bgcsoil.txt", "cmt_firepar.txt"
+};
+const int parameter_file_count = 8;
+
+// Bump when the layout of the compiled file changes in a way the layout
+// hash wouldn't catch
+const unsigned int COMPILED_VERSION = 1;
+const char COMPILED_MAGIC[8] = { 'D', 'V', 'M', 'P', 'A', 'R', 'S', '\0' };
+
+// The compiled file is this header, followed by entry_count entries of
+// an 8 character community code and entry_bytes of parameter values.
+struct CompiledHeader {
+  char magic[8];
+  unsigned int version;
+  unsigned int layout_hash;
+  unsigned int entry_count;
+  unsigned int entry_bytes;
+};
+
+const size_t CODE_BYTES = 8;
+
+template<typename T>
+std::pair<char*, size_t> field(T& value) {
+  return std::pair<char*, size_t>(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+} // end anonymous namespace
+
+boost::mutex CohortLookup::cache_mutex;
+std::map<std::pair<std::string, std::string>,
+         boost::shared_ptr<const CohortLookup> > CohortLookup::cache;
+std::set<std::string> CohortLookup::compiled_checked;
+
+const std::string CohortLookup::COMPILED_FILE = "cmt_compiled.bin";
+
+/** Returns the lookup for a parameter directory and community type,
+ *  reading the parameter files if this is the first time it has been
+ *  asked for. The returned lookup is never modified; a cohort that needs
+ *  to change its parameters (calibration) works on its own copy.
+ *
+ *  Safe to call from any thread. Threads asking for a community type that
+ *  is being read wait for it rather than reading the files again.
+ */
+boost::shared_ptr<const CohortLookup> CohortLookup::cached(const std::string& directory,
+                                                           const std::string& code) {
+
+  boost::lock_guard<boost::mutex> lock(cache_mutex);
+
+  std::pair<std::string, std::string> key(directory, code);
+  std::map<std::pair<std::string, std::string>,
+           boost::shared_ptr<const CohortLookup> >::iterator itr = cache.find(key);
+  if (itr != cache.end()) {
+    return itr->second;
+  }
+
+  // The first time a directory is used, take every community type from
+  // its compiled file, if there is an up to date one
+  if (compiled_checked.count(directory) == 0) {
+    compiled_checked.insert(directory);
+    if (load_compiled(directory)) {
+      itr = cache.find(key);
+      if (itr != cache.end()) {
+        return itr->second;
+      }
+      BOOST_LOG_SEV(glg, warn) << code << " is not in " << directory << COMPILED_FILE
+                               << ". Reading it from the text files.";
+    }
+  }
+
+  BOOST_LOG_SEV(glg, info) << "Reading the parameters for " << code << " from "
+                           << directory << "/* files.";
+  boost::shared_ptr<CohortLookup> lu(new CohortLookup());
+  lu->dir = directory;
+  lu->cmtcode = code;
+  lu->init();
+
+  cache[key] = lu;
+  return lu;
+}
+
+/** Forget every cached lookup, so the next cohort built for a community
+ *  type reads the parameter files again. Cohorts that already exist keep
+ *  their own copies.
+ */
+void CohortLookup::clear_cache() {
+  boost::lock_guard<boost::mutex> lock(cache_mutex);
+  cache.clear();
+  compiled_checked.clear();
+}
+
+void CohortLookup::parameter_fields(std::vector<std::pair<char*, size_t> >& f) {
+  f.clear();
+  f.push_back(field(cmax));
+  f.push_back(field(nmax));
+  f.push_back(field(cfall));
+  f.push_back(field(nfall));
+  f.push_back(field(kra));
+  f.push_back(field(krb));
+  f.push_back(field(frg));
+  f.push_back(field(micbnup));
+  f.push_back(field(kdcrawc));
+  f.push_back(field(kdcsoma));
+  f.push_back(field(kdcsompr));
+  f.push_back(field(kdcsomcr));
+  f.push_back(field(sla));
+  f.push_back(field(klai));
+  f.push_back(field(vegcov));
+  f.push_back(field(initial_lai));
+  f.push_back(field(ifwoody));
+  f.push_back(field(ifdeciwoody));
+  f.push_back(field(ifperenial));
+  f.push_back(field(nonvascular));
+  f.push_back(field(static_lai));
+  f.push_back(field(frootfrac));
+  f.push_back(field(snwdenmax));
+  f.push_back(field(snwdennew));
+  f.push_back(field(initsnwthick));
+  f.push_back(field(initsnwdense));
+  f.push_back(field(maxdmossthick));
+  f.push_back(field(initdmossthick));
+  f.push_back(field(mosstype));
+  f.push_back(field(initfibthick));
+  f.push_back(field(inithumthick));
+  f.push_back(field(coefshlwa));
+  f.push_back(field(coefshlwb));
+  f.push_back(field(coefdeepa));
+  f.push_back(field(coefdeepb));
+  f.push_back(field(coefminea));
+  f.push_back(field(coefmineb));
+  f.push_back(field(rtdp4gdd));
+  f.push_back(field(albvisnir));
+  f.push_back(field(er));
+  f.push_back(field(ircoef));
+  f.push_back(field(iscoef));
+  f.push_back(field(glmax));
+  f.push_back(field(gl_bl));
+  f.push_back(field(gl_c));
+  f.push_back(field(vpd_open));
+  f.push_back(field(vpd_close));
+  f.push_back(field(ppfd50));
+  f.push_back(field(initvegwater));
+  f.push_back(field(initvegsnow));
+  f.push_back(field(snwalbmax));
+  f.push_back(field(snwalbmin));
+  f.push_back(field(psimax));
+  f.push_back(field(evapmin));
+  f.push_back(field(drainmax));
+  f.push_back(field(tcsolid_moss));
+  f.push_back(field(tcsolid_f));
+  f.push_back(field(tcsolid_h));
+  f.push_back(field(nfactor_s));
+  f.push_back(field(nfactor_w));
+  f.push_back(field(poro_moss));
+  f.push_back(field(poro_f));
+  f.push_back(field(poro_h));
+  f.push_back(field(bulkden_moss));
+  f.push_back(field(bulkden_f));
+  f.push_back(field(bulkden_h));
+  f.push_back(field(hksat_moss));
+  f.push_back(field(hksat_f));
+  f.push_back(field(hksat_h));
+  f.push_back(field(initsnwtem));
+  f.push_back(field(initvwc));
+  f.push_back(field(initts));
+  f.push_back(field(minleaf));
+  f.push_back(field(aleaf));
+  f.push_back(field(bleaf));
+  f.push_back(field(cleaf));
+  f.push_back(field(kfoliage));
+  f.push_back(field(cov));
+  f.push_back(field(m1));
+  f.push_back(field(m2));
+  f.push_back(field(m3));
+  f.push_back(field(m4));
+  f.push_back(field(kc));
+  f.push_back(field(ki));
+  f.push_back(field(tmin));
+  f.push_back(field(toptmin));
+  f.push_back(field(toptmax));
+  f.push_back(field(tmax));
+  f.push_back(field(raq10a0));
+  f.push_back(field(raq10a1));
+  f.push_back(field(raq10a2));
+  f.push_back(field(raq10a3));
+  f.push_back(field(knuptake));
+  f.push_back(field(cpart));
+  f.push_back(field(initc2neven));
+  f.push_back(field(c2nmin));
+  f.push_back(field(c2na));
+  f.push_back(field(c2nb));
+  f.push_back(field(labncon));
+  f.push_back(field(rhq10));
+  f.push_back(field(rhmoistfrozen));
+  f.push_back(field(moistmin));
+  f.push_back(field(moistopt));
+  f.push_back(field(moistmax));
+  f.push_back(field(lcclnc));
+  f.push_back(field(fsoma));
+  f.push_back(field(fsompr));
+  f.push_back(field(fsomcr));
+  f.push_back(field(som2co2));
+  f.push_back(field(kn2));
+  f.push_back(field(propftos));
+  f.push_back(field(nmincnsoil));
+  f.push_back(field(fnloss));
+  f.push_back(field(initvegc));
+  f.push_back(field(initvegn));
+  f.push_back(field(initdeadc));
+  f.push_back(field(initdeadn));
+  f.push_back(field(initdmossc));
+  f.push_back(field(initshlwc));
+  f.push_back(field(initdeepc));
+  f.push_back(field(initminec));
+  f.push_back(field(initsoln));
+  f.push_back(field(initavln));
+  f.push_back(field(fvcombust));
+  f.push_back(field(fvslash));
+  f.push_back(field(foslburn));
+  f.push_back(field(vsmburn));
+  f.push_back(field(r_retain_c));
+  f.push_back(field(r_retain_n));
+}
+
+/** A hash of the sizes of the parameter fields, so a compiled file written
+ *  by a build with different fields (or a different NUM_PFT) is refused.
+ */
+unsigned int CohortLookup::layout_hash() {
+  CohortLookup lu;
+  std::vector<std::pair<char*, size_t> > f;
+  lu.parameter_fields(f);
+
+  unsigned int hash = 2166136261u; // FNV-1a
+  for (unsigned int i = 0; i < f.size(); i++) {
+    hash = (hash ^ (unsigned int)f[i].second) * 16777619u;
+  }
+  return hash;
+}
+
+/** Reads every community type in a compiled parameter file into the cache.
+ *  Returns false, leaving the cache alone, if there is no compiled file,
+ *  if any of the text files is newer than it, or if it was written by a
+ *  different version. The caller holds cache_mutex.
+ */
+bool CohortLookup::load_compiled(const std::string& directory) {
+
+  namespace fs = boost::filesystem;
+
+  std::string fname = directory + COMPILED_FILE;
+  if (!fs::exists(fname)) {
+    return false;
+  }
+
+  std::time_t compiled_time = fs::last_write_time(fname);
+  for (int i = 0; i < parameter_file_count; i++) {
+    std::string source = directory + parameter_files[i];
+    if (fs::exists(source) && fs::last_write_time(source) > compiled_time) {
+      BOOST_LOG_SEV(glg, warn) << source << " is newer than " << fname << ". Ignoring "
+                               << "the compiled parameters; rerun with --compile-params.";
+      return false;
+    }
+  }
+
+  std::ifstream in(fname.c_str(), std::ios::in | std::ios::binary);
+  std::vector<char> buffer((std::istreambuf_iterator<char>(in)),
+                           std::istreambuf_iterator<char>());
+
+  CompiledHeader header;
+  std::vector<std::pair<char*, size_t> > f;
+  CohortLookup sizing;
+  sizing.parameter_fields(f);
+  size_t entry_bytes = 0;
+  for (unsigned int i = 0; i < f.size(); i++) {
+    entry_bytes += f[i].second;
+  }
+
+  if (buffer.size() < sizeof(header)) {
+    BOOST_LOG_SEV(glg, warn) << fname << " is truncated. Ignoring it.";
+    return false;
+  }
+  std::memcpy(&header, &buffer[0], sizeof(header));
+
+  if (std::memcmp(header.magic, COMPILED_MAGIC, sizeof(COMPILED_MAGIC)) != 0 ||
+      header.version != COMPILED_VERSION || header.layout_hash != layout_hash() ||
+      header.entry_bytes != entry_bytes) {
+    BOOST_LOG_SEV(glg, warn) << fname << " was not written by this version of "
+                             << "dvmdostem. Ignoring it; rerun with --compile-params.";
+    return false;
+  }
+  if (buffer.size() != sizeof(header) + header.entry_count * (CODE_BYTES + entry_bytes)) {
+    BOOST_LOG_SEV(glg, warn) << fname << " is the wrong size. Ignoring it.";
+    return false;
+  }
+
+  const char* p = &buffer[sizeof(header)];
+  for (unsigned int ie = 0; ie < header.entry_count; ie++) {
+    boost::shared_ptr<CohortLookup> lu(new CohortLookup());
+    lu->dir = directory;
+    lu->cmtcode = std::string(p, strnlen(p, CODE_BYTES));
+    p += CODE_BYTES;
+
+    lu->parameter_fields(f);
+    for (unsigned int i = 0; i < f.size(); i++) {
+      std::memcpy(f[i].first, p, f[i].second);
+      p += f[i].second;
+    }
+    cache[std::pair<std::string, std::string>(directory, lu->cmtcode)] = lu;
+  }
+
+  BOOST_LOG_SEV(glg, info) << "Loaded " << header.entry_count << " community types "
+                           << "from " << fname;
+  return true;
+}
+
+/** Parses and checks every community type in the parameter directory
+ *  (those listed in cmt_calparbgc.txt) and, if they are all good, writes
+ *  them to a compiled file in the same directory. Runs started after
+ *  that read the compiled file instead of the text files, for as long as
+ *  it is newer than all of them.
+ *
+ *  Returns the number of community types with problems, which are all
+ *  reported, rather than stopping at the first one.
+ */
+int CohortLookup::compile_parameters(const std::string& directory) {
+
+  std::string listing = directory + parameter_files[0];
+  std::ifstream par_file(listing.c_str(), std::ifstream::in);
+  if (!par_file.is_open()) {
+    BOOST_LOG_SEV(glg, fatal) << "Problem opening " << listing << "!";
+    return 1;
+  }
+
+  std::vector<std::string> codes;
+  for (std::string line; std::getline(par_file, line); ) {
+    if (line.find("CMT") != std::string::npos) {
+      std::string code = temutil::cmtnum2str(temutil::cmtcode2num(line));
+      if (std::find(codes.begin(), codes.end(), code) == codes.end()) {
+        codes.push_back(code);
+      }
+    }
+  }
+
+  int problems = 0;
+  std::vector<CohortLookup> lookups;
+  for (unsigned int ic = 0; ic < codes.size(); ic++) {
+    CohortLookup lu;
+    lu.dir = directory;
+    lu.cmtcode = codes[ic];
+    try {
+      lu.init();
+      lookups.push_back(lu);
+    } catch (std::exception& e) {
+      BOOST_LOG_SEV(glg, fatal) << "Problem with the parameters for " << codes[ic]
+                                << ": " << e.what();
+      problems++;
+    }
+  }
+
+  if (problems > 0) {
+    BOOST_LOG_SEV(glg, fatal) << problems << " of " << codes.size() << " community "
+                              << "types have problems. Not writing " << COMPILED_FILE;
+    return problems;
+  }
+
+  CompiledHeader header;
+  std::memcpy(header.magic, COMPILED_MAGIC, sizeof(COMPILED_MAGIC));
+  header.version = COMPILED_VERSION;
+  header.layout_hash = layout_hash();
+  header.entry_count = lookups.size();
+  header.entry_bytes = 0;
+
+  std::vector<std::pair<char*, size_t> > f;
+  CohortLookup sizing;
+  sizing.parameter_fields(f);
+  for (unsigned int i = 0; i < f.size(); i++) {
+    header.entry_bytes += f[i].second;
+  }
+
+  std::string fname = directory + COMPILED_FILE;
+  std::ofstream out(fname.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (unsigned int il = 0; il < lookups.size(); il++) {
+    char code[CODE_BYTES] = {0};
+    std::strncpy(code, lookups[il].cmtcode.c_str(), CODE_BYTES - 1);
+    out.write(code, CODE_BYTES);
+
+    lookups[il].parameter_fields(f);
+    for (unsigned int i = 0; i < f.size(); i++) {
+      out.write(f[i].first, f[i].second);
+    }
+  }
+  out.close();
+
+  if (!out) {
+    BOOST_LOG_SEV(glg, fatal) << "Problem writing " << fname << "!";
+    return 1;
+  }
+
+  BOOST_LOG_SEV(glg, info) << "Wrote " << lookups.size() << " community types to " << fname;
+  return 0;
+}
+
 /** Prints data from this-> fields mimics format of cmt_calparbgc.txt file,
  * but only for one cmt type which ever one "this->cmtcode" refers to..
  */
@@ -16,37 +16,27 @@ void CrankNicholson::geBackward(const int &startind, const int & endind,
                                 double e[], double & dt) {
   double condth;
   double conuth;
-  double denm;
-  double r;
   double rc;
-  double rhs;
-  //loop from last layer to first layer
-  int iu;
-  int id;
-  double sil;
-  double eil;
   //invert values to replace division with multiplication for speed
   //rar 20140503
   double dt_inv = 1 / dt;
   double denm_inv;
 
+  // diagonal and right hand side of each layer, independent of each other
+  for (int il = startind+1; il <= endind-1; il++) {
+    conuth = cn[il-1];
+    condth = cn[il] ;
+    rc = (cap[il] + cap[il-1]) * dt_inv;
+    diag[il] = conuth + rc + condth;
+    rhs[il] = (rc - conuth - condth) * t[il] + conuth* t[il-1] + condth * t[il+1];
+  }
+
+  //loop from last layer to first layer
   for (int il = endind-1 ; il>=startind+1; il--) {
-    iu =il-1;
-    id =il+1;
-    conuth = cn[iu];
     condth = cn[il] ;
-    rc = (cap[il] + cap[iu]) * dt_inv;
-    //rc = (cap[il] + cap[iu]) / dt;
-    r = conuth + rc + condth;
-    denm = r - condth * s[id];
-    denm_inv = 1 / denm;
-    rhs = (rc - conuth - condth) * t[il] + conuth* t[iu] + condth * t[id];
-    //sil = conuth / denm;
-    sil = conuth * denm_inv;
-    //eil = (rhs + condth * e[id]) / denm;
-    eil = (rhs + condth * e[id]) * denm_inv;
-    s[il] = sil;
-    e[il] = eil;
+    denm_inv = 1 / (diag[il] - condth * s[il+1]);
+    s[il] = cn[il-1] * denm_inv;
+    e[il] = (rhs[il] + condth * e[il+1]) * denm_inv;
   }
 }
 
@@ -56,33 +46,27 @@ void CrankNicholson::geForward(const int  &startind, const int & endind,
                                double & dt) {
   double condth;
   double conuth;
-  double denm;
-  double r;
   double rc;
-  double rhs;
-  int im1;
-  int ip1;
   //invert values to replace division with multiplication for speed
   //rar 20140503
   double dt_inv = 1 / dt;
   double denm_inv;
 
-  for (int il =startind+1 ; il<=endind-1; il++) {
-    im1 =il - 1;
-    ip1 =il + 1;
-    conuth = cn[im1];
+  // diagonal and right hand side of each layer, independent of each other
+  for (int il = startind+1; il <= endind-1; il++) {
+    conuth = cn[il-1];
     condth = cn[il] ;
-    rc = (cap[il] + cap[im1]) * dt_inv;
-    //rc = (cap[il] + cap[im1]) / dt;
-    r = conuth + rc + condth;
-    denm = r - conuth * s[im1];
-    denm_inv = 1 / denm;
-    rhs = (rc - conuth - condth) * t[il] + conuth
-          * t[im1] + condth * t[ip1];
-    //s[il] = condth / denm;
-    s[il] = condth * denm_inv;
-    //e[il] = (rhs + conuth * e[im1]) / denm;
-    e[il] = (rhs + conuth * e[im1]) * denm_inv;
+    rc = (cap[il] + cap[il-1]) * dt_inv;
+    diag[il] = conuth + rc + condth;
+    rhs[il] = (rc - conuth - condth) * t[il] + conuth
+              * t[il-1] + condth * t[il+1];
+  }
+
+  for (int il =startind+1 ; il<=endind-1; il++) {
+    conuth = cn[il-1];
+    denm_inv = 1 / (diag[il] - conuth * s[il-1]);
+    s[il] = cn[il] * denm_inv;
+    e[il] = (rhs[il] + conuth * e[il-1]) * denm_inv;
   }
 }
 
@@ -117,19 +101,15 @@ void CrankNicholson::tridiagonal(const int ind, const int numsl, double a[],
    * input: ind, numsl: first layer index, and total number of layers
    * output: u: change in volumetric water content per layer
    */
-  //placeholder for intermediate values
-  double gamma[ind+numsl];
   //set beta for use in first and second layers
   double beta = b[ind];
-  //forward pass
-  for(int ii = ind; ii < ind + numsl; ii++){
-    if(ii == ind){ //first layer
-      u[ii] = r[ii] / beta;
-    } else { //remaining layers
-      gamma[ii] = c[ii-1] / beta;
-      beta = b[ii] - a[ii] * gamma[ii]; //reset beta
-      u[ii] = (r[ii] - a[ii] * u[ii-1]) / beta;
-    }
+  //forward pass, first layer
+  u[ind] = r[ind] / beta;
+  //remaining layers
+  for(int ii = ind + 1; ii < ind + numsl; ii++){
+    gamma[ii] = c[ii-1] / beta;
+    beta = b[ii] - a[ii] * gamma[ii]; //reset beta
+    u[ii] = (r[ii] - a[ii] * u[ii-1]) / beta;
   }
   //backward pass, skips bottom layer
   for(int ii = ind + numsl - 2; ii >= ind; --ii){
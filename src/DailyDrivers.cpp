@@ -0,0 +1,220 @@
+/*  DailyDrivers.cpp
+ *
+ *  Reading and writing derived daily climate forcing. See DailyDrivers.h
+ */
+
+#include <vector>
+#include <algorithm>
+#include <sstream>
+#include <cstring>
+#include <stdexcept>
+
+#include <boost/filesystem.hpp>
+
+#include <netcdf.h>
+#ifdef WITHMPI
+#include <mpi.h>
+#include <netcdf_par.h>
+#endif
+
+#include "../include/DailyDrivers.h"
+#include "../include/Climate.h"
+#include "../include/ModelData.h"
+#include "../include/OutputSink.h"
+#include "../include/errorcode.h"
+#include "../include/TEMUtilityFunctions.h"
+#include "../include/TEMLogger.h"
+
+extern src::severity_logger< severity_level > glg;
+
+namespace {
+
+// Days in each year of the interpolated variables (see
+// Climate::monthly2daily) and of the ones built month by month
+const int INTERP_DAYS = 366;
+const int CAL_DAYS = 365;
+
+struct DriverVar {
+  const char* name;
+  std::vector<float> Climate::* container;
+  bool interpolated; // INTERP_DAYS long, otherwise CAL_DAYS
+  const char* long_name;
+};
+
+const DriverVar VARS[] = {
+  { "tair", &Climate::tair_d, true,  "air temperature" },
+  { "vapo", &Climate::vapo_d, true,  "vapor pressure" },
+  { "nirr", &Climate::nirr_d, true,  "incident solar radiation" },
+  { "par",  &Climate::par_d,  true,  "photosynthetically active radiation" },
+  { "girr", &Climate::girr_d, true,  "gross irradiance" },
+  { "svp",  &Climate::svp_d,  true,  "saturated vapor pressure" },
+  { "vpd",  &Climate::vpd_d,  true,  "vapor pressure deficit" },
+  { "cld",  &Climate::cld_d,  true,  "cloudiness" },
+  { "prec", &Climate::prec_d, false, "precipitation" },
+  { "rain", &Climate::rain_d, false, "rainfall" },
+  { "snow", &Climate::snow_d, false, "snowfall" }
+};
+const int NUM_VARS = sizeof(VARS) / sizeof(VARS[0]);
+
+int days_of(const DriverVar& var) {
+  return var.interpolated ? INTERP_DAYS : CAL_DAYS;
+}
+
+} // end anonymous namespace
+
+
+namespace DailyDrivers {
+
+std::string file_stage(const std::string& stage) {
+  if (stage.find("pre") != std::string::npos || stage.find("eq") != std::string::npos) {
+    return "eq";
+  } else if (stage.find("sp") != std::string::npos) {
+    return "sp";
+  } else if (stage.find("tr") != std::string::npos) {
+    return "tr";
+  } else if (stage.find("sc") != std::string::npos) {
+    return "sc";
+  }
+  throw std::runtime_error("No daily drivers file for stage: " + stage);
+}
+
+std::string filename(const std::string& dir, const std::string& stage) {
+  return dir + "daily_drivers_" + file_stage(stage) + ".nc";
+}
+
+int file_years(const ModelData& md, const std::string& file_stage) {
+  if (file_stage == "eq") {
+    return (md.pr_yrs > 0 || md.eq_yrs > 0) ? 1 : 0;
+  } else if (file_stage == "sp") {
+    //FIX - 30 should not be hardcoded (see Runner::run_year)
+    return std::min(md.sp_yrs, 30);
+  } else if (file_stage == "tr") {
+    return md.tr_yrs;
+  } else if (file_stage == "sc") {
+    return md.sc_yrs;
+  }
+  return 0;
+}
+
+int file_year(const std::string& file_stage, int climate_year) {
+  return (file_stage == "eq") ? 0 : climate_year;
+}
+
+void create_file(const std::string& fname, int nyears, int ysize, int xsize) {
+
+  BOOST_LOG_SEV(glg, debug) << "Creating new file: "<<fname<<" with 'NC_CLOBBER'";
+  int ncid;
+
+  temutil::NetCDFLock lock(temutil::netcdf_mutex());
+#ifdef WITHMPI
+  temutil::nc( nc_create_par(fname.c_str(), NC_CLOBBER|NC_NETCDF4|NC_MPIIO, MPI_COMM_WORLD, MPI_INFO_NULL, &ncid), fname );
+#else
+  temutil::nc( nc_create(fname.c_str(), NC_CLOBBER|NC_NETCDF4, &ncid), fname );
+#endif
+
+  int yeardimid, daydimid, caldaydimid, ydimid, xdimid;
+  temutil::nc( nc_def_dim(ncid, "year", nyears, &yeardimid) );
+  temutil::nc( nc_def_dim(ncid, "day", INTERP_DAYS, &daydimid) );
+  temutil::nc( nc_def_dim(ncid, "cal_day", CAL_DAYS, &caldaydimid) );
+  temutil::nc( nc_def_dim(ncid, "Y", ysize, &ydimid) );
+  temutil::nc( nc_def_dim(ncid, "X", xsize, &xdimid) );
+
+  for (int iv = 0; iv < NUM_VARS; iv++) {
+    int dimids[4] = {yeardimid, VARS[iv].interpolated ? daydimid : caldaydimid, ydimid, xdimid};
+    size_t chunks[4] = {1, (size_t)days_of(VARS[iv]), 1, 1};
+    int varid;
+    temutil::nc( nc_def_var(ncid, VARS[iv].name, NC_FLOAT, 4, dimids, &varid) );
+    temutil::nc( nc_def_var_chunking(ncid, varid, NC_CHUNKED, chunks) );
+    temutil::nc( nc_put_att_float(ncid, varid, "_FillValue", NC_FLOAT, 1, &MISSING_F) );
+    temutil::nc( nc_put_att_text(ncid, varid, "long_name", strlen(VARS[iv].long_name), VARS[iv].long_name) );
+  }
+
+  int dimids[3] = {yeardimid, ydimid, xdimid};
+  int varid;
+  temutil::nc( nc_def_var(ncid, "co2", NC_FLOAT, 3, dimids, &varid) );
+  temutil::nc( nc_put_att_float(ncid, varid, "_FillValue", NC_FLOAT, 1, &MISSING_F) );
+  temutil::nc( nc_put_att_text(ncid, varid, "long_name", 3, "co2") );
+
+  temutil::nc( nc_put_att_text(ncid, NC_GLOBAL, "Git_SHA", strlen(GIT_SHA), GIT_SHA) );
+
+  try {
+    temutil::nc( nc_enddef(ncid) );
+  } catch (const temutil::NetCDFDefineModeException& e) {
+    BOOST_LOG_SEV(glg, info) << "Error ending define mode: " << e.what();
+  }
+
+  temutil::nc( nc_close(ncid) );
+}
+
+void check_file(const std::string& fname, int nyears) {
+
+  if (!boost::filesystem::exists(fname)) {
+    throw std::runtime_error("Daily drivers file does not exist: " + fname);
+  }
+
+  int ncid, dimid;
+  size_t len;
+  temutil::NetCDFLock lock(temutil::netcdf_mutex());
+  temutil::nc( nc_open(fname.c_str(), NC_NOWRITE, &ncid), fname );
+  temutil::nc( nc_inq_dimid(ncid, "year", &dimid), fname );
+  temutil::nc( nc_inq_dimlen(ncid, dimid, &len), fname );
+  temutil::nc( nc_close(ncid), fname );
+
+  if ((int)len < nyears) {
+    std::stringstream ss;
+    ss << fname << " has " << len << " years of daily drivers, " << nyears << " are needed";
+    throw std::runtime_error(ss.str());
+  }
+}
+
+int var_count() {
+  return NUM_VARS + 1;
+}
+
+const char* var_name(int iv) {
+  return (iv < NUM_VARS) ? VARS[iv].name : "co2";
+}
+
+void write_year(OutputSink& sink, const std::string& fname, const Climate& climate,
+                int year, int row, int col) {
+
+  for (int iv = 0; iv < NUM_VARS; iv++) {
+    const std::vector<float>& data = climate.*(VARS[iv].container);
+
+    if ((int)data.size() != days_of(VARS[iv])) {
+      std::stringstream ss;
+      ss << "Can't write daily driver " << VARS[iv].name << ": it has "
+         << data.size() << " days, not " << days_of(VARS[iv]);
+      throw std::runtime_error(ss.str());
+    }
+
+    size_t start[4] = {(size_t)year, 0, (size_t)row, (size_t)col};
+    size_t count[4] = {1, data.size(), 1, 1};
+    sink.put(fname, VARS[iv].name, start, count, &data[0]);
+  }
+
+  size_t start[3] = {(size_t)year, (size_t)row, (size_t)col};
+  size_t count[3] = {1, 1, 1};
+  sink.put(fname, "co2", start, count, &climate.co2_d);
+}
+
+/** Fills the daily containers of a cell's Climate from one year of a file,
+ *  in place of Climate::prepare_daily_driving_data(). */
+void read_year(OutputSink& sink, const std::string& fname, Climate& climate,
+               int year, int row, int col) {
+
+  for (int iv = 0; iv < NUM_VARS; iv++) {
+    std::vector<float>& data = climate.*(VARS[iv].container);
+    data.resize(days_of(VARS[iv]));
+
+    size_t start[4] = {(size_t)year, 0, (size_t)row, (size_t)col};
+    size_t count[4] = {1, data.size(), 1, 1};
+    sink.get(fname, VARS[iv].name, start, count, &data[0]);
+  }
+
+  size_t start[3] = {(size_t)year, (size_t)row, (size_t)col};
+  size_t count[3] = {1, 1, 1};
+  sink.get(fname, "co2", start, count, &climate.co2_d);
+}
+
+} // end namespace DailyDrivers
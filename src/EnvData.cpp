@@ -389,6 +389,7 @@ void EnvData::atm_endOfDay(const int & dinm, const int & dayidx) {
   //Store daily values for netCDF output
   daily_eet[dayidx] = d_l2a.eet;
   daily_pet[dayidx] = d_l2a.pet;
+  daily_tran[dayidx] = d_v2a.tran;
 };
 
 void EnvData::veg_endOfDay(const int & dinm) {
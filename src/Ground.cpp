@@ -351,7 +351,7 @@ void Ground::initRockLayers() {
   soilparent.updateThicknesses(soilparent.thick); //thickness in m
 
   for(int il =soilparent.num-1; il>=0; il--) {
-    ParentLayer* rl = new ParentLayer(soilparent.dz[il]);
+    ParentLayer* rl = new (layerpool) ParentLayer(soilparent.dz[il]);
     insertFront(rl);
   }
 
@@ -362,7 +362,7 @@ void Ground::initRockLayers() {
 void Ground::initSnowSoilLayers() {
   // mineral thickness must be input before calling this
   for(int il = mineralinfo.num - 1; il >= 0; il--) {
-    MineralLayer* ml = new MineralLayer(mineralinfo.dz[il],
+    MineralLayer* ml = new (layerpool) MineralLayer(mineralinfo.dz[il],
                                         mineralinfo.sand[il],
                                         mineralinfo.silt[il],
                                         mineralinfo.clay[il]);
@@ -377,12 +377,12 @@ void Ground::initSnowSoilLayers() {
   // but for insertion of layers into the double-linked matrix, do the
   //   deep organic first
   for(int il = organic.deepnum-1; il >=  0; il--) {
-    OrganicLayer* pl = new OrganicLayer(organic.deepdz[il], 2, chtlu); //2 means deep organic
+    OrganicLayer* pl = new (layerpool) OrganicLayer(organic.deepdz[il], 2, chtlu); //2 means deep organic
     insertFront(pl);
   }
 
   for(int il = organic.shlwnum-1; il >= 0; il--) {
-    OrganicLayer* pl = new OrganicLayer(organic.shlwdz[il], 1, chtlu); //1 means shallow organic
+    OrganicLayer* pl = new (layerpool) OrganicLayer(organic.shlwdz[il], 1, chtlu); //1 means shallow organic
     insertFront(pl);
   }
 
@@ -408,7 +408,7 @@ void Ground::initSnowSoilLayers() {
 
       for(int il = moss.num-1; il >= 0; il--) {
         // moss type (1- sphagnum, 2- feathermoss), which needs input
-        MossLayer* ml = new MossLayer(moss.dz[il], moss.type, chtlu);
+        MossLayer* ml = new (layerpool) MossLayer(moss.dz[il], moss.type, chtlu);
         insertFront(ml);
       }
     }
@@ -422,7 +422,7 @@ void Ground::initSnowSoilLayers() {
 
   // only ONE snow layer input assummed, if any
   if(snow.thick > 0) {
-    SnowLayer* sl = new SnowLayer();
+    SnowLayer* sl = new (layerpool) SnowLayer();
     sl->dz = snow.thick;
     insertFront(sl);
   }
@@ -461,7 +461,7 @@ void Ground::set_state_from_restartdata(snwstate_dim *snowdim,
   }
 
   for(int il =soilparent.num-1; il>=0; il--) {
-    ParentLayer* rl = new ParentLayer(soilparent.dz[il]);
+    ParentLayer* rl = new (layerpool) ParentLayer(soilparent.dz[il]);
     insertFront(rl);
   }
 
@@ -489,7 +489,7 @@ void Ground::set_state_from_restartdata(snwstate_dim *snowdim,
 
   for(int il =mineralinfo.num-1; il>=0; il--) {
 
-    MineralLayer* ml = new MineralLayer(mineralinfo.dz[il],
+    MineralLayer* ml = new (layerpool) MineralLayer(mineralinfo.dz[il],
                                         mineralinfo.sand[il],
                                         mineralinfo.silt[il],
                                         mineralinfo.clay[il]);
@@ -502,7 +502,7 @@ void Ground::set_state_from_restartdata(snwstate_dim *snowdim,
   organic.assignDeepThicknesses(soiltype, dzsoil, MAX_SOI_LAY);
 
   for(int il = organic.deepnum-1; il>=0; il--) {
-    OrganicLayer* pl = new OrganicLayer(organic.deepdz[il], 2, chtlu); //2 means deep organic
+    OrganicLayer* pl = new (layerpool) OrganicLayer(organic.deepdz[il], 2, chtlu); //2 means deep organic
     pl->age = soilage[il];
     pl->frozen = frozen[il];
     insertFront(pl);
@@ -511,7 +511,7 @@ void Ground::set_state_from_restartdata(snwstate_dim *snowdim,
   organic.assignShlwThicknesses(soiltype, dzsoil, MAX_SOI_LAY);
 
   for(int il =organic.shlwnum-1; il>=0; il--) {
-    OrganicLayer* pl = new OrganicLayer(organic.shlwdz[il], 1, chtlu);//1 means shallow organic
+    OrganicLayer* pl = new (layerpool) OrganicLayer(organic.shlwdz[il], 1, chtlu);//1 means shallow organic
     pl->age = soilage[il];
     pl->frozen = frozen[il];
     insertFront(pl);
@@ -520,7 +520,7 @@ void Ground::set_state_from_restartdata(snwstate_dim *snowdim,
   moss.setThicknesses(soiltype, dzsoil, MAX_SOI_LAY);
 
   for(int il = moss.num-1; il>=0; il--) {
-    MossLayer* ml = new MossLayer(moss.dz[il], moss.type, chtlu);
+    MossLayer* ml = new (layerpool) MossLayer(moss.dz[il], moss.type, chtlu);
     ml->age = soilage[il];
     ml->frozen = frozen[il];
     insertFront(ml);
@@ -534,7 +534,7 @@ void Ground::set_state_from_restartdata(snwstate_dim *snowdim,
 
   for(int il =MAX_SNW_LAY-1; il>=0; il--) {
     if(rdata.DZsnow[il]>0) {
-      SnowLayer* snwl = new SnowLayer();
+      SnowLayer* snwl = new (layerpool) SnowLayer();
       snwl->dz = rdata.DZsnow[il];
       snwl->age = rdata.AGEsnow[il];
       snwl->rho = rdata.RHOsnow[il];
@@ -767,6 +767,8 @@ void Ground::updateLayerIndex() {
 
     currl =currl->nextl;
   }
+
+  thermal.invalidate();
 };
 
 // update the z, which is the distance between soil surface and top of a
@@ -940,7 +942,7 @@ bool Ground::constructSnowLayers(const double & dsmass, const double & tdrv) {
     double thick = snow.extramass/density;
 
     if(toplayer->isSnow) {
-      SnowLayer * snwl = new SnowLayer();
+      SnowLayer * snwl = new (layerpool) SnowLayer();
       snwl->age = 0.;
       snwl->rho = snowdimpar.newden;
       snwl->dz = thick;
@@ -954,7 +956,7 @@ bool Ground::constructSnowLayers(const double & dsmass, const double & tdrv) {
       double tsno =toplayer->tem;
 
       if(tsno<=0) {
-        SnowLayer * snwl = new SnowLayer();
+        SnowLayer * snwl = new (layerpool) SnowLayer();
         snwl->rho    = snowdimpar.newden;
         snwl->dz  = thick;
         snwl->ice = snow.extramass;
@@ -1020,7 +1022,7 @@ STARTOFDIVIDE:
             currl->dz  /=2;
             currl->liq /=2;
             currl->ice /=2;
-            SnowLayer* sl = new SnowLayer();
+            SnowLayer* sl = new (layerpool) SnowLayer();
             sl->clone(dynamic_cast<SnowLayer*>(currl));
             sl->tem = currl->tem;
             insertAfter(sl, currl);
@@ -1035,7 +1037,7 @@ STARTOFDIVIDE:
             currl->dz = snow.maxdz[currl->indl];
             currl->liq *= currl->dz/tempdz ;
             currl->ice *= currl->dz/tempdz ;
-            SnowLayer* sl = new SnowLayer();
+            SnowLayer* sl = new (layerpool) SnowLayer();
             sl->tem = currl->tem;
             sl->clone(dynamic_cast<SnowLayer*>(currl));
             sl->dz  = tempdz - currl->dz;
@@ -1207,7 +1209,7 @@ void  Ground::redivideMossLayers(const int &mosstype) {
     //Create live moss
     moss.thick = 0.01;
     BOOST_LOG_SEV(glg, debug)<<"Creating new moss layer, type: "<<moss.type<<", thickness: "<<moss.thick;
-    MossLayer* ml = new MossLayer(moss.thick, moss.type, chtlu);
+    MossLayer* ml = new (layerpool) MossLayer(moss.thick, moss.type, chtlu);
     moss.num = 1;
     ml->tem = fstsoill->tem;
     ml->z = 0.0;
@@ -1297,7 +1299,7 @@ COMBINEBEGIN:
       OrganicLayer* plnew;
 
       for (int i=organic.shlwnum-1; i>0; i--) {
-        plnew = new OrganicLayer(organic.shlwdz[i], 1, chtlu);
+        plnew = new (layerpool) OrganicLayer(organic.shlwdz[i], 1, chtlu);
         SoilLayer* shlwsl = dynamic_cast<SoilLayer*>(fstshlwl);
         //split 'plnew' from bottom of 'shlwsl'
         splitOneSoilLayer(shlwsl, plnew, 0., organic.shlwdz[i]);
@@ -1339,7 +1341,7 @@ COMBINEBEGIN:
       double thick = thicknessFromCarbon(abvgfallC, soildimpar.coefshlwa, soildimpar.coefshlwb);
       //organic.ShlwThickScheme(MINSLWTHICK);
       organic.ShlwThickScheme(thick);
-      OrganicLayer* plnew = new OrganicLayer(organic.shlwdz[0], 1, chtlu);
+      OrganicLayer* plnew = new (layerpool) OrganicLayer(organic.shlwdz[0], 1, chtlu);
       //plnew->dz= MINSLWTHICK;
       plnew->dz= thick;
       //double frac = MINSLWTHICK/nextsl->dz;
@@ -1444,7 +1446,7 @@ void Ground::redivideDeepLayers() {
       OrganicLayer* plnew;
 
       for (int i=organic.deepnum-1; i>0; i--) {
-        plnew = new OrganicLayer(organic.deepdz[i], 2, chtlu);
+        plnew = new (layerpool) OrganicLayer(organic.deepdz[i], 2, chtlu);
         SoilLayer* deepsl = dynamic_cast<SoilLayer*>(fstdeepl);
         // split 'plnew' from bottom of 'deepsl'
         splitOneSoilLayer(deepsl, plnew, 0., organic.deepdz[i]);
@@ -1469,7 +1471,7 @@ void Ground::redivideDeepLayers() {
 
     if (somc>=deepcmin) {
       organic.DeepThickScheme(MINDEPTHICK);
-      OrganicLayer* plnew = new OrganicLayer(organic.deepdz[0], 2, chtlu);
+      OrganicLayer* plnew = new (layerpool) OrganicLayer(organic.deepdz[0], 2, chtlu);
       double frac = plnew->dz/lfibl->dz;
       // assign properties for the new-created 'deep' layer
       plnew->ice = lfibl->ice*frac;
@@ -0,0 +1,197 @@
+/*  InputFiles.cpp
+ *
+ *  Per-cell reads from the input files. See InputFiles.h
+ */
+
+#include <map>
+#include <exception>
+
+#include <netcdf.h>
+
+#include "../include/InputFiles.h"
+#include "../include/TEMUtilityFunctions.h"
+#include "../include/TEMLogger.h"
+
+extern src::severity_logger< severity_level > glg;
+
+namespace {
+
+// Open input files by path. Only touched with the NetCDF lock held.
+std::map<std::string, int> handles;
+
+int handle(const std::string& fname) {
+  std::map<std::string, int>::const_iterator it = handles.find(fname);
+  if (it != handles.end()) {
+    return it->second;
+  }
+
+  int ncid;
+  temutil::nc( nc_open(fname.c_str(), NC_NOWRITE, &ncid), fname );
+  handles[fname] = ncid;
+  return ncid;
+}
+
+// The library converts from the type in the file to the type asked for
+void get_vara(int ncid, int varid, const size_t start[], const size_t count[], int* out) {
+  temutil::nc( nc_get_vara_int(ncid, varid, start, count, out) );
+}
+
+void get_vara(int ncid, int varid, const size_t start[], const size_t count[], int64_t* out) {
+  static_assert(sizeof(int64_t) == sizeof(long long), "int64_t is not long long");
+  temutil::nc( nc_get_vara_longlong(ncid, varid, start, count,
+                                    reinterpret_cast<long long*>(out)) );
+}
+
+void get_vara(int ncid, int varid, const size_t start[], const size_t count[], float* out) {
+  temutil::nc( nc_get_vara_float(ncid, varid, start, count, out) );
+}
+
+void get_vara(int ncid, int varid, const size_t start[], const size_t count[], double* out) {
+  temutil::nc( nc_get_vara_double(ncid, varid, start, count, out) );
+}
+
+} // end anonymous namespace
+
+
+InputPass::InputPass(const std::string& fname, int y, int x):
+    fname(fname), y(y), x(x) {
+}
+
+template <typename DTYPE>
+InputPass& InputPass::queue_scalar(const std::string& var, DTYPE& out) {
+  const int y = this->y;
+  const int x = this->x;
+
+  reads.push_back([var, y, x, &out](int ncid) {
+    int varid;
+    temutil::nc( nc_inq_varid(ncid, var.c_str(), &varid) );
+
+    size_t start[2] = { size_t(y), size_t(x) };
+    size_t count[2] = { 1, 1 };
+    get_vara(ncid, varid, start, count, &out);
+  });
+
+  return *this;
+}
+
+template <typename DTYPE>
+InputPass& InputPass::queue_series(const std::string& var, std::vector<DTYPE>& out) {
+  const int y = this->y;
+  const int x = this->x;
+
+  reads.push_back([var, y, x, &out](int ncid) {
+    int timeD;
+    size_t timeD_len;
+    temutil::nc( nc_inq_dimid(ncid, "time", &timeD) );
+    temutil::nc( nc_inq_dimlen(ncid, timeD, &timeD_len) );
+
+    int varid;
+    temutil::nc( nc_inq_varid(ncid, var.c_str(), &varid) );
+
+    out.resize(timeD_len);
+    if (timeD_len == 0) {
+      return;
+    }
+
+    size_t start[3] = { 0, size_t(y), size_t(x) };
+    size_t count[3] = { timeD_len, 1, 1 };
+    get_vara(ncid, varid, start, count, &out[0]);
+  });
+
+  return *this;
+}
+
+InputPass& InputPass::scalar(const std::string& var, int& out) {
+  return queue_scalar(var, out);
+}
+
+InputPass& InputPass::scalar(const std::string& var, float& out) {
+  return queue_scalar(var, out);
+}
+
+InputPass& InputPass::scalar(const std::string& var, double& out) {
+  return queue_scalar(var, out);
+}
+
+InputPass& InputPass::series(const std::string& var, std::vector<int>& out) {
+  return queue_series(var, out);
+}
+
+InputPass& InputPass::series(const std::string& var, std::vector<int64_t>& out) {
+  return queue_series(var, out);
+}
+
+InputPass& InputPass::series(const std::string& var, std::vector<float>& out) {
+  return queue_series(var, out);
+}
+
+InputPass& InputPass::time_span(int& start_year, int& end_year) {
+  reads.push_back([&start_year, &end_year](int ncid) {
+    start_year = temutil::get_timeseries_start_year(ncid);
+    end_year = temutil::get_timeseries_end_year(ncid);
+  });
+
+  return *this;
+}
+
+InputPass& InputPass::latlon(std::pair<float, float>& out) {
+  const int y = this->y;
+  const int x = this->x;
+
+  reads.push_back([y, x, &out](int ncid) {
+    int latV;
+    int lonV;
+    temutil::nc( nc_inq_varid(ncid, "lat", &latV) );
+    temutil::nc( nc_inq_varid(ncid, "lon", &lonV) );
+
+    size_t start[2] = { size_t(y), size_t(x) };
+    temutil::nc( nc_get_var1_float(ncid, latV, start, &out.first) );
+    temutil::nc( nc_get_var1_float(ncid, lonV, start, &out.second) );
+  });
+
+  return *this;
+}
+
+/** Runs every queued read against the file, taking the NetCDF lock once.
+ *  An error is carried out of the locked block before it is thrown, so
+ *  the lock is not held while the caller handles it.
+ */
+void InputPass::read() {
+  BOOST_LOG_SEV(glg, debug) << "Reading " << reads.size() << " input(s) for "
+                            << "(y, x) point: (" << y << "," << x << ") from "
+                            << fname;
+
+  std::exception_ptr error;
+
+  {
+    temutil::NetCDFLock lock(temutil::netcdf_mutex());
+    try {
+      int ncid = handle(fname);
+      for (size_t i = 0; i < reads.size(); ++i) {
+        reads[i](ncid);
+      }
+    } catch (...) {
+      error = std::current_exception();
+    }
+  }//End NetCDF lock
+
+  reads.clear();
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+
+namespace InputFiles {
+
+  void close_all() {
+    temutil::NetCDFLock lock(temutil::netcdf_mutex());
+    for (std::map<std::string, int>::const_iterator it = handles.begin();
+         it != handles.end(); ++it) {
+      nc_close(it->second);
+    }
+    handles.clear();
+  }
+
+}
@@ -6,6 +6,23 @@
 #include "../include/TEMLogger.h"
 extern src::severity_logger< severity_level > glg;
 
+void* Layer::operator new(size_t size, LayerPool& pool) {
+  return LayerPool::allocate(size, &pool);
+}
+
+void* Layer::operator new(size_t size) {
+  return LayerPool::allocate(size, NULL);
+}
+
+// Only called if a constructor throws
+void Layer::operator delete(void* p, LayerPool& pool) {
+  LayerPool::release(p);
+}
+
+void Layer::operator delete(void* p) {
+  LayerPool::release(p);
+}
+
 Layer::Layer() {
   BOOST_LOG_SEV(glg, debug) << "Creating a (generic) layer object...";
   nextl = NULL;
@@ -0,0 +1,131 @@
+/*! \file
+ * See LayerPool.h
+ */
+
+#include <new>
+#include <cstdlib>
+#include <algorithm>
+#include <stdexcept>
+
+#include "../include/LayerPool.h"
+#include "../include/SnowLayer.h"
+#include "../include/MossLayer.h"
+#include "../include/OrganicLayer.h"
+#include "../include/MineralLayer.h"
+#include "../include/ParentLayer.h"
+
+#include "../include/TEMLogger.h"
+extern src::severity_logger< severity_level > glg;
+
+namespace {
+
+// Ahead of every layer: the pool it came from (NULL for the heap) and its
+// slot. Padded so the layer after it keeps the alignment of the block.
+struct SlotHeader {
+  LayerPool* owner;
+  int slot;
+};
+
+const size_t HEADER_BYTES = 16;
+static_assert(sizeof(SlotHeader) <= HEADER_BYTES, "SlotHeader must fit in HEADER_BYTES");
+
+// Slots are whole cache lines, so no two layers share one
+const size_t LINE_BYTES = 64;
+
+/** Memory starting on a cache line. Released with free(). */
+char* allocate_lines(size_t bytes) {
+  void* p = NULL;
+  if (posix_memalign(&p, LINE_BYTES, bytes) != 0) {
+    throw std::bad_alloc();
+  }
+  return static_cast<char*>(p);
+}
+
+} // end anonymous namespace
+
+
+LayerPool::LayerPool() {
+  block = allocate_lines(CAPACITY * slot_bytes());
+  reset();
+}
+
+LayerPool::LayerPool(const LayerPool& other) {
+  block = allocate_lines(CAPACITY * slot_bytes());
+  reset();
+}
+
+/** Only an empty pool can be assigned over: the layers in a pool are
+ *  still linked into its column. */
+LayerPool& LayerPool::operator=(const LayerPool& other) {
+  if (slots_in_use() > 0) {
+    BOOST_LOG_SEV(glg, fatal) << "Assigning over a layer pool with " << slots_in_use()
+                              << " layers still in it";
+    throw std::runtime_error("Can't assign over a layer pool that still holds layers");
+  }
+  reset();
+  return *this;
+}
+
+/** Marks every slot free. Handed out from slot 0 up, so a column built top
+ *  to bottom (or bottom to top) is laid out in order. */
+void LayerPool::reset() {
+  nfree = CAPACITY;
+  for (int i = 0; i < CAPACITY; i++) {
+    free_slots[i] = CAPACITY - 1 - i;
+  }
+}
+
+/** Layers left in the pool are not destroyed; the column that owns the
+ *  pool is expected to have removed them already. */
+LayerPool::~LayerPool() {
+  free(block);
+}
+
+/** Bytes per slot: the header and the largest kind of layer, rounded up
+ *  to whole cache lines. */
+size_t LayerPool::slot_bytes() {
+  size_t largest = std::max(std::max(sizeof(SnowLayer), sizeof(MossLayer)),
+                            std::max(std::max(sizeof(OrganicLayer), sizeof(MineralLayer)),
+                                     sizeof(ParentLayer)));
+  size_t bytes = HEADER_BYTES + largest;
+  return ((bytes + LINE_BYTES - 1) / LINE_BYTES) * LINE_BYTES;
+}
+
+/** Memory for a layer of the given size, from the pool if there is one
+ *  with a free slot, otherwise from the heap. */
+void* LayerPool::allocate(size_t size, LayerPool* pool) {
+  SlotHeader header;
+  char* p;
+
+  if (pool && pool->nfree > 0 && HEADER_BYTES + size <= slot_bytes()) {
+    header.owner = pool;
+    header.slot = pool->free_slots[--pool->nfree];
+    p = pool->block + header.slot * slot_bytes();
+  } else {
+    if (pool) {
+      BOOST_LOG_SEV(glg, debug) << "Layer pool is full, allocating layer from the heap";
+    }
+    header.owner = NULL;
+    header.slot = -1;
+    p = allocate_lines(HEADER_BYTES + size);
+  }
+
+  *reinterpret_cast<SlotHeader*>(p) = header;
+  return p + HEADER_BYTES;
+}
+
+/** Returns a layer's memory to wherever allocate() took it from. */
+void LayerPool::release(void* p) {
+  if (!p) {
+    return;
+  }
+
+  char* start = static_cast<char*>(p) - HEADER_BYTES;
+  SlotHeader header = *reinterpret_cast<SlotHeader*>(start);
+
+  if (header.owner) {
+    header.owner->free_slots[header.owner->nfree++] = header.slot;
+  } else {
+    free(start);
+  }
+}
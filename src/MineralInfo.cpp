@@ -1,5 +1,6 @@
 #include "../include/MineralInfo.h"
 #include "../include/TEMUtilityFunctions.h" 
+#include "../include/InputFiles.h"
 #include "../include/TEMLogger.h"
 
 extern src::severity_logger< severity_level > glg;
@@ -8,21 +9,22 @@ MineralInfo::MineralInfo() {}
 
 MineralInfo::MineralInfo(const std::string& fname, const int y, const int x) {
 
-  #pragma omp critical(load_input)
-  {  
-    BOOST_LOG_SEV(glg, info) << "Loading ModelInfo (soil texture) from file: " << fname;
-    BOOST_LOG_SEV(glg, info) << "Loading for (y, x) point: " << "("<< y <<","<< x <<").";
-
-    float psand = temutil::get_scalar<float>(fname, "pct_sand", y, x);
-    float psilt = temutil::get_scalar<float>(fname, "pct_silt", y, x);
-    float pclay = temutil::get_scalar<float>(fname, "pct_clay", y, x);
-    
-    for (int i = 0; i < MAX_MIN_LAY; ++i) {
-      sand[i] = psand;
-      silt[i] = psilt;
-      clay[i] = pclay;
-    }
-  }//End critical(soil_texture)
+  BOOST_LOG_SEV(glg, info) << "Loading ModelInfo (soil texture) from file: " << fname;
+  BOOST_LOG_SEV(glg, info) << "Loading for (y, x) point: " << "("<< y <<","<< x <<").";
+
+  float psand;
+  float psilt;
+  float pclay;
+  InputPass(fname, y, x).scalar("pct_sand", psand)
+                        .scalar("pct_silt", psilt)
+                        .scalar("pct_clay", pclay)
+                        .read();
+
+  for (int i = 0; i < MAX_MIN_LAY; ++i) {
+    sand[i] = psand;
+    silt[i] = psilt;
+    clay[i] = pclay;
+  }
   setDefaultThick(0.0);
 }
 
@@ -26,7 +26,10 @@ std::string table_row(int w, std::string d, bool v) {
 
 ModelData::~ModelData() {}
 
-ModelData::ModelData(Json::Value controldata):force_cmt(-1) {
+ModelData::ModelData(Json::Value controldata):force_cmt(-1), resume(false),
+    write_daily_drivers(false), cache_daily_forcing(true),
+    output_sink(NULL), output_writer(NULL), climate_tiles(NULL),
+    restart_checkpoints(NULL) {
 
   BOOST_LOG_SEV(glg, debug) << "Creating a ModelData. New style constructor with injected controldata...";
 
@@ -103,6 +106,9 @@ ModelData::ModelData(Json::Value controldata):force_cmt(-1) {
   runmask_file      = controldata["IO"]["runmask_file"].asString();
   output_dir        = controldata["IO"]["output_dir"].asString();
   restart_from      = controldata["IO"]["restart_from"].asString();
+  restart_handoff   = controldata["IO"]["restart_handoff"].asString();
+  restart_stages    = controldata["IO"]["restart_stages"].asString();
+  restart_format    = controldata["IO"]["restart_format"].asString();
   output_spec_file  = controldata["IO"]["output_spec_file"].asString();
   output_monthly    = controldata["IO"]["output_monthly"].asInt();
   nc_eq             = controldata["IO"]["output_nc_eq"].asBool();
@@ -110,6 +116,62 @@ ModelData::ModelData(Json::Value controldata):force_cmt(-1) {
   nc_tr             = controldata["IO"]["output_nc_tr"].asBool();
   nc_sc             = controldata["IO"]["output_nc_sc"].asBool();
   output_interval   = controldata["IO"]["output_interval"].asInt();
+  async_output      = controldata["IO"]["async_output"].asBool();
+  output_queue_size = controldata["IO"]["output_queue_size"].asInt();
+  output_io_threads = controldata["IO"]["output_io_threads"].asInt();
+  collective_output = controldata["IO"]["mpi_collective_output"].asBool();
+  collective_block_rows = controldata["IO"]["collective_block_rows"].asInt();
+  time_major_tile_rows = controldata["IO"]["time_major_tile_rows"].asInt();
+  cell_cost_file    = controldata["IO"]["cell_cost_file"].asString();
+  climate_tile_rows = controldata["IO"]["climate_tile_rows"].asInt();
+  climate_tile_cache = controldata["IO"]["climate_tile_cache"].asInt();
+  checkpoint_interval = controldata["IO"]["checkpoint_interval"].asInt();
+  solver_stats      = controldata["IO"]["solver_stats"].asBool();
+
+  if (output_queue_size <= 0) {
+    output_queue_size = 4096;
+  }
+  if (output_io_threads <= 0) {
+    output_io_threads = 1;
+  }
+  if (collective_block_rows <= 0) {
+    collective_block_rows = 1;
+  }
+  if (time_major_tile_rows <= 0) {
+    time_major_tile_rows = 1;
+  }
+  if (climate_tile_cache <= 0) {
+    climate_tile_cache = 2;
+  }
+  if (checkpoint_interval < 0) {
+    checkpoint_interval = 0;
+  }
+  if (restart_handoff.empty()) {
+    restart_handoff = "memory";
+  }
+  if (restart_handoff != "memory" && restart_handoff != "file" && restart_handoff != "verify") {
+    BOOST_LOG_SEV(glg, warn) << "Unknown restart_handoff '" << restart_handoff
+                             << "'. Using 'memory'.";
+    restart_handoff = "memory";
+  }
+  if (restart_stages.empty()) {
+    restart_stages = "pr,eq,sp,tr,sc";
+  }
+  if (restart_format.empty()) {
+    restart_format = "netcdf";
+  }
+  if (restart_format != "netcdf" && restart_format != "binary") {
+    BOOST_LOG_SEV(glg, warn) << "Unknown restart_format '" << restart_format
+                             << "'. Using 'netcdf'.";
+    restart_format = "netcdf";
+  }
+#ifndef WITHMPI
+  if (collective_output) {
+    BOOST_LOG_SEV(glg, warn) << "mpi_collective_output is set, but this build "
+                             << "does not have MPI. Ignoring it.";
+    collective_output = false;
+  }
+#endif
 
   //Config Calibration IO Settings
   pid_tag           = controldata["calibration-IO"]["pid_tag"].asString();
@@ -157,6 +219,15 @@ void ModelData::update(ArgHandler const * arghandler) {
     this->inter_stage_pause = arghandler->get_inter_stage_pause();
   }
 
+  this->resume = arghandler->get_resume();
+
+  this->write_daily_drivers = arghandler->get_write_daily_drivers();
+  this->cache_daily_forcing = !arghandler->get_no_forcing_cache();
+  this->daily_drivers_dir = arghandler->get_read_daily_drivers();
+  if (!this->daily_drivers_dir.empty() && *this->daily_drivers_dir.rbegin() != '/') {
+    this->daily_drivers_dir += "/";
+  }
+
   // User wants to override the veg map
   if (arghandler->get_force_cmt() >= 0) {
     this->force_cmt = arghandler->get_force_cmt();
@@ -164,7 +235,17 @@ void ModelData::update(ArgHandler const * arghandler) {
 }
 
 
-ModelData::ModelData():force_cmt(-1) {
+ModelData::ModelData():force_cmt(-1), resume(false),
+    write_daily_drivers(false), cache_daily_forcing(true),
+    restart_handoff("memory"), restart_stages("pr,eq,sp,tr,sc"),
+    restart_format("netcdf"),
+    async_output(false),
+    output_queue_size(4096), output_io_threads(1),
+    collective_output(false), collective_block_rows(1),
+    time_major_tile_rows(1), climate_tile_rows(0), climate_tile_cache(2),
+    checkpoint_interval(0), solver_stats(false),
+    output_sink(NULL), output_writer(NULL), climate_tiles(NULL),
+    restart_checkpoints(NULL) {
   set_envmodule(false);
   set_bgcmodule(false);
   set_dynamic_lai_module(false);
@@ -173,6 +254,16 @@ ModelData::ModelData():force_cmt(-1) {
 }
 
 
+/** Whether the restart file for a stage ("pr", "eq", ...) is written.
+ *  Always true unless the stages hand their state on in memory.
+ */
+bool ModelData::persist_restart(const std::string& stage) const {
+  if (restart_handoff != "memory") {
+    return true;
+  }
+  return ("," + restart_stages + ",").find("," + stage + ",") != std::string::npos;
+}
+
 bool ModelData::get_envmodule() {
   return this->envmodule;
 }
@@ -294,6 +385,24 @@ std::string ModelData::describe_module_settings() {
 */
 void ModelData::create_netCDF_output_files(int ysize, int xsize,
     const std::string& stage, int stage_year_count, bool copy_grip_mapping) {
+  load_output_spec(ysize, xsize, stage, stage_year_count, copy_grip_mapping, true);
+}
+
+/** Read the output selections and fill in the output maps, without
+ *  creating any files. A resumed run uses this, as the files the
+ *  interrupted run created are still there.
+ */
+void ModelData::read_output_spec() {
+  load_output_spec(0, 0, "", 0, false, false);
+}
+
+/** Fill in an OutputSpec for each variable selected in the output spec
+ *  file and add it to the output map for its timestep. With create_files,
+ *  an empty NetCDF file is created for the variable as well.
+ */
+void ModelData::load_output_spec(int ysize, int xsize,
+    const std::string& stage, int stage_year_count, bool copy_grip_mapping,
+    bool create_files) {
 
   boost::filesystem::path output_base = output_dir;
 
@@ -358,6 +467,7 @@ void ModelData::create_netCDF_output_files(int ysize, int xsize,
     new_spec.monthly = false;
     new_spec.daily = false;
     new_spec.dim_count = 3; // All variables have time, y, x
+    new_spec.data_type = NC_DOUBLE; // Unless the spec file says otherwise
 
     for(int ii=0; ii<10; ii++){
       std::getline(ss, token, ',');
@@ -449,6 +559,24 @@ void ModelData::create_netCDF_output_files(int ysize, int xsize,
       new_spec.filename_prefix = name + "_" + timestep;
       new_spec.var_name = name;
 
+      // Add OutputSpec objects to the map tracking the appropriate timestep
+      if(new_spec.daily){
+        daily_netcdf_outputs.insert(std::map<std::string, OutputSpec>::value_type(name, new_spec));
+      }
+
+      else if(new_spec.monthly){
+        monthly_netcdf_outputs.insert(std::map<std::string, OutputSpec>::value_type(name, new_spec));
+        //monthly_netcdf_outputs.insert({name, filename}); c++11
+      }
+
+      else if(new_spec.yearly){
+        yearly_netcdf_outputs.insert(std::map<std::string, OutputSpec>::value_type(name, new_spec));
+      }
+
+      if(!create_files){
+        continue;
+      }
+
       // Temporary name for file creation.
       std::string creation_filename = name + "_" + timestep + "_" + stage + ".nc";
 
@@ -459,6 +587,8 @@ void ModelData::create_netCDF_output_files(int ysize, int xsize,
       // convert path to string for simplicity in the following function calls
       std::string creation_filestr = output_filepath.string();
 
+      temutil::NetCDFLock lock(temutil::netcdf_mutex());
+
 #ifdef WITHMPI
       // Creating PARALLEL NetCDF file
       BOOST_LOG_SEV(glg, debug)<<"Creating a parallel output NetCDF file " << creation_filestr;
@@ -743,20 +873,6 @@ void ModelData::create_netCDF_output_files(int ysize, int xsize,
       BOOST_LOG_SEV(glg, debug) << "Closing new file...";
       temutil::nc( nc_close(ncid) );
 
-      // Add OutputSpec objects to the map tracking the appropriate timestep
-      if(new_spec.daily){
-        daily_netcdf_outputs.insert(std::map<std::string, OutputSpec>::value_type(name, new_spec));
-      }
-
-      else if(new_spec.monthly){
-        monthly_netcdf_outputs.insert(std::map<std::string, OutputSpec>::value_type(name, new_spec));
-        //monthly_netcdf_outputs.insert({name, filename}); c++11
-      }
-
-      else if(new_spec.yearly){
-        yearly_netcdf_outputs.insert(std::map<std::string, OutputSpec>::value_type(name, new_spec));
-      }
-
     } // End file creation section (if timestep is specified)
   } // End looping over the output spec file.
 }
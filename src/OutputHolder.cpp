@@ -0,0 +1,224 @@
+/*  OutputHolder.cpp
+ *
+ *  Held output data for a cell. See OutputHolder.h
+ */
+
+#include <map>
+#include <atomic>
+#include <string>
+#include <stdexcept>
+
+#include <netcdf.h>
+
+#include "../include/OutputHolder.h"
+#include "../include/ModelData.h"
+#include "../include/TEMLogger.h"
+#include "../include/timeconst.h"
+
+extern src::severity_logger< severity_level > glg;
+
+/** Arenas released by finished cells, kept for the next cell on the same
+ *  thread. The pool never holds more arenas than the thread has had in use
+ *  at once, so a thread that destroys a whole tile of holders in one go
+ *  keeps only as many as it will need again and frees the rest.
+ */
+struct ArenaPool {
+  std::vector<std::vector<double> > spares;
+  std::atomic<int> live; // Holders set up on the thread, not yet destroyed
+  int peak;              // Most holders ever live at once
+
+  ArenaPool(): live(0), peak(0) {}
+};
+
+namespace {
+
+// This thread's pool. Holders are only set up on the threads that run
+// cells, which last for the whole run.
+thread_local ArenaPool arena_pool;
+
+void setup_columns(const std::map<std::string, OutputSpec>& outputs,
+                   int timestep_capacity, std::vector<OutputColumn>& columns,
+                   size_t& arena_size) {
+  columns.clear();
+
+  std::map<std::string, OutputSpec>::const_iterator map_itr;
+  for(map_itr = outputs.begin(); map_itr != outputs.end(); ++map_itr){
+
+    const OutputVarDef* def = find_output_var(map_itr->first);
+    if(def == NULL){
+      BOOST_LOG_SEV(glg, warn) << "No output is available for " << map_itr->first
+                               << ". It will not be written.";
+      continue;
+    }
+
+    OutputColumn column;
+    column.def = def;
+    column.spec = map_itr->second;
+    column.values_per_timestep = output_values_per_timestep(*def, column.spec);
+    column.timestep_capacity = timestep_capacity;
+    column.timesteps_held = 0;
+    column.offset = arena_size;
+    columns.push_back(column);
+
+    arena_size += timestep_capacity * column.values_per_timestep;
+  }
+}
+
+} // end anonymous namespace
+
+
+OutputHolder::OutputHolder(): pool(NULL) {}
+
+/** Hands the arena back to the pool it came from, if it is this thread's
+ *  pool and the pool is not already full. Otherwise it is freed.
+ */
+OutputHolder::~OutputHolder() {
+  if(pool == NULL){
+    return;
+  }
+  int live = --pool->live;
+  if(pool == &arena_pool && arena.capacity() > 0
+     && (int)arena_pool.spares.size() + live < arena_pool.peak){
+    arena_pool.spares.push_back(std::vector<double>());
+    arena_pool.spares.back().swap(arena);
+  }
+}
+
+/** Build a column for each output variable enabled in the ModelData's
+ *  output maps and size the arena to hold them. Done once per Runner, so
+ *  the per timestep work only ever touches the variables that are
+ *  actually being output.
+ *
+ *  Daily data is written every year; monthly and yearly data every
+ *  output_interval years.
+ */
+void OutputHolder::setup(const ModelData& md) {
+
+  int interval = md.output_interval > 0 ? md.output_interval : 1;
+
+  size_t arena_size = 0;
+  setup_columns(md.yearly_netcdf_outputs, interval, this->yearly, arena_size);
+  setup_columns(md.monthly_netcdf_outputs, interval*MINY, this->monthly, arena_size);
+  setup_columns(md.daily_netcdf_outputs, DINY, this->daily, arena_size);
+
+  // Reuse an arena left by an earlier cell on this thread, if there is one
+  if(pool == NULL){
+    pool = &arena_pool;
+    int live = ++arena_pool.live;
+    if(live > arena_pool.peak){
+      arena_pool.peak = live;
+    }
+    if(!arena_pool.spares.empty()){
+      arena.swap(arena_pool.spares.back());
+      arena_pool.spares.pop_back();
+    }
+  }
+  arena.resize(arena_size);
+
+  size_t largest_column = 0;
+  std::vector<OutputColumn>* all_columns[] = { &yearly, &monthly, &daily };
+  for(int ic=0; ic<3; ic++){
+    std::vector<OutputColumn>& columns = *all_columns[ic];
+    for(unsigned int iv=0; iv<columns.size(); iv++){
+      size_t column_size = columns[iv].timestep_capacity * columns[iv].values_per_timestep;
+      if(column_size > largest_column){
+        largest_column = column_size;
+      }
+    }
+  }
+  convert_buffer.resize(largest_column * sizeof(double));
+
+  BOOST_LOG_SEV(glg, debug) << "OutputHolder arena: " << arena_size << " values for "
+                            << yearly.size() + monthly.size() + daily.size()
+                            << " output variables.";
+}
+
+/** Drop any held data, keeping the columns. */
+void OutputHolder::clear() {
+  std::vector<OutputColumn>* all_columns[] = { &yearly, &monthly, &daily };
+  for(int ic=0; ic<3; ic++){
+    std::vector<OutputColumn>& columns = *all_columns[ic];
+    for(unsigned int iv=0; iv<columns.size(); iv++){
+      columns[iv].timesteps_held = 0;
+    }
+  }
+}
+
+/** Start of a column's held values. */
+double* OutputHolder::data(const OutputColumn& column) {
+  return &arena[column.offset];
+}
+
+/** The held values of a column, as the column's NetCDF type. Doubles are
+ *  returned in place; other types are converted into a scratch buffer that
+ *  is only valid until the next call.
+ */
+const void* OutputHolder::typed_data(const OutputColumn& column) {
+
+  const double* values = &arena[column.offset];
+  int count = column.timesteps_held * column.values_per_timestep;
+
+  if(column.spec.data_type == NC_INT){
+    int* converted = reinterpret_cast<int*>(&convert_buffer[0]);
+    for(int ii=0; ii<count; ii++){
+      converted[ii] = values[ii];
+    }
+    return converted;
+  }
+  else if(column.spec.data_type == NC_FLOAT){
+    float* converted = reinterpret_cast<float*>(&convert_buffer[0]);
+    for(int ii=0; ii<count; ii++){
+      converted[ii] = values[ii];
+    }
+    return converted;
+  }
+  return values;
+}
+
+/** Writes the number of timesteps held in each column and the arena, so
+ *  that a cell resumed from a checkpoint writes out the same data it would
+ *  have. */
+void OutputHolder::save(std::ostream& out) const {
+  const std::vector<OutputColumn>* all_columns[] = { &yearly, &monthly, &daily };
+  for(int ic=0; ic<3; ic++){
+    const std::vector<OutputColumn>& columns = *all_columns[ic];
+    int column_count = columns.size();
+    out.write(reinterpret_cast<const char*>(&column_count), sizeof(int));
+    for(unsigned int iv=0; iv<columns.size(); iv++){
+      out.write(reinterpret_cast<const char*>(&columns[iv].timesteps_held), sizeof(int));
+    }
+  }
+  size_t arena_size = arena.size();
+  out.write(reinterpret_cast<const char*>(&arena_size), sizeof(size_t));
+  if(arena_size > 0){
+    out.write(reinterpret_cast<const char*>(&arena[0]), arena_size * sizeof(double));
+  }
+}
+
+/** Reads back what save() wrote. The holder must have been set up with
+ *  the same output variables and interval. */
+void OutputHolder::load(std::istream& in) {
+  std::vector<OutputColumn>* all_columns[] = { &yearly, &monthly, &daily };
+  for(int ic=0; ic<3; ic++){
+    std::vector<OutputColumn>& columns = *all_columns[ic];
+    int column_count = -1;
+    in.read(reinterpret_cast<char*>(&column_count), sizeof(int));
+    if(column_count != (int)columns.size()){
+      throw std::runtime_error("Held output in the checkpoint does not match the enabled output variables");
+    }
+    for(unsigned int iv=0; iv<columns.size(); iv++){
+      in.read(reinterpret_cast<char*>(&columns[iv].timesteps_held), sizeof(int));
+    }
+  }
+  size_t arena_size = 0;
+  in.read(reinterpret_cast<char*>(&arena_size), sizeof(size_t));
+  if(!in || arena_size != arena.size()){
+    throw std::runtime_error("Held output in the checkpoint does not match the output interval");
+  }
+  if(arena_size > 0){
+    in.read(reinterpret_cast<char*>(&arena[0]), arena_size * sizeof(double));
+  }
+  if(!in){
+    throw std::runtime_error("Held output in the checkpoint is truncated");
+  }
+}
@@ -0,0 +1,1319 @@
+/*  OutputRegistry.cpp
+ *
+ *  The output variable table and the functions that fill it. See
+ *  OutputRegistry.h
+ *
+ *  To add a new output variable: add it to output_spec.csv, write a fill
+ *  function below, and add a row to the output_vars table. The table is
+ *  kept in alphabetical order, the same as the csv file.
+ */
+
+#include <cstring>
+
+#include "../include/OutputRegistry.h"
+#include "../include/Cohort.h"
+#include "../include/TEMUtilityFunctions.h"
+#include "../include/timeconst.h"
+
+namespace {
+
+/////////////////////////////////////////////////////////////////////
+// Helpers for the common shapes of output data
+/////////////////////////////////////////////////////////////////////
+
+// A single value, taken from the monthly or yearly data
+bool monthly_or_yearly(const OutputSpec& spec, double m_val, double y_val,
+                       double* out) {
+  if(spec.monthly){
+    out[0] = m_val;
+    return true;
+  }
+  else if(spec.yearly){
+    out[0] = y_val;
+    return true;
+  }
+  return false;
+}
+
+// A single value per timestep, with the daily values for the current
+// month held in a [31] array
+bool daily_monthly_or_yearly(const OutputSpec& spec, int month,
+                             const double* daily, double m_val,
+                             double y_val, double* out) {
+  if(spec.daily){
+    std::memcpy(out, daily, DINM[month]*sizeof(double));
+    return true;
+  }
+  return monthly_or_yearly(spec, m_val, y_val, out);
+}
+
+template <typename T>
+void copy_values(const T* src, int count, double* out) {
+  for(int ii=0; ii<count; ii++){
+    out[ii] = src[ii];
+  }
+}
+
+// One value per layer, from the monthly or yearly data
+template <typename T>
+bool monthly_or_yearly_layers(const OutputSpec& spec, const T* m_arr,
+                              const T* y_arr, int count, double* out) {
+  if(spec.monthly){
+    copy_values(m_arr, count, out);
+    return true;
+  }
+  else if(spec.yearly){
+    copy_values(y_arr, count, out);
+    return true;
+  }
+  return false;
+}
+
+// One value per layer per day, from a [31][N] daily array
+template <typename T, int N>
+bool daily_layers(const OutputSpec& spec, int month, const T (*daily)[N],
+                  double* out) {
+  if(!spec.daily){
+    return false;
+  }
+  copy_values(&daily[0][0], DINM[month]*N, out);
+  return true;
+}
+
+// Either the per layer values or the soil column total
+bool layer_or_total(const OutputSpec& spec, const double* m_arr,
+                    const double* y_arr, double m_tot, double y_tot,
+                    double* out) {
+  if(spec.layer){
+    return monthly_or_yearly_layers(spec, m_arr, y_arr, MAX_SOI_LAY, out);
+  }
+  return monthly_or_yearly(spec, m_tot, y_tot, out);
+}
+
+enum PftMask {
+  ALL_PFTS,
+  EXISTING_PFTS, // Only PFTs with vegetation cover
+  VASCULAR_PFTS  // Skip moss and lichen
+};
+
+bool pft_included(Cohort& cohort, int ip, PftMask mask) {
+  if(mask == EXISTING_PFTS){
+    return cohort.cd.m_veg.vegcov[ip] > 0.;
+  }
+  else if(mask == VASCULAR_PFTS){
+    return cohort.cd.m_veg.nonvascular[ip] == 0;
+  }
+  return true;
+}
+
+/** BgcData values that are available by PFT and by compartment. The
+ *  'flux' members select the monthly or yearly struct, 'part' the per
+ *  compartment array in it and 'all' the sum over compartments. PFTs
+ *  excluded by the mask are output as zero and left out of the sums.
+ *  The total over PFTs comes from bdall unless 'total_from_pfts' is set,
+ *  in which case it is the (masked) sum of the PFT values.
+ */
+template <typename FLUX>
+bool by_pft_and_compartment(Cohort& cohort, const OutputSpec& spec,
+                            FLUX BgcData::* m_flux, FLUX BgcData::* y_flux,
+                            double (FLUX::* part)[NUM_PFT_PART],
+                            double FLUX::* all, PftMask mask,
+                            bool total_from_pfts, double* out) {
+  FLUX BgcData::* flux;
+  if(spec.monthly){
+    flux = m_flux;
+  }
+  else if(spec.yearly){
+    flux = y_flux;
+  }
+  else{
+    return false;
+  }
+
+  //PFT and compartment
+  if(spec.pft && spec.compartment){
+    for(int ipp=0; ipp<NUM_PFT_PART; ipp++){
+      for(int ip=0; ip<NUM_PFT; ip++){
+        out[ipp*NUM_PFT + ip] = pft_included(cohort, ip, mask) ?
+                                ((cohort.bd[ip].*flux).*part)[ipp] : 0.;
+      }
+    }
+  }
+  //PFT only
+  else if(spec.pft){
+    for(int ip=0; ip<NUM_PFT; ip++){
+      out[ip] = pft_included(cohort, ip, mask) ?
+                (cohort.bd[ip].*flux).*all : 0.;
+    }
+  }
+  //Compartment only
+  else if(spec.compartment){
+    for(int ipp=0; ipp<NUM_PFT_PART; ipp++){
+      double sum = 0.;
+      for(int ip=0; ip<NUM_PFT; ip++){
+        if(pft_included(cohort, ip, mask)){
+          sum += ((cohort.bd[ip].*flux).*part)[ipp];
+        }
+      }
+      out[ipp] = sum;
+    }
+  }
+  //Neither PFT nor compartment - total
+  else if(total_from_pfts){
+    double sum = 0.;
+    for(int ip=0; ip<NUM_PFT; ip++){
+      if(pft_included(cohort, ip, mask)){
+        sum += (cohort.bd[ip].*flux).*all;
+      }
+    }
+    out[0] = sum;
+  }
+  else{
+    out[0] = (cohort.bdall->*flux).*all;
+  }
+  return true;
+}
+
+// BgcData values that are available by PFT, but not by compartment
+template <typename FLUX>
+bool by_pft(Cohort& cohort, const OutputSpec& spec,
+            FLUX BgcData::* m_flux, FLUX BgcData::* y_flux,
+            double FLUX::* value, double* out) {
+  if(spec.compartment){
+    return false;
+  }
+
+  FLUX BgcData::* flux;
+  if(spec.monthly){
+    flux = m_flux;
+  }
+  else if(spec.yearly){
+    flux = y_flux;
+  }
+  else{
+    return false;
+  }
+
+  if(spec.pft){
+    for(int ip=0; ip<NUM_PFT; ip++){
+      out[ip] = (cohort.bd[ip].*flux).*value;
+    }
+  }
+  else{
+    out[0] = (cohort.bdall->*flux).*value;
+  }
+  return true;
+}
+
+// Fire values for the month, or summed over the year
+template <typename FLUX>
+bool fire_monthly_or_summed(Cohort& cohort, const OutputSpec& spec, int month,
+                            FLUX FirData::* flux, double FLUX::* value,
+                            double* out) {
+  if(spec.monthly){
+    out[0] = cohort.year_fd[month].*flux.*value;
+    return true;
+  }
+  else if(spec.yearly){
+    double sum = 0.;
+    for(int im=0; im<MINY; im++){
+      sum += cohort.year_fd[im].*flux.*value;
+    }
+    out[0] = sum;
+    return true;
+  }
+  return false;
+}
+
+// Fire values for the month, or the yearly value from fd
+template <typename FLUX>
+bool fire_monthly_or_yearly(Cohort& cohort, const OutputSpec& spec, int month,
+                            FLUX FirData::* flux, double FLUX::* value,
+                            double* out) {
+  return monthly_or_yearly(spec, cohort.year_fd[month].*flux.*value,
+                           cohort.fd->*flux.*value, out);
+}
+
+// Driving data is stored as float, so sums are kept as float as well
+bool driving_data(Cohort& cohort, const OutputSpec& spec, int month,
+                  const std::vector<float>& daily, bool summable,
+                  double* out) {
+  int doy = temutil::day_of_year(month, 0);
+  if(spec.daily){
+    for(int id=0; id<DINM[month]; id++){
+      out[id] = daily[doy+id];
+    }
+    return true;
+  }
+  else if(summable && spec.monthly){
+    float sum = 0;
+    for(int id=0; id<DINM[month]; id++){
+      sum += daily[doy+id];
+    }
+    out[0] = sum;
+    return true;
+  }
+  else if(summable && spec.yearly){
+    float sum = 0;
+    for(int id=0; id<DINY; id++){
+      sum += daily[id];
+    }
+    out[0] = sum;
+    return true;
+  }
+  return false;
+}
+
+enum LayerKind { MOSS_LAYERS, FIBRIC_LAYERS, HUMIC_LAYERS };
+
+double thickness_of(Cohort& cohort, LayerKind kind) {
+  double dz = 0;
+  Layer* currL = cohort.ground.toplayer;
+  while(currL!=NULL){
+    if((kind == MOSS_LAYERS && currL->isMoss)
+       || (kind == FIBRIC_LAYERS && currL->isFibric)
+       || (kind == HUMIC_LAYERS && currL->isHumic)){
+      dz += currL->dz;
+    }
+    currL = currL->nextl;
+  }
+  return dz;
+}
+
+double snow_thickness(Cohort& cohort) {
+  double snowthick = 0.;
+  Layer* currL = cohort.ground.toplayer;
+  while(currL->isSnow){
+    snowthick += currL->dz;
+    currL = currL->nextl;
+  }
+  return snowthick;
+}
+
+// Soil organic carbon in the frozen or unfrozen fraction of the soil
+double soc_by_frozen_state(Cohort& cohort, bool frozen) {
+  double soc = 0.0;
+  Layer* currl = cohort.ground.fstsoill;
+  while(currl != NULL && currl != cohort.ground.lstsoill){
+    double layerC = currl->rawc + currl->soma
+                  + currl->sompr + currl->somcr;
+    if(frozen){
+      soc += currl->frozenfrac * layerC;
+    }
+    else{
+      soc += (1 - currl->frozenfrac) * layerC;
+    }
+    currl = currl->nextl;
+  }
+  return soc;
+}
+
+bool snow_layers(Cohort& cohort, const OutputSpec& spec, bool temperature,
+                 double* out) {
+  if(!spec.monthly && !spec.yearly){
+    return false;
+  }
+  for(int il=0; il<MAX_SNW_LAY; il++){
+    out[il] = 0.;
+  }
+  Layer* currL = cohort.ground.toplayer;
+  while(currL->isSnow){
+    out[currL->indl-1] = temperature ? currL->tem : currL->dz;
+    currL = currL->nextl;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////
+// Fill functions, one per variable
+/////////////////////////////////////////////////////////////////////
+
+bool fill_ald(Cohort& c, const OutputSpec& s, int m, double* out) {
+  out[0] = c.edall->y_soid.ald;
+  return true;
+}
+
+bool fill_avln(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return layer_or_total(s, c.bdall->m_sois.avln, c.bdall->y_sois.avln,
+                        c.bdall->m_soid.avlnsum, c.bdall->y_soid.avlnsum, out);
+}
+
+bool fill_burnair2soiln(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return fire_monthly_or_summed(c, s, m, &FirData::fire_a2soi,
+                                &atm2soi_fir::orgn, out);
+}
+
+bool fill_burnsoil2airc(Cohort& c, const OutputSpec& s, int m, double* out) {
+  if(s.layer){
+    return false;
+  }
+  return fire_monthly_or_summed(c, s, m, &FirData::fire_soi2a,
+                                &soi2atm_fir::orgc, out);
+}
+
+bool fill_burnsoil2airn(Cohort& c, const OutputSpec& s, int m, double* out) {
+  if(s.layer){
+    return false;
+  }
+  return fire_monthly_or_summed(c, s, m, &FirData::fire_soi2a,
+                                &soi2atm_fir::orgn, out);
+}
+
+bool fill_burnthick(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return fire_monthly_or_summed(c, s, m, &FirData::fire_soid,
+                                &soidiag_fir::burnthick, out);
+}
+
+bool fill_burnveg2airc(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return fire_monthly_or_summed(c, s, m, &FirData::fire_v2a,
+                                &veg2atm_fir::orgc, out);
+}
+
+bool fill_burnveg2airn(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return fire_monthly_or_yearly(c, s, m, &FirData::fire_v2a,
+                                &veg2atm_fir::orgn, out);
+}
+
+bool fill_burnveg2deadc(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return fire_monthly_or_yearly(c, s, m, &FirData::fire_v2dead,
+                                &veg2dead_fir::vegC, out);
+}
+
+bool fill_burnveg2deadn(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return fire_monthly_or_yearly(c, s, m, &FirData::fire_v2dead,
+                                &veg2dead_fir::strN, out);
+}
+
+bool fill_burnveg2soilabvc(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return fire_monthly_or_yearly(c, s, m, &FirData::fire_v2soi,
+                                &veg2soi_fir::abvc, out);
+}
+
+bool fill_burnveg2soilabvn(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return fire_monthly_or_yearly(c, s, m, &FirData::fire_v2soi,
+                                &veg2soi_fir::abvn, out);
+}
+
+bool fill_burnveg2soilblwc(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return fire_monthly_or_yearly(c, s, m, &FirData::fire_v2soi,
+                                &veg2soi_fir::blwc, out);
+}
+
+bool fill_burnveg2soilblwn(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return fire_monthly_or_yearly(c, s, m, &FirData::fire_v2soi,
+                                &veg2soi_fir::blwn, out);
+}
+
+bool fill_cmtnum(Cohort& c, const OutputSpec& s, int m, double* out) {
+  out[0] = temutil::cmtcode2num(c.chtlu.cmtcode);
+  return true;
+}
+
+bool fill_deadc(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return monthly_or_yearly(s, c.bdall->m_vegs.deadc, c.bdall->y_vegs.deadc, out);
+}
+
+bool fill_deadn(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return monthly_or_yearly(s, c.bdall->m_vegs.deadn, c.bdall->y_vegs.deadn, out);
+}
+
+bool fill_deepc(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return monthly_or_yearly(s, c.bdall->m_soid.deepc, c.bdall->y_soid.deepc, out);
+}
+
+bool fill_deepdz(Cohort& c, const OutputSpec& s, int m, double* out) {
+  out[0] = thickness_of(c, HUMIC_LAYERS);
+  return true;
+}
+
+bool fill_drivingnirr(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return driving_data(c, s, m, c.climate.nirr_d, false, out);
+}
+
+bool fill_drivingrainfall(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return driving_data(c, s, m, c.climate.rain_d, true, out);
+}
+
+bool fill_drivingsnowfall(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return driving_data(c, s, m, c.climate.snow_d, true, out);
+}
+
+bool fill_drivingtair(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return driving_data(c, s, m, c.climate.tair_d, false, out);
+}
+
+bool fill_drivingvapo(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return driving_data(c, s, m, c.climate.vapo_d, false, out);
+}
+
+bool fill_dwdc(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return monthly_or_yearly(s, c.bdall->m_sois.wdebrisc, c.bdall->y_sois.wdebrisc, out);
+}
+
+bool fill_dwdn(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return monthly_or_yearly(s, c.bdall->m_sois.wdebrisn, c.bdall->y_sois.wdebrisn, out);
+}
+
+//By PFT is disabled for EET and PET because the PFT values include soil
+// and snow evaporation, which throws off results if they are summed.
+bool fill_eet(Cohort& c, const OutputSpec& s, int m, double* out) {
+  if(s.pft){
+    return false;
+  }
+  if(s.daily){
+    for(int id=0; id<DINM[m]; id++){
+      double daily_eet_tot = 0.;
+      for(int ip=0; ip<NUM_PFT; ip++){
+        daily_eet_tot += c.ed[ip].daily_eet[id];
+      }
+      out[id] = daily_eet_tot;
+    }
+    return true;
+  }
+  return monthly_or_yearly(s, c.edall->m_l2a.eet, c.edall->y_l2a.eet, out);
+}
+
+bool fill_frontsdepth(Cohort& c, const OutputSpec& s, int m, double* out) {
+  if(s.daily){
+    return daily_layers(s, m, c.edall->daily_frontsdepth, out);
+  }
+  return monthly_or_yearly_layers(s, c.ground.frntz, c.ground.frntz,
+                                  MAX_NUM_FNT, out);
+}
+
+bool fill_frontstype(Cohort& c, const OutputSpec& s, int m, double* out) {
+  if(s.daily){
+    return daily_layers(s, m, c.edall->daily_frontstype, out);
+  }
+  return monthly_or_yearly_layers(s, c.ground.frnttype, c.ground.frnttype,
+                                  MAX_NUM_FNT, out);
+}
+
+bool fill_gpp(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return by_pft_and_compartment(c, s, &BgcData::m_a2v, &BgcData::y_a2v,
+                                &atm2veg_bgc::gpp, &atm2veg_bgc::gppall,
+                                ALL_PFTS, false, out);
+}
+
+bool fill_growend(Cohort& c, const OutputSpec& s, int m, double* out) {
+  out[0] = c.edall->y_soid.rtdpGEoutput;
+  return true;
+}
+
+bool fill_growstart(Cohort& c, const OutputSpec& s, int m, double* out) {
+  out[0] = c.edall->y_soid.rtdpGSoutput;
+  return true;
+}
+
+bool fill_hkdeep(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_monthly_or_yearly(s, m, c.edall->daily_hkdeep,
+      c.edall->m_soid.hkdeep, c.edall->y_soid.hkdeep, out);
+}
+
+bool fill_hklayer(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return monthly_or_yearly_layers(s, c.edall->m_soid.hcond,
+                                  c.edall->y_soid.hcond, MAX_SOI_LAY, out);
+}
+
+bool fill_hkminea(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_monthly_or_yearly(s, m, c.edall->daily_hkminea,
+      c.edall->m_soid.hkminea, c.edall->y_soid.hkminea, out);
+}
+
+bool fill_hkmineb(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_monthly_or_yearly(s, m, c.edall->daily_hkmineb,
+      c.edall->m_soid.hkmineb, c.edall->y_soid.hkmineb, out);
+}
+
+bool fill_hkminec(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_monthly_or_yearly(s, m, c.edall->daily_hkminec,
+      c.edall->m_soid.hkminec, c.edall->y_soid.hkminec, out);
+}
+
+bool fill_hkshlw(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_monthly_or_yearly(s, m, c.edall->daily_hkshlw,
+      c.edall->m_soid.hkshlw, c.edall->y_soid.hkshlw, out);
+}
+
+bool fill_ingpp(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return by_pft_and_compartment(c, s, &BgcData::m_a2v, &BgcData::y_a2v,
+                                &atm2veg_bgc::ingpp, &atm2veg_bgc::ingppall,
+                                ALL_PFTS, false, out);
+}
+
+bool fill_innpp(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return by_pft_and_compartment(c, s, &BgcData::m_a2v, &BgcData::y_a2v,
+                                &atm2veg_bgc::innpp, &atm2veg_bgc::innppall,
+                                ALL_PFTS, false, out);
+}
+
+bool fill_innuptake(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return by_pft(c, s, &BgcData::m_soi2v, &BgcData::y_soi2v,
+                &soi2veg_bgc::innuptake, out);
+}
+
+bool fill_iwclayer(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return monthly_or_yearly_layers(s, c.edall->m_soid.iwc,
+                                  c.edall->y_soid.iwc, MAX_SOI_LAY, out);
+}
+
+bool fill_lai(Cohort& c, const OutputSpec& s, int m, double* out) {
+  if(s.pft){
+    return monthly_or_yearly_layers(s, c.cd.m_veg.lai, c.cd.y_veg.lai,
+                                    NUM_PFT, out);
+  }
+  double m_lai_total = 0., y_lai_total = 0.;
+  for(int ip=0; ip<NUM_PFT; ip++){
+    if(c.cd.m_veg.vegcov[ip]>0.){
+      m_lai_total += c.cd.m_veg.lai[ip];
+      y_lai_total += c.cd.y_veg.lai[ip];
+    }
+  }
+  return monthly_or_yearly(s, m_lai_total, y_lai_total, out);
+}
+
+bool fill_layerdepth(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return monthly_or_yearly_layers(s, c.cd.m_soil.z, c.cd.y_soil.z,
+                                  MAX_SOI_LAY, out);
+}
+
+bool fill_layerdz(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return monthly_or_yearly_layers(s, c.cd.m_soil.dz, c.cd.y_soil.dz,
+                                  MAX_SOI_LAY, out);
+}
+
+bool fill_layertype(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return monthly_or_yearly_layers(s, c.cd.m_soil.type, c.cd.y_soil.type,
+                                  MAX_SOI_LAY, out);
+}
+
+bool fill_lfnvc(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return monthly_or_yearly(s, c.bdall->m_v2soi.mossdeathc,
+                           c.bdall->y_v2soi.mossdeathc, out);
+}
+
+bool fill_lfnvn(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return monthly_or_yearly(s, c.bdall->m_v2soi.mossdeathn,
+                           c.bdall->y_v2soi.mossdeathn, out);
+}
+
+bool fill_lfvc(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return by_pft_and_compartment(c, s, &BgcData::m_v2soi, &BgcData::y_v2soi,
+                                &veg2soi_bgc::ltrfalc, &veg2soi_bgc::ltrfalcall,
+                                VASCULAR_PFTS, true, out);
+}
+
+bool fill_lfvn(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return by_pft_and_compartment(c, s, &BgcData::m_v2soi, &BgcData::y_v2soi,
+                                &veg2soi_bgc::ltrfaln, &veg2soi_bgc::ltrfalnall,
+                                VASCULAR_PFTS, true, out);
+}
+
+bool fill_lwclayer(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return monthly_or_yearly_layers(s, c.edall->m_soid.lwc,
+                                  c.edall->y_soid.lwc, MAX_SOI_LAY, out);
+}
+
+bool fill_minec(Cohort& c, const OutputSpec& s, int m, double* out) {
+  double m_minec = c.bdall->m_soid.mineac
+                 + c.bdall->m_soid.minebc
+                 + c.bdall->m_soid.minecc;
+  double y_minec = c.bdall->y_soid.mineac
+                 + c.bdall->y_soid.minebc
+                 + c.bdall->y_soid.minecc;
+  return monthly_or_yearly(s, m_minec, y_minec, out);
+}
+
+bool fill_mossdz(Cohort& c, const OutputSpec& s, int m, double* out) {
+  out[0] = thickness_of(c, MOSS_LAYERS);
+  return true;
+}
+
+//Drainage N is only worked out inside Soil_Bgc and never stored, so
+// there is nothing to output yet. The variable is left as fill values.
+bool fill_ndrain(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return false;
+}
+
+bool fill_netnmin(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return layer_or_total(s, c.bdall->m_soi2soi.netnmin, c.bdall->y_soi2soi.netnmin,
+                        c.bdall->m_soi2soi.netnminsum,
+                        c.bdall->y_soi2soi.netnminsum, out);
+}
+
+bool fill_nimmob(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return layer_or_total(s, c.bdall->m_soi2soi.nimmob, c.bdall->y_soi2soi.nimmob,
+                        c.bdall->m_soi2soi.nimmobsum,
+                        c.bdall->y_soi2soi.nimmobsum, out);
+}
+
+bool fill_ninput(Cohort& c, const OutputSpec& s, int m, double* out) {
+  if(s.layer){
+    return false;
+  }
+  return monthly_or_yearly(s, c.bdall->m_a2soi.avlninput,
+                           c.bdall->y_a2soi.avlninput, out);
+}
+
+bool fill_nlost(Cohort& c, const OutputSpec& s, int m, double* out) {
+  double m_nlost = c.bdall->m_soi2l.avlnlost
+                 + c.bdall->m_soi2l.orgnlost;
+  double y_nlost = c.bdall->y_soi2l.avlnlost
+                 + c.bdall->y_soi2l.orgnlost;
+  return monthly_or_yearly(s, m_nlost, y_nlost, out);
+}
+
+bool fill_npp(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return by_pft_and_compartment(c, s, &BgcData::m_a2v, &BgcData::y_a2v,
+                                &atm2veg_bgc::npp, &atm2veg_bgc::nppall,
+                                ALL_PFTS, false, out);
+}
+
+//N requirement is only kept for the current month, in the scratch
+// vegetation state, so the same value is given monthly and yearly.
+bool fill_nreq(Cohort& c, const OutputSpec& s, int m, double* out) {
+  if(!s.pft || !s.compartment || s.daily){
+    return false;
+  }
+  for(int ipp=0; ipp<NUM_PFT_PART; ipp++){
+    for(int ip=0; ip<NUM_PFT; ip++){
+      out[ipp*NUM_PFT + ip] = c.vegbgc[ip].tmp_vegs.nreq[ipp];
+    }
+  }
+  return true;
+}
+
+bool fill_nresorb(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return by_pft_and_compartment(c, s, &BgcData::m_v2v, &BgcData::y_v2v,
+                                &veg2veg_bgc::nresorb, &veg2veg_bgc::nresorball,
+                                ALL_PFTS, false, out);
+}
+
+bool fill_nuptakelab(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return by_pft(c, s, &BgcData::m_soi2v, &BgcData::y_soi2v,
+                &soi2veg_bgc::lnuptake, out);
+}
+
+bool fill_nuptakest(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return by_pft_and_compartment(c, s, &BgcData::m_soi2v, &BgcData::y_soi2v,
+                                &soi2veg_bgc::snuptake, &soi2veg_bgc::snuptakeall,
+                                ALL_PFTS, false, out);
+}
+
+bool fill_orgn(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return layer_or_total(s, c.bdall->m_sois.orgn, c.bdall->y_sois.orgn,
+                        c.bdall->m_soid.orgnsum, c.bdall->y_soid.orgnsum, out);
+}
+
+bool fill_percolation(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_layers(s, m, c.edall->daily_percolation, out);
+}
+
+bool fill_permafrost(Cohort& c, const OutputSpec& s, int m, double* out) {
+  out[0] = c.edall->y_soid.permafrost;
+  return true;
+}
+
+bool fill_pet(Cohort& c, const OutputSpec& s, int m, double* out) {
+  if(s.pft){
+    return false;
+  }
+  if(s.daily){
+    for(int id=0; id<DINM[m]; id++){
+      double daily_pet_tot = 0.;
+      for(int ip=0; ip<NUM_PFT; ip++){
+        daily_pet_tot += c.ed[ip].daily_pet[id];
+      }
+      out[id] = daily_pet_tot;
+    }
+    return true;
+  }
+  return monthly_or_yearly(s, c.edall->m_l2a.pet, c.edall->y_l2a.pet, out);
+}
+
+bool fill_qdrainage(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_monthly_or_yearly(s, m, c.edall->daily_qdrain,
+      c.edall->m_soi2l.qdrain, c.edall->y_soi2l.qdrain, out);
+}
+
+bool fill_qdrainlayer(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_layers(s, m, c.edall->daily_layer_drain, out);
+}
+
+bool fill_qinfiltration(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_monthly_or_yearly(s, m, c.edall->daily_qinfl,
+      c.edall->m_soi2l.qinfl, c.edall->y_soi2l.qinfl, out);
+}
+
+bool fill_qrunoff(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_monthly_or_yearly(s, m, c.edall->daily_qover,
+      c.edall->m_soi2l.qover, c.edall->y_soi2l.qover, out);
+}
+
+bool fill_rainfall(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return monthly_or_yearly(s, c.edall->m_a2l.rnfl, c.edall->y_a2l.rnfl, out);
+}
+
+bool fill_reco(Cohort& c, const OutputSpec& s, int m, double* out) {
+  double m_reco = c.bdall->m_soi2a.rhsom
+                + c.bdall->m_soi2a.rhwdeb
+                + c.bdall->m_v2a.rmall
+                + c.bdall->m_v2a.rgall;
+  double y_reco = c.bdall->y_soi2a.rhsom
+                + c.bdall->y_soi2a.rhwdeb
+                + c.bdall->y_v2a.rmall
+                + c.bdall->y_v2a.rgall;
+  return monthly_or_yearly(s, m_reco, y_reco, out);
+}
+
+bool fill_rg(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return by_pft_and_compartment(c, s, &BgcData::m_v2a, &BgcData::y_v2a,
+                                &veg2atm_bgc::rg, &veg2atm_bgc::rgall,
+                                ALL_PFTS, false, out);
+}
+
+bool fill_rhdwd(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return monthly_or_yearly(s, c.bdall->m_soi2a.rhwdeb, c.bdall->y_soi2a.rhwdeb, out);
+}
+
+bool fill_rhsom(Cohort& c, const OutputSpec& s, int m, double* out) {
+  if(s.layer){
+    if(!s.monthly && !s.yearly){
+      return false;
+    }
+    const soi2atm_bgc& rh = s.monthly ? c.bdall->m_soi2a : c.bdall->y_soi2a;
+    for(int il=0; il<MAX_SOI_LAY; il++){
+      out[il] = rh.rhrawc[il]
+              + rh.rhsoma[il]
+              + rh.rhsompr[il]
+              + rh.rhsomcr[il];
+    }
+    return true;
+  }
+  return monthly_or_yearly(s, c.bdall->m_soi2a.rhsom, c.bdall->y_soi2a.rhsom, out);
+}
+
+bool fill_rm(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return by_pft_and_compartment(c, s, &BgcData::m_v2a, &BgcData::y_v2a,
+                                &veg2atm_bgc::rm, &veg2atm_bgc::rmall,
+                                ALL_PFTS, false, out);
+}
+
+bool fill_rolb(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return fire_monthly_or_yearly(c, s, m, &FirData::fire_soid,
+                                &soidiag_fir::rolb, out);
+}
+
+bool fill_rootwateruptake(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_layers(s, m, c.edall->daily_root_water_uptake, out);
+}
+
+bool fill_shlwc(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return monthly_or_yearly(s, c.bdall->m_soid.shlwc, c.bdall->y_soid.shlwc, out);
+}
+
+bool fill_shlwdz(Cohort& c, const OutputSpec& s, int m, double* out) {
+  out[0] = thickness_of(c, FIBRIC_LAYERS);
+  return true;
+}
+
+bool fill_snowend(Cohort& c, const OutputSpec& s, int m, double* out) {
+  out[0] = c.edall->y_snws.snowend;
+  return true;
+}
+
+bool fill_snowfall(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return monthly_or_yearly(s, c.edall->m_a2l.snfl, c.edall->y_a2l.snfl, out);
+}
+
+bool fill_snowlayerdz(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return snow_layers(c, s, false, out);
+}
+
+bool fill_snowlayertemp(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return snow_layers(c, s, true, out);
+}
+
+bool fill_snowstart(Cohort& c, const OutputSpec& s, int m, double* out) {
+  out[0] = c.edall->y_snws.snowstart;
+  return true;
+}
+
+bool fill_snowthick(Cohort& c, const OutputSpec& s, int m, double* out) {
+  if(s.daily){
+    std::memcpy(out, c.edall->daily_snowthick, DINM[m]*sizeof(double));
+    return true;
+  }
+  double snowthick = snow_thickness(c);
+  return monthly_or_yearly(s, snowthick, snowthick, out);
+}
+
+bool fill_soc(Cohort& c, const OutputSpec& s, int m, double* out) {
+  if(!s.monthly && !s.yearly){
+    return false;
+  }
+  const soistate_bgc& sois = s.monthly ? c.bdall->m_sois : c.bdall->y_sois;
+  if(s.layer){
+    for(int il=0; il<MAX_SOI_LAY; il++){
+      out[il] = sois.rawc[il]
+              + sois.soma[il]
+              + sois.sompr[il]
+              + sois.somcr[il];
+    }
+  }
+  else{
+    double soc_tot = 0.0;
+    for(int il=0; il<MAX_SOI_LAY; il++){
+      soc_tot += sois.rawc[il]
+               + sois.soma[il]
+               + sois.sompr[il]
+               + sois.somcr[il];
+    }
+    out[0] = soc_tot;
+  }
+  return true;
+}
+
+bool soc_to_depth(Cohort& c, const OutputSpec& s, double depth, double* out) {
+  if(!s.monthly && !s.yearly){
+    return false;
+  }
+  out[0] = c.ground.getCarbonForDepthRange(0.0, depth);
+  return true;
+}
+
+bool fill_soc0_30cm(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return soc_to_depth(c, s, 0.3, out);
+}
+
+bool fill_soc0_100cm(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return soc_to_depth(c, s, 1.0, out);
+}
+
+bool fill_soc0_200cm(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return soc_to_depth(c, s, 2.0, out);
+}
+
+bool fill_soc0_300cm(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return soc_to_depth(c, s, 3.0, out);
+}
+
+bool fill_socfrozen(Cohort& c, const OutputSpec& s, int m, double* out) {
+  double frozenC = soc_by_frozen_state(c, true);
+  return monthly_or_yearly(s, frozenC, frozenC, out);
+}
+
+bool fill_socunfrozen(Cohort& c, const OutputSpec& s, int m, double* out) {
+  double unfrozenC = soc_by_frozen_state(c, false);
+  return monthly_or_yearly(s, unfrozenC, unfrozenC, out);
+}
+
+bool fill_soma(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return layer_or_total(s, c.bdall->m_sois.soma, c.bdall->y_sois.soma,
+                        c.bdall->m_soid.somasum, c.bdall->y_soid.somasum, out);
+}
+
+bool fill_somcr(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return layer_or_total(s, c.bdall->m_sois.somcr, c.bdall->y_sois.somcr,
+                        c.bdall->m_soid.somcrsum, c.bdall->y_soid.somcrsum, out);
+}
+
+bool fill_sompr(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return layer_or_total(s, c.bdall->m_sois.sompr, c.bdall->y_sois.sompr,
+                        c.bdall->m_soid.somprsum, c.bdall->y_soid.somprsum, out);
+}
+
+bool fill_somrawc(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return layer_or_total(s, c.bdall->m_sois.rawc, c.bdall->y_sois.rawc,
+                        c.bdall->m_soid.rawcsum, c.bdall->y_soid.rawcsum, out);
+}
+
+bool fill_swe(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_monthly_or_yearly(s, m, c.edall->daily_swesum,
+      c.edall->m_snws.swesum, c.edall->y_snws.swesum, out);
+}
+
+bool fill_tcdeep(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_monthly_or_yearly(s, m, c.edall->daily_tcdeep,
+      c.edall->m_soid.tcdeep, c.edall->y_soid.tcdeep, out);
+}
+
+bool fill_tclayer(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return monthly_or_yearly_layers(s, c.edall->m_soid.tcond,
+                                  c.edall->y_soid.tcond, MAX_SOI_LAY, out);
+}
+
+bool fill_tcminea(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_monthly_or_yearly(s, m, c.edall->daily_tcminea,
+      c.edall->m_soid.tcminea, c.edall->y_soid.tcminea, out);
+}
+
+bool fill_tcmineb(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_monthly_or_yearly(s, m, c.edall->daily_tcmineb,
+      c.edall->m_soid.tcmineb, c.edall->y_soid.tcmineb, out);
+}
+
+bool fill_tcminec(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_monthly_or_yearly(s, m, c.edall->daily_tcminec,
+      c.edall->m_soid.tcminec, c.edall->y_soid.tcminec, out);
+}
+
+bool fill_tcshlw(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_monthly_or_yearly(s, m, c.edall->daily_tcshlw,
+      c.edall->m_soid.tcshlw, c.edall->y_soid.tcshlw, out);
+}
+
+bool fill_tdeep(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_monthly_or_yearly(s, m, c.edall->daily_tdeep,
+      c.edall->m_soid.tdeep, c.edall->y_soid.tdeep, out);
+}
+
+bool fill_tlayer(Cohort& c, const OutputSpec& s, int m, double* out) {
+  if(s.daily){
+    return daily_layers(s, m, c.edall->daily_tlayer, out);
+  }
+  return monthly_or_yearly_layers(s, c.edall->m_sois.ts, c.edall->y_sois.ts,
+                                  MAX_SOI_LAY, out);
+}
+
+bool fill_tminea(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_monthly_or_yearly(s, m, c.edall->daily_tminea,
+      c.edall->m_soid.tminea, c.edall->y_soid.tminea, out);
+}
+
+bool fill_tmineb(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_monthly_or_yearly(s, m, c.edall->daily_tmineb,
+      c.edall->m_soid.tmineb, c.edall->y_soid.tmineb, out);
+}
+
+bool fill_tminec(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_monthly_or_yearly(s, m, c.edall->daily_tminec,
+      c.edall->m_soid.tminec, c.edall->y_soid.tminec, out);
+}
+
+bool fill_transpiration(Cohort& c, const OutputSpec& s, int m, double* out) {
+  if(s.pft){
+    if(s.daily){
+      for(int id=0; id<DINM[m]; id++){
+        for(int ip=0; ip<NUM_PFT; ip++){
+          out[id*NUM_PFT + ip] = c.ed[ip].daily_tran[id];
+        }
+      }
+      return true;
+    }
+    if(!s.monthly && !s.yearly){
+      return false;
+    }
+    for(int ip=0; ip<NUM_PFT; ip++){
+      out[ip] = s.monthly ? c.ed[ip].m_v2a.tran : c.ed[ip].y_v2a.tran;
+    }
+    return true;
+  }
+  return daily_monthly_or_yearly(s, m, c.edall->daily_tran,
+      c.edall->m_v2a.tran, c.edall->y_v2a.tran, out);
+}
+
+bool fill_tshlw(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_monthly_or_yearly(s, m, c.edall->daily_tshlw,
+      c.edall->m_soid.tshlw, c.edall->y_soid.tshlw, out);
+}
+
+bool tsoil_at_depth(Cohort& c, const OutputSpec& s, double depth, double* out) {
+  if(!s.monthly && !s.yearly){
+    return false;
+  }
+  out[0] = c.edall->getTempAtDepthFromArray(depth);
+  return true;
+}
+
+bool fill_tsoil_30cm(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return tsoil_at_depth(c, s, 0.3, out);
+}
+
+bool fill_tsoil_100cm(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return tsoil_at_depth(c, s, 1.0, out);
+}
+
+bool fill_tsoil_200cm(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return tsoil_at_depth(c, s, 2.0, out);
+}
+
+bool fill_tsoil_300cm(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return tsoil_at_depth(c, s, 3.0, out);
+}
+
+bool fill_vegc(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return by_pft_and_compartment(c, s, &BgcData::m_vegs, &BgcData::y_vegs,
+                                &vegstate_bgc::c, &vegstate_bgc::call,
+                                EXISTING_PFTS, false, out);
+}
+
+bool fill_vegnlab(Cohort& c, const OutputSpec& s, int m, double* out) {
+  if(s.pft || s.compartment){
+    return false;
+  }
+  return monthly_or_yearly(s, c.bdall->m_vegs.labn, c.bdall->y_vegs.labn, out);
+}
+
+bool fill_vegnstr(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return by_pft_and_compartment(c, s, &BgcData::m_vegs, &BgcData::y_vegs,
+                                &vegstate_bgc::strn, &vegstate_bgc::strnall,
+                                EXISTING_PFTS, false, out);
+}
+
+bool fill_vegntot(Cohort& c, const OutputSpec& s, int m, double* out) {
+  if(s.pft || s.compartment){
+    return false;
+  }
+  return monthly_or_yearly(s, c.bdall->m_vegs.nall, c.bdall->y_vegs.nall, out);
+}
+
+bool vwc_at_depth(Cohort& c, const OutputSpec& s, double depth, double* out) {
+  if(!s.monthly && !s.yearly){
+    return false;
+  }
+  out[0] = c.edall->getVWCAtDepthFromArray(depth);
+  return true;
+}
+
+bool fill_vwc_30cm(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return vwc_at_depth(c, s, 0.3, out);
+}
+
+bool fill_vwc_100cm(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return vwc_at_depth(c, s, 1.0, out);
+}
+
+bool fill_vwc_200cm(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return vwc_at_depth(c, s, 2.0, out);
+}
+
+bool fill_vwc_300cm(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return vwc_at_depth(c, s, 3.0, out);
+}
+
+bool fill_vwcdeep(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_monthly_or_yearly(s, m, c.edall->daily_vwcdeep,
+      c.edall->m_soid.vwcdeep, c.edall->y_soid.vwcdeep, out);
+}
+
+bool fill_vwclayer(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return monthly_or_yearly_layers(s, c.edall->m_soid.vwc,
+                                  c.edall->y_soid.vwc, MAX_SOI_LAY, out);
+}
+
+bool fill_vwcminea(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_monthly_or_yearly(s, m, c.edall->daily_vwcminea,
+      c.edall->m_soid.vwcminea, c.edall->y_soid.vwcminea, out);
+}
+
+bool fill_vwcmineb(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_monthly_or_yearly(s, m, c.edall->daily_vwcmineb,
+      c.edall->m_soid.vwcmineb, c.edall->y_soid.vwcmineb, out);
+}
+
+bool fill_vwcminec(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_monthly_or_yearly(s, m, c.edall->daily_vwcminec,
+      c.edall->m_soid.vwcminec, c.edall->y_soid.vwcminec, out);
+}
+
+bool fill_vwcshlw(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_monthly_or_yearly(s, m, c.edall->daily_vwcshlw,
+      c.edall->m_soid.vwcshlw, c.edall->y_soid.vwcshlw, out);
+}
+
+bool fill_watertab(Cohort& c, const OutputSpec& s, int m, double* out) {
+  return daily_monthly_or_yearly(s, m, c.edall->daily_watertab,
+      c.edall->m_sois.watertab, c.edall->y_sois.watertab, out);
+}
+
+bool fill_ysd(Cohort& c, const OutputSpec& s, int m, double* out) {
+  out[0] = c.cd.yrsdist;
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////
+// The table. Layer count is 0 for variables without a layer dimension.
+/////////////////////////////////////////////////////////////////////
+
+const OutputVarDef output_vars[] = {
+  {"ALD",              0,           fill_ald},
+  {"AVLN",             MAX_SOI_LAY, fill_avln},
+  {"BURNAIR2SOILN",    0,           fill_burnair2soiln},
+  {"BURNSOIL2AIRC",    0,           fill_burnsoil2airc},
+  {"BURNSOIL2AIRN",    0,           fill_burnsoil2airn},
+  {"BURNTHICK",        0,           fill_burnthick},
+  {"BURNVEG2AIRC",     0,           fill_burnveg2airc},
+  {"BURNVEG2AIRN",     0,           fill_burnveg2airn},
+  {"BURNVEG2DEADC",    0,           fill_burnveg2deadc},
+  {"BURNVEG2DEADN",    0,           fill_burnveg2deadn},
+  {"BURNVEG2SOILABVC", 0,           fill_burnveg2soilabvc},
+  {"BURNVEG2SOILABVN", 0,           fill_burnveg2soilabvn},
+  {"BURNVEG2SOILBLWC", 0,           fill_burnveg2soilblwc},
+  {"BURNVEG2SOILBLWN", 0,           fill_burnveg2soilblwn},
+  {"CMTNUM",           0,           fill_cmtnum},
+  {"DEADC",            0,           fill_deadc},
+  {"DEADN",            0,           fill_deadn},
+  {"DEEPC",            0,           fill_deepc},
+  {"DEEPDZ",           0,           fill_deepdz},
+  {"DRIVINGNIRR",      0,           fill_drivingnirr},
+  {"DRIVINGRAINFALL",  0,           fill_drivingrainfall},
+  {"DRIVINGSNOWFALL",  0,           fill_drivingsnowfall},
+  {"DRIVINGTAIR",      0,           fill_drivingtair},
+  {"DRIVINGVAPO",      0,           fill_drivingvapo},
+  {"DWDC",             0,           fill_dwdc},
+  {"DWDN",             0,           fill_dwdn},
+  {"EET",              0,           fill_eet},
+  {"FRONTSDEPTH",      MAX_NUM_FNT, fill_frontsdepth},
+  {"FRONTSTYPE",       MAX_NUM_FNT, fill_frontstype},
+  {"GPP",              0,           fill_gpp},
+  {"GROWEND",          0,           fill_growend},
+  {"GROWSTART",        0,           fill_growstart},
+  {"HKDEEP",           0,           fill_hkdeep},
+  {"HKLAYER",          MAX_SOI_LAY, fill_hklayer},
+  {"HKMINEA",          0,           fill_hkminea},
+  {"HKMINEB",          0,           fill_hkmineb},
+  {"HKMINEC",          0,           fill_hkminec},
+  {"HKSHLW",           0,           fill_hkshlw},
+  {"INGPP",            0,           fill_ingpp},
+  {"INNPP",            0,           fill_innpp},
+  {"INNUPTAKE",        0,           fill_innuptake},
+  {"IWCLAYER",         MAX_SOI_LAY, fill_iwclayer},
+  {"LAI",              0,           fill_lai},
+  {"LAYERDEPTH",       MAX_SOI_LAY, fill_layerdepth},
+  {"LAYERDZ",          MAX_SOI_LAY, fill_layerdz},
+  {"LAYERTYPE",        MAX_SOI_LAY, fill_layertype},
+  {"LFNVC",            0,           fill_lfnvc},
+  {"LFNVN",            0,           fill_lfnvn},
+  {"LFVC",             0,           fill_lfvc},
+  {"LFVN",             0,           fill_lfvn},
+  {"LWCLAYER",         MAX_SOI_LAY, fill_lwclayer},
+  {"MINEC",            0,           fill_minec},
+  {"MOSSDZ",           0,           fill_mossdz},
+  {"NDRAIN",           0,           fill_ndrain},
+  {"NETNMIN",          MAX_SOI_LAY, fill_netnmin},
+  {"NIMMOB",           MAX_SOI_LAY, fill_nimmob},
+  {"NINPUT",           0,           fill_ninput},
+  {"NLOST",            0,           fill_nlost},
+  {"NPP",              0,           fill_npp},
+  {"NREQ",             0,           fill_nreq},
+  {"NRESORB",          0,           fill_nresorb},
+  {"NUPTAKELAB",       0,           fill_nuptakelab},
+  {"NUPTAKEST",        0,           fill_nuptakest},
+  {"ORGN",             MAX_SOI_LAY, fill_orgn},
+  {"PERCOLATION",      MAX_SOI_LAY, fill_percolation},
+  {"PERMAFROST",       0,           fill_permafrost},
+  {"PET",              0,           fill_pet},
+  {"QDRAINAGE",        0,           fill_qdrainage},
+  {"QDRAINLAYER",      MAX_SOI_LAY, fill_qdrainlayer},
+  {"QINFILTRATION",    0,           fill_qinfiltration},
+  {"QRUNOFF",          0,           fill_qrunoff},
+  {"RAINFALL",         0,           fill_rainfall},
+  {"RECO",             0,           fill_reco},
+  {"RG",               0,           fill_rg},
+  {"RHDWD",            0,           fill_rhdwd},
+  {"RHSOM",            MAX_SOI_LAY, fill_rhsom},
+  {"RM",               0,           fill_rm},
+  {"ROLB",             0,           fill_rolb},
+  {"ROOTWATERUPTAKE",  MAX_SOI_LAY, fill_rootwateruptake},
+  {"SHLWC",            0,           fill_shlwc},
+  {"SHLWDZ",           0,           fill_shlwdz},
+  {"SNOWEND",          0,           fill_snowend},
+  {"SNOWFALL",         0,           fill_snowfall},
+  {"SNOWLAYERDZ",      MAX_SNW_LAY, fill_snowlayerdz},
+  {"SNOWLAYERTEMP",    MAX_SNW_LAY, fill_snowlayertemp},
+  {"SNOWSTART",        0,           fill_snowstart},
+  {"SNOWTHICK",        0,           fill_snowthick},
+  {"SOC",              MAX_SOI_LAY, fill_soc},
+  {"SOC0_30cm",        0,           fill_soc0_30cm},
+  {"SOC0_100cm",       0,           fill_soc0_100cm},
+  {"SOC0_200cm",       0,           fill_soc0_200cm},
+  {"SOC0_300cm",       0,           fill_soc0_300cm},
+  {"SOCFROZEN",        0,           fill_socfrozen},
+  {"SOCUNFROZEN",      0,           fill_socunfrozen},
+  {"SOMA",             MAX_SOI_LAY, fill_soma},
+  {"SOMCR",            MAX_SOI_LAY, fill_somcr},
+  {"SOMPR",            MAX_SOI_LAY, fill_sompr},
+  {"SOMRAWC",          MAX_SOI_LAY, fill_somrawc},
+  {"SWE",              0,           fill_swe},
+  {"TCDEEP",           0,           fill_tcdeep},
+  {"TCLAYER",          MAX_SOI_LAY, fill_tclayer},
+  {"TCMINEA",          0,           fill_tcminea},
+  {"TCMINEB",          0,           fill_tcmineb},
+  {"TCMINEC",          0,           fill_tcminec},
+  {"TCSHLW",           0,           fill_tcshlw},
+  {"TDEEP",            0,           fill_tdeep},
+  {"TLAYER",           MAX_SOI_LAY, fill_tlayer},
+  {"TMINEA",           0,           fill_tminea},
+  {"TMINEB",           0,           fill_tmineb},
+  {"TMINEC",           0,           fill_tminec},
+  {"TRANSPIRATION",    0,           fill_transpiration},
+  {"TSHLW",            0,           fill_tshlw},
+  {"TSOIL_30cm",       0,           fill_tsoil_30cm},
+  {"TSOIL_100cm",      0,           fill_tsoil_100cm},
+  {"TSOIL_200cm",      0,           fill_tsoil_200cm},
+  {"TSOIL_300cm",      0,           fill_tsoil_300cm},
+  {"VEGC",             0,           fill_vegc},
+  {"VEGNLAB",          0,           fill_vegnlab},
+  {"VEGNSTR",          0,           fill_vegnstr},
+  {"VEGNTOT",          0,           fill_vegntot},
+  {"VWC_30cm",         0,           fill_vwc_30cm},
+  {"VWC_100cm",        0,           fill_vwc_100cm},
+  {"VWC_200cm",        0,           fill_vwc_200cm},
+  {"VWC_300cm",        0,           fill_vwc_300cm},
+  {"VWCDEEP",          0,           fill_vwcdeep},
+  {"VWCLAYER",         MAX_SOI_LAY, fill_vwclayer},
+  {"VWCMINEA",         0,           fill_vwcminea},
+  {"VWCMINEB",         0,           fill_vwcmineb},
+  {"VWCMINEC",         0,           fill_vwcminec},
+  {"VWCSHLW",          0,           fill_vwcshlw},
+  {"WATERTAB",         0,           fill_watertab},
+  {"YSD",              0,           fill_ysd},
+};
+
+const int output_var_count = sizeof(output_vars) / sizeof(output_vars[0]);
+
+} // end anonymous namespace
+
+
+/** Look up a variable by the name used in output_spec.csv. Returns NULL
+ *  if the model does not know how to produce the variable. This is only
+ *  done when setting up, so a linear search is fine.
+ */
+const OutputVarDef* find_output_var(const std::string& name) {
+  for(int iv=0; iv<output_var_count; iv++){
+    if(name == output_vars[iv].name){
+      return &output_vars[iv];
+    }
+  }
+  return NULL;
+}
+
+/** Number of values a variable has for a single timestep, given the
+ *  dimensions requested in its OutputSpec.
+ */
+int output_values_per_timestep(const OutputVarDef& def, const OutputSpec& spec) {
+  if(spec.pft && spec.compartment){
+    return NUM_PFT_PART * NUM_PFT;
+  }
+  else if(spec.pft){
+    return NUM_PFT;
+  }
+  else if(spec.compartment){
+    return NUM_PFT_PART;
+  }
+  else if(spec.layer){
+    return def.layer_count;
+  }
+  return 1;
+}
+
+/** Number of timesteps filled by a single call of a fill function. Daily
+ *  data is collected once a month, so that is the whole month.
+ */
+int output_timesteps_per_fill(const OutputSpec& spec, int month) {
+  if(spec.daily){
+    return DINM[month];
+  }
+  return 1;
+}
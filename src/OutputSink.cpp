@@ -0,0 +1,458 @@
+/*  OutputSink.cpp
+ *
+ *  Cache of open NetCDF output files. See OutputSink.h
+ */
+
+#include <cstring>
+#include <stdexcept>
+#include <sstream>
+
+#include "../include/OutputSink.h"
+#include "../include/TEMUtilityFunctions.h"
+#include "../include/TEMLogger.h"
+
+#include <netcdf.h>
+#ifdef WITHMPI
+#include <mpi.h>
+#include <netcdf_par.h>
+#endif
+
+extern src::severity_logger< severity_level > glg;
+
+OutputSink::OutputSink(): file_opens(0), collective(false),
+    block_first_row(0), block_row_count(0) {}
+
+OutputSink::~OutputSink() {
+  try {
+    this->close_all();
+  } catch (std::exception& e) {
+    BOOST_LOG_SEV(glg, warn) << "Problem closing output files: " << e.what();
+  }
+}
+
+/** Returns the cached handle for a file, opening the file if this is the
+ *  first time it has been asked for. Under MPI the file is opened by this
+ *  rank alone; such handles should be closed with close_stage(..) once
+ *  the rank is done with the file for now. Caller must hold the NetCDF
+ *  lock.
+ */
+OutputSink::OpenFile& OutputSink::get_file(const std::string& filename) {
+
+  std::map<std::string, OpenFile>::iterator itr = files.find(filename);
+  if (itr != files.end()) {
+    if (itr->second.writable) {
+      return itr->second;
+    }
+    // Was only opened to be read
+    temutil::nc( nc_close(itr->second.ncid), filename );
+    files.erase(itr);
+  }
+
+  BOOST_LOG_SEV(glg, debug) << "OutputSink opening file: " << filename;
+
+  OpenFile new_file;
+  new_file.writable = true;
+#ifdef WITHMPI
+  temutil::nc( nc_open_par(filename.c_str(), NC_WRITE|NC_MPIIO, MPI_COMM_SELF, MPI_INFO_NULL, &new_file.ncid), filename );
+#else
+  temutil::nc( nc_open(filename.c_str(), NC_WRITE, &new_file.ncid), filename );
+#endif
+  file_opens++;
+
+  return files.insert(std::make_pair(filename, new_file)).first->second;
+}
+
+/** Returns the cached handle for a file that is to be read from. A file
+ *  that is already open for writing is read through the same handle,
+ *  otherwise it is opened read-only. Caller must hold the NetCDF lock.
+ */
+OutputSink::OpenFile& OutputSink::get_file_for_read(const std::string& filename) {
+
+  std::map<std::string, OpenFile>::iterator itr = files.find(filename);
+  if (itr != files.end()) {
+    return itr->second;
+  }
+
+  BOOST_LOG_SEV(glg, debug) << "OutputSink opening file for reading: " << filename;
+
+  OpenFile new_file;
+  new_file.writable = false;
+  temutil::nc( nc_open(filename.c_str(), NC_NOWRITE, &new_file.ncid), filename );
+  file_opens++;
+
+  return files.insert(std::make_pair(filename, new_file)).first->second;
+}
+
+/** Returns the cached varid, looking it up on first use. Caller must hold
+ *  the NetCDF lock.
+ */
+int OutputSink::get_varid(OpenFile& file, const std::string& var_name) {
+
+  std::map<std::string, int>::iterator itr = file.varids.find(var_name);
+  if (itr != file.varids.end()) {
+    return itr->second;
+  }
+
+  int varid;
+  temutil::nc( nc_inq_varid(file.ncid, var_name.c_str(), &varid) );
+
+#ifdef WITHMPI
+  if (file.writable) {
+    temutil::nc( nc_var_par_access(file.ncid, varid, NC_INDEPENDENT) );
+  }
+#endif
+
+  file.varids[var_name] = varid;
+  return varid;
+}
+
+/** Write a hyperslab of data to a variable. The data must already be of the
+ *  variable's type. Throws on NetCDF errors.
+ */
+void OutputSink::put(const std::string& filename, const std::string& var_name,
+                     const size_t* start, const size_t* count, const void* data) {
+
+  temutil::NetCDFLock lock(temutil::netcdf_mutex());
+
+  OpenFile& file = get_file(filename);
+
+  HeldVar* held = find_held_var(file, var_name);
+  if (held) {
+    hold(*held, var_name, start, count, data);
+    return;
+  }
+
+  int varid = get_varid(file, var_name);
+
+  temutil::nc( nc_put_vara(file.ncid, varid, start, count, data), filename );
+}
+
+/** Write a single integer value, as for the run status file. */
+void OutputSink::put_int(const std::string& filename, const std::string& var_name,
+                         const size_t* start, int value) {
+
+  temutil::NetCDFLock lock(temutil::netcdf_mutex());
+
+  OpenFile& file = get_file(filename);
+
+  HeldVar* held = find_held_var(file, var_name);
+  if (held) {
+    size_t count[2] = {1, 1};
+    hold(*held, var_name, start, count, &value);
+    return;
+  }
+
+  int varid = get_varid(file, var_name);
+
+  temutil::nc( nc_put_var1_int(file.ncid, varid, start, &value), filename );
+}
+
+/** Read a hyperslab of a variable, in the variable's type. Variables whose
+ *  writes are being gathered can't be read back. Throws on NetCDF errors.
+ */
+void OutputSink::get(const std::string& filename, const std::string& var_name,
+                     const size_t* start, const size_t* count, void* data) {
+
+  temutil::NetCDFLock lock(temutil::netcdf_mutex());
+
+  OpenFile& file = get_file_for_read(filename);
+
+  if (find_held_var(file, var_name)) {
+    throw std::runtime_error("Can't read " + var_name + " from " + filename +
+                             " while its writes are being gathered");
+  }
+
+  int varid = get_varid(file, var_name);
+
+  temutil::nc( nc_get_vara(file.ncid, varid, start, count, data), filename );
+}
+
+/** Close all the open files whose name ends with the given stage suffix,
+ *  i.e. "_tr.nc". A file that is written to again is simply reopened.
+ *  Files whose writes are gathered stay open until close_all(), since
+ *  they hold the current block and may be open collectively.
+ */
+void OutputSink::close_stage(const std::string& stage_suffix) {
+
+  temutil::NetCDFLock lock(temutil::netcdf_mutex());
+
+  std::map<std::string, OpenFile>::iterator itr = files.begin();
+  while (itr != files.end()) {
+    const std::string& fname = itr->first;
+    if (itr->second.held_vars.empty() && fname.size() >= stage_suffix.size() &&
+        fname.compare(fname.size() - stage_suffix.size(), stage_suffix.size(), stage_suffix) == 0) {
+      BOOST_LOG_SEV(glg, debug) << "OutputSink closing file: " << fname;
+      temutil::nc( nc_close(itr->second.ncid), fname );
+      files.erase(itr++);
+    } else {
+      ++itr;
+    }
+  }
+}
+
+void OutputSink::close_all() {
+
+  temutil::NetCDFLock lock(temutil::netcdf_mutex());
+
+  if (files.empty()) {
+    return;
+  }
+
+  std::map<std::string, OpenFile>::iterator itr;
+  for (itr = files.begin(); itr != files.end(); ++itr) {
+    BOOST_LOG_SEV(glg, debug) << "OutputSink closing file: " << itr->first;
+    temutil::nc( nc_close(itr->second.ncid), itr->first );
+  }
+  BOOST_LOG_SEV(glg, info) << "OutputSink closed " << files.size()
+                           << " files (" << file_opens << " opens over the run).";
+  files.clear();
+}
+
+/** Flush everything written so far to the open files, so that it
+ *  survives the process going away without closing them. */
+void OutputSink::sync_all() {
+
+  temutil::NetCDFLock lock(temutil::netcdf_mutex());
+
+  std::map<std::string, OpenFile>::iterator itr;
+  for (itr = files.begin(); itr != files.end(); ++itr) {
+    if (itr->second.writable) {
+      temutil::nc( nc_sync(itr->second.ncid), itr->first );
+    }
+  }
+}
+
+int OutputSink::open_file_count() {
+  temutil::NetCDFLock lock(temutil::netcdf_mutex());
+  return files.size();
+}
+
+/** Returns the held data for a variable if its writes are being gathered
+ *  into blocks, otherwise NULL. Caller must hold the NetCDF lock.
+ */
+OutputSink::HeldVar* OutputSink::find_held_var(OpenFile& file, const std::string& var_name) {
+  if (file.held_vars.empty()) {
+    return NULL;
+  }
+  std::map<std::string, HeldVar>::iterator itr = file.held_vars.find(var_name);
+  if (itr == file.held_vars.end()) {
+    return NULL;
+  }
+  return &itr->second;
+}
+
+/** Copy a hyperslab into the held data for the current block. The last
+ *  two dimensions of every variable are (y, x); the held data has the
+ *  block's rows in place of the full y dimension. Caller must hold
+ *  the NetCDF lock.
+ */
+void OutputSink::hold(HeldVar& held, const std::string& var_name,
+                      const size_t* start, const size_t* count, const void* data) {
+
+  int ndims = held.dimlens.size();
+  int ydim = ndims - 2;
+
+  if (start[ydim] < (size_t)block_first_row ||
+      start[ydim] + count[ydim] > (size_t)(block_first_row + block_row_count)) {
+    std::stringstream msg;
+    msg << "Row " << start[ydim] << " of " << var_name << " is outside of the "
+        << "block being gathered (rows " << block_first_row << " to "
+        << block_first_row + block_row_count - 1 << ")";
+    throw std::runtime_error(msg.str());
+  }
+
+  // Strides through the held data, in values
+  std::vector<size_t> stride(ndims);
+  stride[ndims-1] = 1;
+  for (int id=ndims-2; id>=0; id--) {
+    size_t dimlen = (id+1 == ydim) ? block_row_count : held.dimlens[id+1];
+    stride[id] = stride[id+1] * dimlen;
+  }
+
+  size_t total = 1;
+  for (int id=0; id<ndims; id++) {
+    total *= count[id];
+  }
+
+  const char* src = static_cast<const char*>(data);
+  std::vector<size_t> idx(ndims, 0);
+  for (size_t iv=0; iv<total; iv++) {
+
+    size_t offset = 0;
+    for (int id=0; id<ndims; id++) {
+      size_t pos = start[id] + idx[id];
+      if (id == ydim) {
+        pos -= block_first_row;
+      }
+      offset += pos * stride[id];
+    }
+    std::memcpy(&held.data[offset*held.value_size], src + iv*held.value_size, held.value_size);
+
+    // Step to the next index, last dimension fastest
+    for (int id=ndims-1; id>=0; id--) {
+      if (++idx[id] < count[id]) {
+        break;
+      }
+      idx[id] = 0;
+    }
+  }
+}
+
+/** Size the held data for the current block and set it to the fill
+ *  value, so that cells that are never written read as missing.
+ */
+void OutputSink::reset_held_var(HeldVar& held) {
+
+  size_t nvalues = block_row_count;
+  for (unsigned int id=0; id<held.dimlens.size(); id++) {
+    if ((int)id != (int)held.dimlens.size()-2) {
+      nvalues *= held.dimlens[id];
+    }
+  }
+
+  held.data.resize(nvalues * held.value_size);
+  for (size_t iv=0; iv<nvalues; iv++) {
+    std::memcpy(&held.data[iv*held.value_size], &held.fill_value[0], held.value_size);
+  }
+}
+
+/** Look up a variable and start holding its writes. Caller must hold
+ *  the NetCDF lock.
+ */
+void OutputSink::add_held_var(OpenFile& file, const std::string& filename,
+                              const std::string& var_name) {
+
+  HeldVar held;
+  temutil::nc( nc_inq_varid(file.ncid, var_name.c_str(), &held.varid), filename );
+
+#ifdef WITHMPI
+  temutil::nc( nc_var_par_access(file.ncid, held.varid, collective ? NC_COLLECTIVE : NC_INDEPENDENT) );
+#endif
+
+  int ndims;
+  int dimids[NC_MAX_VAR_DIMS];
+  nc_type var_type;
+  temutil::nc( nc_inq_var(file.ncid, held.varid, NULL, &var_type, &ndims, dimids, NULL) );
+  held.dimlens.resize(ndims);
+  for (int id=0; id<ndims; id++) {
+    temutil::nc( nc_inq_dimlen(file.ncid, dimids[id], &held.dimlens[id]) );
+  }
+  temutil::nc( nc_inq_type(file.ncid, var_type, NULL, &held.value_size) );
+
+  int no_fill;
+  held.fill_value.resize(held.value_size);
+  temutil::nc( nc_inq_var_fill(file.ncid, held.varid, &no_fill, &held.fill_value[0]) );
+
+  file.varids[var_name] = held.varid;
+  file.held_vars[var_name] = held;
+}
+
+/** Hold the writes to the given variables in each file, a block of rows
+ *  at a time, instead of writing them as they arrive.
+ */
+void OutputSink::open_gathered(const std::map<std::string, std::vector<std::string> >& file_vars) {
+
+  temutil::NetCDFLock lock(temutil::netcdf_mutex());
+
+  std::map<std::string, std::vector<std::string> >::const_iterator fitr;
+  for (fitr = file_vars.begin(); fitr != file_vars.end(); ++fitr) {
+    OpenFile& file = get_file(fitr->first);
+    for (unsigned int iv=0; iv<fitr->second.size(); iv++) {
+      add_held_var(file, fitr->first, fitr->second[iv]);
+    }
+  }
+}
+
+#ifdef WITHMPI
+
+/** Open the given files on MPI_COMM_WORLD and mark the given variables
+ *  in each for collective writes. Every rank must call this with the same
+ *  list.
+ */
+void OutputSink::open_collective(const std::map<std::string, std::vector<std::string> >& file_vars) {
+
+  temutil::NetCDFLock lock(temutil::netcdf_mutex());
+
+  collective = true;
+
+  std::map<std::string, std::vector<std::string> >::const_iterator fitr;
+  for (fitr = file_vars.begin(); fitr != file_vars.end(); ++fitr) {
+
+    const std::string& filename = fitr->first;
+    if (files.find(filename) != files.end()) {
+      throw std::runtime_error("File is already open, cannot reopen it for collective output: " + filename);
+    }
+
+    BOOST_LOG_SEV(glg, debug) << "OutputSink opening file for collective output: " << filename;
+
+    OpenFile new_file;
+    new_file.writable = true;
+    temutil::nc( nc_open_par(filename.c_str(), NC_WRITE|NC_MPIIO, MPI_COMM_WORLD, MPI_INFO_NULL, &new_file.ncid), filename );
+    file_opens++;
+
+    OpenFile& file = files.insert(std::make_pair(filename, new_file)).first->second;
+    for (unsigned int iv=0; iv<fitr->second.size(); iv++) {
+      add_held_var(file, filename, fitr->second[iv]);
+    }
+  }
+}
+
+#endif
+
+/** Start gathering a new block of rows. In collective mode a rank with
+ *  nothing left to run still takes part in the writes with an empty block.
+ */
+void OutputSink::begin_block(int first_row, int row_count) {
+
+  temutil::NetCDFLock lock(temutil::netcdf_mutex());
+
+  block_first_row = first_row;
+  block_row_count = row_count;
+
+  std::map<std::string, OpenFile>::iterator fitr;
+  for (fitr = files.begin(); fitr != files.end(); ++fitr) {
+    std::map<std::string, HeldVar>::iterator vitr;
+    for (vitr = fitr->second.held_vars.begin(); vitr != fitr->second.held_vars.end(); ++vitr) {
+      reset_held_var(vitr->second);
+    }
+  }
+}
+
+/** Write the current block of every held variable, one call per variable.
+ *  In collective mode every rank must call this the same number of times.
+ *  Files and variables are visited in name order, so the collective calls
+ *  line up across ranks.
+ */
+void OutputSink::write_block() {
+
+  temutil::NetCDFLock lock(temutil::netcdf_mutex());
+
+  if (block_row_count == 0 && !collective) {
+    return;
+  }
+
+  long bytes = 0;
+
+  std::map<std::string, OpenFile>::iterator fitr;
+  for (fitr = files.begin(); fitr != files.end(); ++fitr) {
+    std::map<std::string, HeldVar>::iterator vitr;
+    for (vitr = fitr->second.held_vars.begin(); vitr != fitr->second.held_vars.end(); ++vitr) {
+      HeldVar& held = vitr->second;
+      int ndims = held.dimlens.size();
+
+      std::vector<size_t> start(ndims, 0);
+      std::vector<size_t> count(held.dimlens);
+      start[ndims-2] = (block_row_count > 0) ? block_first_row : 0;
+      count[ndims-2] = block_row_count;
+
+      const void* data = held.data.empty() ? NULL : &held.data[0];
+      temutil::nc( nc_put_vara(fitr->second.ncid, held.varid, &start[0], &count[0], data), fitr->first );
+      bytes += held.data.size();
+    }
+  }
+
+  BOOST_LOG_SEV(glg, info) << "OutputSink wrote rows " << block_first_row << " to "
+                           << block_first_row + block_row_count - 1
+                           << (collective ? " collectively (" : " (")
+                           << bytes / (1024.0 * 1024.0) << " MiB).";
+}
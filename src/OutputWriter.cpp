@@ -0,0 +1,151 @@
+/*  OutputWriter.cpp
+ *
+ *  Asynchronous NetCDF writer stage. See OutputWriter.h
+ */
+
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#include <chrono>
+#include <thread>
+
+#include "../include/OutputWriter.h"
+#include "../include/TEMLogger.h"
+
+extern src::severity_logger< severity_level > glg;
+
+OutputWriter::OutputWriter(OutputSink* sink, int queue_capacity, int io_thread_count):
+    sink(sink), io_thread_count(io_thread_count), queue(queue_capacity), done(false),
+    blocks_written(0), bytes_written(0), write_failures(0),
+    queue_depth(0), max_queue_depth(0),
+    stall_count(0), stall_microseconds(0) {
+
+  if (this->io_thread_count < 1) {
+    this->io_thread_count = 1;
+  }
+
+  BOOST_LOG_SEV(glg, info) << "Starting NetCDF writer stage with "
+                           << this->io_thread_count << " I/O thread(s) and a "
+                           << "queue capacity of " << queue_capacity << " blocks.";
+
+  for (int i = 0; i < this->io_thread_count; ++i) {
+    io_threads.create_thread(boost::bind(&OutputWriter::drain, this));
+  }
+}
+
+OutputWriter::~OutputWriter() {
+  this->finish();
+}
+
+/** Hand a block off to the writer stage. The writer takes ownership of the
+ *  block and deletes it once written. Only blocks the caller if the queue
+ *  is full, in which case the time spent waiting is recorded.
+ */
+void OutputWriter::enqueue(OutputBlock* block) {
+
+  if (!queue.push(block)) {
+    std::chrono::steady_clock::time_point stall_start = std::chrono::steady_clock::now();
+    while (!queue.push(block)) {
+      std::this_thread::yield();
+    }
+    std::chrono::microseconds stalled = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - stall_start);
+    stall_count++;
+    stall_microseconds += stalled.count();
+  }
+
+  int depth = ++queue_depth;
+  int prev_max = max_queue_depth.load();
+  while (depth > prev_max && !max_queue_depth.compare_exchange_weak(prev_max, depth)) {}
+
+  // Taking the mutex orders the push before an idle thread's empty check,
+  // so the wake up can't be missed
+  boost::lock_guard<boost::mutex> lock(idle_mutex);
+  idle_cond.notify_one();
+}
+
+/** Body of each I/O thread. Runs until finish() is called and the queue
+ *  has been emptied. Sleeps on idle_cond whenever the queue is empty.
+ */
+void OutputWriter::drain() {
+  OutputBlock* block;
+  while (true) {
+    if (queue.pop(block)) {
+      --queue_depth;
+      this->write_block(block);
+      delete block;
+      continue;
+    }
+    boost::unique_lock<boost::mutex> lock(idle_mutex);
+    while (queue.empty() && !done.load()) {
+      idle_cond.wait(lock);
+    }
+    // One last check in case something was pushed just before 'done'
+    if (queue.empty() && done.load()) {
+      break;
+    }
+  }
+}
+
+void OutputWriter::write_block(OutputBlock* block) {
+  try {
+    sink->put(block->filename, block->var_name, block->start, block->count, &block->data[0]);
+
+    blocks_written++;
+    bytes_written += block->data.size();
+
+  } catch (std::exception& e) {
+    write_failures++;
+    int row = block->start[block->ndims-2];
+    int col = block->start[block->ndims-1];
+    BOOST_LOG_SEV(glg, fatal) << "Writer failed to write " << block->var_name
+                              << " for pixel (row, col): (" << row
+                              << ", " << col << ") to "
+                              << block->filename << ": " << e.what();
+
+    boost::lock_guard<boost::mutex> lock(failed_cells_mutex);
+    std::pair<int, int> cell(row, col);
+    if (std::find(failed_cells.begin(), failed_cells.end(), cell) == failed_cells.end()) {
+      failed_cells.push_back(cell);
+    }
+  }
+}
+
+/** Stop accepting work and wait for the queue to empty. The files are left
+ *  open in the sink. Safe to call more than once.
+ */
+void OutputWriter::finish() {
+  if (done.exchange(true)) {
+    return;
+  }
+  {
+    boost::lock_guard<boost::mutex> lock(idle_mutex);
+    idle_cond.notify_all();
+  }
+  io_threads.join_all();
+  BOOST_LOG_SEV(glg, info) << this->stats_report();
+}
+
+/** The cells whose output is incomplete because a write failed. A cell is
+ *  only returned by the first call after its failure. Call after finish()
+ *  to get them all.
+ */
+std::vector<std::pair<int, int> > OutputWriter::take_failed_cells() {
+  boost::lock_guard<boost::mutex> lock(failed_cells_mutex);
+  std::vector<std::pair<int, int> > cells;
+  cells.swap(failed_cells);
+  return cells;
+}
+
+std::string OutputWriter::stats_report() {
+  std::stringstream s;
+  s << "NetCDF writer stage: " << blocks_written.load() << " blocks, "
+    << std::fixed << std::setprecision(2)
+    << bytes_written.load() / (1024.0 * 1024.0) << " MiB written, "
+    << write_failures.load() << " failed. Max queue depth: "
+    << max_queue_depth.load() << ". Producers stalled on a full queue "
+    << stall_count.load() << " times for a total of "
+    << stall_microseconds.load() / 1.0e6 << " seconds.";
+  return s.str();
+}
@@ -0,0 +1,281 @@
+/*  RestartCheckpoint.cpp
+ *
+ *  Memory mapped binary restart files. See RestartCheckpoint.h
+ */
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include <netcdf.h>
+
+#include "../include/RestartCheckpoint.h"
+#include "../include/OutputSink.h"
+#include "../include/TEMUtilityFunctions.h"
+#include "../include/TEMLogger.h"
+
+extern src::severity_logger< severity_level > glg;
+
+namespace bip = boost::interprocess;
+
+const std::string RestartCheckpoint::EXTENSION = ".bin";
+
+namespace {
+
+const char checkpoint_magic[8] = "DVMRST";
+
+// Each record starts with this flag, ahead of the RestartData bytes
+typedef unsigned long long record_flag_t;
+const record_flag_t RECORD_WRITTEN = 1;
+
+} // end anonymous namespace
+
+
+/** Maps an existing checkpoint file and checks that its header matches
+ *  the RestartData of this build.
+ */
+RestartCheckpoint::RestartCheckpoint(const std::string& fname, bool writable):
+    fname(fname), writable(writable), rows(0), cols(0),
+    mapping(fname.c_str(), writable ? bip::read_write : bip::read_only),
+    region(mapping, writable ? bip::read_write : bip::read_only) {
+
+  if (region.get_size() < HEADER_BYTES) {
+    throw std::runtime_error("Restart checkpoint " + fname + " is too short to hold a header");
+  }
+
+  Header found;
+  std::memcpy(&found, region.get_address(), sizeof(Header));
+  Header expected = expected_header(found.rows, found.cols);
+
+  if (std::memcmp(&found, &expected, sizeof(Header)) != 0) {
+    BOOST_LOG_SEV(glg, fatal) << "Restart checkpoint " << fname << " (version "
+                              << found.version << ", " << found.restartdata_bytes
+                              << " bytes per cell) was not written with this "
+                              << "build's RestartData layout (version " << VERSION
+                              << ", " << expected.restartdata_bytes << " bytes per cell).";
+    throw std::runtime_error("Restart checkpoint " + fname + " does not match this build's RestartData");
+  }
+
+  rows = found.rows;
+  cols = found.cols;
+
+  size_t needed = HEADER_BYTES + size_t(rows) * cols * record_bytes();
+  if (region.get_size() < needed) {
+    throw std::runtime_error("Restart checkpoint " + fname + " is truncated");
+  }
+
+  BOOST_LOG_SEV(glg, info) << "Mapped restart checkpoint " << fname << " (" << rows
+                           << " x " << cols << ", " << (writable ? "read/write" : "read only") << ")";
+}
+
+
+/** The header a checkpoint for this build and a rows x cols grid has.
+ *  Unused bytes are zeroed so headers can be compared with memcmp.
+ */
+RestartCheckpoint::Header RestartCheckpoint::expected_header(int rows, int cols) {
+  Header h;
+  std::memset(&h, 0, sizeof(Header));
+  std::memcpy(h.magic, checkpoint_magic, sizeof(h.magic));
+  h.version = VERSION;
+  h.restartdata_bytes = sizeof(RestartData);
+  h.record_bytes = record_bytes();
+  h.rows = rows;
+  h.cols = cols;
+  h.num_pft = NUM_PFT;
+  h.num_pft_part = NUM_PFT_PART;
+  h.max_snw_lay = MAX_SNW_LAY;
+  h.max_soi_lay = MAX_SOI_LAY;
+  h.max_rot_lay = MAX_ROT_LAY;
+  h.max_roc_lay = MAX_ROC_LAY;
+  h.max_num_fnt = MAX_NUM_FNT;
+  return h;
+}
+
+
+/** Bytes per cell: the written flag and a RestartData, rounded up to a
+ *  whole number of pages. */
+size_t RestartCheckpoint::record_bytes() {
+  size_t page = bip::mapped_region::get_page_size();
+  size_t bytes = sizeof(record_flag_t) + sizeof(RestartData);
+  return ((bytes + page - 1) / page) * page;
+}
+
+
+char* RestartCheckpoint::record(int row, int col) const {
+  if (row < 0 || row >= rows || col < 0 || col >= cols) {
+    std::stringstream ss;
+    ss << "Cell (" << row << ", " << col << ") is outside the " << rows << " x "
+       << cols << " restart checkpoint " << fname;
+    throw std::out_of_range(ss.str());
+  }
+  return static_cast<char*>(region.get_address()) + HEADER_BYTES
+         + (size_t(row) * cols + col) * record_bytes();
+}
+
+
+bool RestartCheckpoint::has_record(int row, int col) const {
+  record_flag_t flag;
+  std::memcpy(&flag, record(row, col), sizeof(flag));
+  return flag == RECORD_WRITTEN;
+}
+
+
+/** Copies a cell's record into rd. A cell that has never been written
+ *  reads as missing values. */
+void RestartCheckpoint::read(RestartData& rd, int row, int col) const {
+  BOOST_LOG_SEV(glg, debug) << "Reading RestartData from " << fname << " for pixel (y, x): ("
+                            << row << "," << col << ")";
+  if (has_record(row, col)) {
+    std::memcpy((void*)&rd, record(row, col) + sizeof(record_flag_t), sizeof(RestartData));
+  } else {
+    BOOST_LOG_SEV(glg, warn) << "No record for pixel (" << row << "," << col << ") in " << fname;
+    rd.reinitValue();
+  }
+}
+
+
+/** Copies rd into a cell's record. Cells only ever write their own
+ *  record, so no lock is needed. */
+void RestartCheckpoint::write(const RestartData& rd, int row, int col) {
+  if (!writable) {
+    throw std::runtime_error("Restart checkpoint " + fname + " is mapped read only");
+  }
+  BOOST_LOG_SEV(glg, debug) << "Writing RestartData to " << fname << " for pixel (y, x): ("
+                            << row << "," << col << ")";
+  char* rec = record(row, col);
+  std::memcpy(rec + sizeof(record_flag_t), (const void*)&rd, sizeof(RestartData));
+  std::memcpy(rec, &RECORD_WRITTEN, sizeof(record_flag_t));
+}
+
+
+void RestartCheckpoint::flush() {
+  if (writable) {
+    region.flush();
+  }
+}
+
+
+bool RestartCheckpoint::is_checkpoint(const std::string& fname) {
+  return boost::filesystem::path(fname).extension().string() == EXTENSION;
+}
+
+
+/** Creates a checkpoint for a rows x cols grid with every record unwritten.
+ *  The records are left as a hole in the file, so creating one for a large
+ *  grid takes no time and no disk until cells are written.
+ */
+void RestartCheckpoint::create(const std::string& fname, int rows, int cols) {
+  BOOST_LOG_SEV(glg, debug) << "Creating restart checkpoint " << fname << " for "
+                            << rows << " x " << cols << " cells";
+
+  std::vector<char> header(HEADER_BYTES, 0);
+  Header h = expected_header(rows, cols);
+  std::memcpy(&header[0], &h, sizeof(Header));
+
+  std::ofstream out(fname.c_str(), std::ios::binary | std::ios::trunc);
+  out.write(&header[0], header.size());
+  out.close();
+  if (!out) {
+    throw std::runtime_error("Unable to write restart checkpoint " + fname);
+  }
+
+  boost::filesystem::resize_file(fname, HEADER_BYTES + size_t(rows) * cols * record_bytes());
+}
+
+
+/** Copies every cell that has data in a NetCDF restart file into a new
+ *  checkpoint of the same size. */
+void RestartCheckpoint::netcdf_to_checkpoint(const std::string& nc_fname,
+                                             const std::string& bin_fname) {
+  BOOST_LOG_SEV(glg, info) << "Converting " << nc_fname << " to " << bin_fname;
+
+  int ncid, yD, xD;
+  size_t ysize, xsize;
+  temutil::NetCDFLock lock(temutil::netcdf_mutex());
+  temutil::nc( nc_open(nc_fname.c_str(), NC_NOWRITE, &ncid), nc_fname );
+  temutil::nc( nc_inq_dimid(ncid, "Y", &yD) );
+  temutil::nc( nc_inq_dimlen(ncid, yD, &ysize) );
+  temutil::nc( nc_inq_dimid(ncid, "X", &xD) );
+  temutil::nc( nc_inq_dimlen(ncid, xD, &xsize) );
+  temutil::nc( nc_close(ncid) );
+
+  create(bin_fname, ysize, xsize);
+  RestartCheckpoint checkpoint(bin_fname, true);
+
+  // The sink keeps the NetCDF file open across all the cells
+  OutputSink sink;
+  RestartData rd;
+  int count = 0;
+  for (int row = 0; row < int(ysize); row++) {
+    for (int col = 0; col < int(xsize); col++) {
+      rd.update_from_ncfile(sink, nc_fname, row, col);
+      // Cells that were never written hold the fill value
+      if (rd.numsl != MISSING_I) {
+        checkpoint.write(rd, row, col);
+        count++;
+      }
+    }
+  }
+  sink.close_all();
+  checkpoint.flush();
+
+  BOOST_LOG_SEV(glg, info) << "Converted " << count << " cells to " << bin_fname;
+}
+
+
+/** Writes every cell that has a record in a checkpoint to a new NetCDF
+ *  restart file of the same size. */
+void RestartCheckpoint::checkpoint_to_netcdf(const std::string& bin_fname,
+                                             const std::string& nc_fname) {
+  BOOST_LOG_SEV(glg, info) << "Converting " << bin_fname << " to " << nc_fname;
+
+  RestartCheckpoint checkpoint(bin_fname, false);
+  RestartData::create_empty_file(nc_fname, checkpoint.get_rows(), checkpoint.get_cols());
+
+  OutputSink sink;
+  RestartData rd;
+  int count = 0;
+  for (int row = 0; row < checkpoint.get_rows(); row++) {
+    for (int col = 0; col < checkpoint.get_cols(); col++) {
+      if (checkpoint.has_record(row, col)) {
+        checkpoint.read(rd, row, col);
+        rd.write_pixel_to_ncfile(sink, nc_fname, row, col);
+        count++;
+      }
+    }
+  }
+  sink.close_all();
+
+  BOOST_LOG_SEV(glg, info) << "Converted " << count << " cells to " << nc_fname;
+}
+
+
+/** Returns the checkpoint for fname, mapping it on first use. A file that
+ *  was mapped read only is remapped if it is later wanted for writing;
+ *  callers still holding the old mapping keep it until they let go.
+ */
+boost::shared_ptr<RestartCheckpoint> RestartCheckpointCache::get(const std::string& fname, bool writable) {
+  boost::lock_guard<boost::mutex> lock(cache_mutex);
+
+  std::map<std::string, boost::shared_ptr<RestartCheckpoint> >::iterator it = checkpoints.find(fname);
+  if (it != checkpoints.end() && (it->second->is_writable() || !writable)) {
+    return it->second;
+  }
+
+  boost::shared_ptr<RestartCheckpoint> checkpoint(new RestartCheckpoint(fname, writable));
+  checkpoints[fname] = checkpoint;
+  return checkpoint;
+}
+
+
+void RestartCheckpointCache::flush_all() {
+  boost::lock_guard<boost::mutex> lock(cache_mutex);
+  std::map<std::string, boost::shared_ptr<RestartCheckpoint> >::iterator it;
+  for (it = checkpoints.begin(); it != checkpoints.end(); ++it) {
+    it->second->flush();
+  }
+}
@@ -23,6 +23,7 @@
 #endif
 
 #include "../include/RestartData.h"
+#include "../include/OutputSink.h"
 #include "../include/TEMUtilityFunctions.h"
 
 #include "../include/TEMLogger.h"
@@ -382,59 +383,59 @@ void RestartData::reinitValue() {
   }
 };
 
-/** Set values in this RestartData object from a NetCDF file. */
-void RestartData::update_from_ncfile(const std::string& fname, const int rowidx, const int colidx) {
-  BOOST_LOG_SEV(glg, debug) << "Opening dataset: " << fname << " to READ value into RestartData for pixel (y, x): (" << rowidx << "," << colidx << ")";
-  BOOST_LOG_SEV(glg, debug) << temutil::report_yx_pixel_dims2str(fname);
+/** Set values in this RestartData object from a NetCDF file. The file is
+ *  read through the sink, so it is opened once per run rather than once
+ *  per group of variables per cell.
+ */
+void RestartData::update_from_ncfile(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx) {
+  BOOST_LOG_SEV(glg, debug) << "Reading RestartData from " << fname << " for pixel (y, x): (" << rowidx << "," << colidx << ")";
 
-  read_px_vars(fname, rowidx, colidx);
+  read_px_vars(sink, fname, rowidx, colidx);
 
-  read_px_pft_vars(fname, rowidx, colidx);
+  read_px_pft_vars(sink, fname, rowidx, colidx);
 
-  read_px_pftpart_pft_vars(fname, rowidx, colidx);
+  read_px_pftpart_pft_vars(sink, fname, rowidx, colidx);
 
-  read_px_snow_vars(fname, rowidx, colidx);
+  read_px_snow_vars(sink, fname, rowidx, colidx);
 
-  read_px_root_pft_vars(fname, rowidx, colidx);
+  read_px_root_pft_vars(sink, fname, rowidx, colidx);
 
-  read_px_soil_vars(fname, rowidx, colidx);
+  read_px_soil_vars(sink, fname, rowidx, colidx);
 
-  read_px_rock_vars(fname, rowidx, colidx);
+  read_px_rock_vars(sink, fname, rowidx, colidx);
 
-  read_px_front_vars(fname, rowidx, colidx);
+  read_px_front_vars(sink, fname, rowidx, colidx);
 
-  read_px_prev_pft_vars(fname, rowidx, colidx);
+  read_px_prev_pft_vars(sink, fname, rowidx, colidx);
 
   BOOST_LOG_SEV(glg, debug) << "Done reading data from file into RestartData.";
 }
 
-/** Copies values from this RestartData object to a NetCDF file. */
-void RestartData::write_pixel_to_ncfile(const std::string& fname, const int rowidx, const int colidx) {
+/** Copies values from this RestartData object to a NetCDF file, through
+ *  the sink's open handle.
+ */
+void RestartData::write_pixel_to_ncfile(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx) {
 
-  BOOST_LOG_SEV(glg, debug) << "Opening dataset: " << fname
-                            << " to WRITE RestartData for pixel (y, x): ("
+  BOOST_LOG_SEV(glg, debug) << "Writing RestartData to " << fname << " for pixel (y, x): ("
                             << rowidx << "," << colidx << ")";
 
-  BOOST_LOG_SEV(glg, debug) << temutil::report_yx_pixel_dims2str(fname);
-  BOOST_LOG_SEV(glg, debug) << temutil::report_on_netcdf_file(fname, "dsr");
-
-  write_px_vars(fname, rowidx, colidx);
+  write_px_vars(sink, fname, rowidx, colidx);
 
-  write_px_pft_vars(fname, rowidx, colidx);
+  write_px_pft_vars(sink, fname, rowidx, colidx);
 
-  write_px_pftpart_pft_vars(fname, rowidx, colidx);
+  write_px_pftpart_pft_vars(sink, fname, rowidx, colidx);
 
-  write_px_snow_vars(fname, rowidx, colidx);
+  write_px_snow_vars(sink, fname, rowidx, colidx);
 
-  write_px_root_pft_vars(fname, rowidx, colidx);
+  write_px_root_pft_vars(sink, fname, rowidx, colidx);
 
-  write_px_soil_vars(fname, rowidx, colidx);
+  write_px_soil_vars(sink, fname, rowidx, colidx);
 
-  write_px_rock_vars(fname, rowidx, colidx);
+  write_px_rock_vars(sink, fname, rowidx, colidx);
 
-  write_px_front_vars(fname, rowidx, colidx);
+  write_px_front_vars(sink, fname, rowidx, colidx);
 
-  write_px_prev_pft_vars(fname, rowidx, colidx);
+  write_px_prev_pft_vars(sink, fname, rowidx, colidx);
 
   BOOST_LOG_SEV(glg, debug) << "Done writing RestartData.";
 
@@ -550,76 +551,42 @@ void RestartData::verify_logical_values(){
 
 
 /** Read single values for variables have dimensions (Y, X).*/
-void RestartData::read_px_vars(const std::string& fname, const int rowidx, const int colidx) {
- 
-  BOOST_LOG_SEV(glg, debug) << "Opening restart: " << fname;
- 
-  int ncid;
-  temutil::nc( nc_open(fname.c_str(), NC_NOWRITE, &ncid), fname );
-
-  // Check dimension presence? length? size?
-
-  int cv; // a reusable variable handle
+void RestartData::read_px_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx) {
 
   size_t start[2];
   start[0] = rowidx;
   start[1] = colidx;
 
+  size_t count[2];
+  count[0] = 1;
+  count[1] = 1;
+
   // atmosphere stuff
-  temutil::nc( nc_inq_varid(ncid, "dsr", &cv) );
-  temutil::nc( nc_get_var1_int(ncid, cv, start, &dsr) );
-  temutil::nc( nc_inq_varid(ncid, "firea2sorgn", &cv) );
-  temutil::nc( nc_get_var1_double(ncid, cv, start, &firea2sorgn) );
+  sink.get(fname, "dsr", start, count, &dsr);
+  sink.get(fname, "firea2sorgn", start, count, &firea2sorgn);
 
   // vegegetation stuff
-  temutil::nc( nc_inq_varid(ncid, "yrsdist", &cv) );
-  temutil::nc( nc_get_var1_int(ncid, cv, start, &yrsdist) );
+  sink.get(fname, "yrsdist", start, count, &yrsdist);
 
   // snow stuff
-  temutil::nc( nc_inq_varid(ncid, "numsnwl", &cv) );
-  temutil::nc( nc_get_var1_int(ncid, cv, start, &numsnwl) );
-  temutil::nc( nc_inq_varid(ncid, "snwextramass", &cv) );
-  temutil::nc( nc_get_var1_double(ncid, cv, start, &snwextramass) );
+  sink.get(fname, "numsnwl", start, count, &numsnwl);
+  sink.get(fname, "snwextramass", start, count, &snwextramass);
 
   // ground / soil stuff
-  temutil::nc( nc_inq_varid(ncid, "numsl", &cv) );
-  temutil::nc( nc_get_var1_int(ncid, cv, start, &numsl) );
-  temutil::nc( nc_inq_varid(ncid, "monthsfrozen", &cv) );
-  temutil::nc( nc_get_var1_double(ncid, cv, start, &monthsfrozen) );
-  temutil::nc( nc_inq_varid(ncid, "rtfrozendays", &cv) );
-  temutil::nc( nc_get_var1_int(ncid, cv, start, &rtfrozendays) );
-  temutil::nc( nc_inq_varid(ncid, "rtunfrozendays", &cv) );
-  temutil::nc( nc_get_var1_int(ncid, cv, start, &rtunfrozendays) );
-  temutil::nc( nc_inq_varid(ncid, "watertab", &cv) );
-  temutil::nc( nc_get_var1_double(ncid, cv, start, &watertab) );
+  sink.get(fname, "numsl", start, count, &numsl);
+  sink.get(fname, "monthsfrozen", start, count, &monthsfrozen);
+  sink.get(fname, "rtfrozendays", start, count, &rtfrozendays);
+  sink.get(fname, "rtunfrozendays", start, count, &rtunfrozendays);
+  sink.get(fname, "watertab", start, count, &watertab);
 
   // other stuff?
-  temutil::nc( nc_inq_varid(ncid, "wdebrisc", &cv) );
-  temutil::nc( nc_get_var1_double(ncid, cv, start, &wdebrisc) );
-  temutil::nc( nc_inq_varid(ncid, "wdebrisn", &cv) );
-  temutil::nc( nc_get_var1_double(ncid, cv, start, &wdebrisn) );
-
-  temutil::nc( nc_close(ncid) );
-
-  // Also works to use the nc_get_vara_TYPE(...) variation
-  //size_t count[2];
-  //count[0] = 1;
-  //count[1] = 1;
-  //temutil::nc( nc_get_vara_int(ncid, cv, start, count, &dsr) );   // write an array
+  sink.get(fname, "wdebrisc", start, count, &wdebrisc);
+  sink.get(fname, "wdebrisn", start, count, &wdebrisn);
 }
 
 /** Reads arrays of values for variables that have dimensions (Y, X, pft). */
-void RestartData::read_px_pft_vars(const std::string& fname, const int rowidx, const int colidx) {
-
-  BOOST_LOG_SEV(glg, debug) << "Opening restart: " << fname;
-
-  int ncid;
-  temutil::nc( nc_open(fname.c_str(), NC_NOWRITE, &ncid), fname );
-
-  // Check dimension presence? length? size?
+void RestartData::read_px_pft_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx) {
 
-  int cv; // a reusable variable handle
-  
   size_t start[3];
   start[0] = rowidx;
   start[1] = colidx;
@@ -630,58 +597,30 @@ void RestartData::read_px_pft_vars(const std::string& fname, const int rowidx, c
   count[1] = 1;
   count[2] = NUM_PFT;
   
-  temutil::nc( nc_inq_varid(ncid, "ifwoody", &cv) );
-  temutil::nc( nc_get_vara_int(ncid, cv, start, count, &ifwoody[0]) );
-  temutil::nc( nc_inq_varid(ncid, "ifdeciwoody", &cv) );
-  temutil::nc( nc_get_vara_int(ncid, cv, start, count, &ifdeciwoody[0]) );
-  temutil::nc( nc_inq_varid(ncid, "ifperenial", &cv) );
-  temutil::nc( nc_get_vara_int(ncid, cv, start, count, &ifperenial[0]) );
-  temutil::nc( nc_inq_varid(ncid, "nonvascular", &cv) );
-  temutil::nc( nc_get_vara_int(ncid, cv, start, count, &nonvascular[0]) );
-  temutil::nc( nc_inq_varid(ncid, "vegage", &cv) );
-  temutil::nc( nc_get_vara_int(ncid, cv, start, count, &vegage[0]) );
+  sink.get(fname, "ifwoody", start, count, &ifwoody[0]);
+  sink.get(fname, "ifdeciwoody", start, count, &ifdeciwoody[0]);
+  sink.get(fname, "ifperenial", start, count, &ifperenial[0]);
+  sink.get(fname, "nonvascular", start, count, &nonvascular[0]);
+  sink.get(fname, "vegage", start, count, &vegage[0]);
   
-  temutil::nc( nc_inq_varid(ncid, "vegcov", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &vegcov[0]) );
-  temutil::nc( nc_inq_varid(ncid, "lai", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &lai[0]) );
-  temutil::nc( nc_inq_varid(ncid, "vegwater", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &vegwater[0]) );
-  temutil::nc( nc_inq_varid(ncid, "vegsnow", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &vegsnow[0]) );
-  temutil::nc( nc_inq_varid(ncid, "labn", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &labn[0]) );
-  temutil::nc( nc_inq_varid(ncid, "deadc", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &deadc[0]) );
-  temutil::nc( nc_inq_varid(ncid, "deadn", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &deadn[0]) );
-  temutil::nc( nc_inq_varid(ncid, "topt", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &topt[0]) );
-  temutil::nc( nc_inq_varid(ncid, "eetmx", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &eetmx[0]) );
-  temutil::nc( nc_inq_varid(ncid, "unnormleaf", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &unnormleaf[0]) );
-  temutil::nc( nc_inq_varid(ncid, "unnormleafmx", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &unnormleafmx[0]) );
-  temutil::nc( nc_inq_varid(ncid, "growingttime", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &growingttime[0]) );
-  temutil::nc( nc_inq_varid(ncid, "foliagemx", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &foliagemx[0]) );
-
-  temutil::nc( nc_close(ncid) );
-
+  sink.get(fname, "vegcov", start, count, &vegcov[0]);
+  sink.get(fname, "lai", start, count, &lai[0]);
+  sink.get(fname, "vegwater", start, count, &vegwater[0]);
+  sink.get(fname, "vegsnow", start, count, &vegsnow[0]);
+  sink.get(fname, "labn", start, count, &labn[0]);
+  sink.get(fname, "deadc", start, count, &deadc[0]);
+  sink.get(fname, "deadn", start, count, &deadn[0]);
+  sink.get(fname, "topt", start, count, &topt[0]);
+  sink.get(fname, "eetmx", start, count, &eetmx[0]);
+  sink.get(fname, "unnormleaf", start, count, &unnormleaf[0]);
+  sink.get(fname, "unnormleafmx", start, count, &unnormleafmx[0]);
+  sink.get(fname, "growingttime", start, count, &growingttime[0]);
+  sink.get(fname, "foliagemx", start, count, &foliagemx[0]);
 }
 
 /** Read arrays for variables that have dimensions (Y, X, pftpart, pft). */
-void RestartData::read_px_pftpart_pft_vars(const std::string& fname, const int rowidx, const int colidx) {
-
-  BOOST_LOG_SEV(glg, debug) << "Opening restart: " << fname;
-
-  int ncid;
-  temutil::nc( nc_open(fname.c_str(), NC_NOWRITE, &ncid), fname );
+void RestartData::read_px_pftpart_pft_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx) {
 
-  int cv; // a reusable variable handle
-  
   size_t start[4];
   start[0] = rowidx;
   start[1] = colidx;
@@ -694,30 +633,15 @@ void RestartData::read_px_pftpart_pft_vars(const std::string& fname, const int r
   count[2] = NUM_PFT_PART;
   count[3] = NUM_PFT;
   
-  temutil::nc( nc_inq_varid(ncid, "vegc", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &vegc[0][0]) );
+  sink.get(fname, "vegc", start, count, &vegc[0][0]);
   
-  temutil::nc( nc_inq_varid(ncid, "strn", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &strn[0][0]) );
-
-  temutil::nc( nc_inq_varid(ncid, "vegC2N", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &vegC2N[0][0]) );
-  
-  temutil::nc( nc_close(ncid) );
+  sink.get(fname, "strn", start, count, &strn[0][0]);
 
+  sink.get(fname, "vegC2N", start, count, &vegC2N[0][0]);
 }
 
 /**  Reads arrays for variables with dimensions (Y, X, snowlayer) */
-void RestartData::read_px_snow_vars(const std::string& fname, const int rowidx, const int colidx) {
-
-  BOOST_LOG_SEV(glg, debug) << "Opening restart: " << fname;
-
-  int ncid;
-  temutil::nc( nc_open(fname.c_str(), NC_NOWRITE, &ncid), fname );
-
-  // Check dimension presence? length? size?
-
-  int cv; // a reusable variable handle
+void RestartData::read_px_snow_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx) {
 
   size_t start[3];
   start[0] = rowidx;
@@ -729,32 +653,17 @@ void RestartData::read_px_snow_vars(const std::string& fname, const int rowidx,
   count[1] = 1;
   count[2] = MAX_SNW_LAY;
 
-  temutil::nc( nc_inq_varid(ncid, "TSsnow", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &TSsnow[0]) );
-
-  temutil::nc( nc_inq_varid(ncid, "DZsnow", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &DZsnow[0]) );
-  temutil::nc( nc_inq_varid(ncid, "LIQsnow", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &LIQsnow[0]) );
-  temutil::nc( nc_inq_varid(ncid, "RHOsnow", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &RHOsnow[0]) );
-  temutil::nc( nc_inq_varid(ncid, "ICEsnow", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &ICEsnow[0]) );
-  temutil::nc( nc_inq_varid(ncid, "AGEsnow", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &AGEsnow[0]) );
+  sink.get(fname, "TSsnow", start, count, &TSsnow[0]);
 
-  temutil::nc( nc_close(ncid) );
+  sink.get(fname, "DZsnow", start, count, &DZsnow[0]);
+  sink.get(fname, "LIQsnow", start, count, &LIQsnow[0]);
+  sink.get(fname, "RHOsnow", start, count, &RHOsnow[0]);
+  sink.get(fname, "ICEsnow", start, count, &ICEsnow[0]);
+  sink.get(fname, "AGEsnow", start, count, &AGEsnow[0]);
 }
 
 /**  Reads arrays for variables with dimensions (Y, X, rootlayer, pft) */
-void RestartData::read_px_root_pft_vars(const std::string& fname, const int rowidx, const int colidx) {
-
-  BOOST_LOG_SEV(glg, debug) << "Opening restart: " << fname;
-
-  int ncid;
-  temutil::nc( nc_open(fname.c_str(), NC_NOWRITE, &ncid), fname );
-
-  int cv; // a reusable variable handle
+void RestartData::read_px_root_pft_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx) {
 
   size_t start[4];
   start[0] = rowidx;
@@ -768,22 +677,11 @@ void RestartData::read_px_root_pft_vars(const std::string& fname, const int rowi
   count[2] = MAX_ROT_LAY;
   count[3] = NUM_PFT;
 
-  temutil::nc( nc_inq_varid(ncid, "rootfrac", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &rootfrac[0][0]) );
-
-  temutil::nc( nc_close(ncid) );
-
+  sink.get(fname, "rootfrac", start, count, &rootfrac[0][0]);
 }
 
 /**  Reads arrays for variables with dimensions (Y, X, soillayer) */
-void RestartData::read_px_soil_vars(const std::string& fname, const int rowidx, const int colidx) {
-
-  BOOST_LOG_SEV(glg, debug) << "Opening restart: " << fname;
-
-  int ncid;
-  temutil::nc( nc_open(fname.c_str(), NC_NOWRITE, &ncid), fname );
-
-  int cv; // a reusable variable handle
+void RestartData::read_px_soil_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx) {
 
   size_t start[3];
   start[0] = rowidx;
@@ -795,50 +693,25 @@ void RestartData::read_px_soil_vars(const std::string& fname, const int rowidx,
   count[1] = 1;
   count[2] = MAX_SOI_LAY;
 
-  temutil::nc( nc_inq_varid(ncid, "TYPEsoil", &cv) );
-  temutil::nc( nc_get_vara_int(ncid, cv, start, count, &TYPEsoil[0]) );
-  temutil::nc( nc_inq_varid(ncid, "AGEsoil", &cv) );
-  temutil::nc( nc_get_vara_int(ncid, cv, start, count, &AGEsoil[0]) );
-  temutil::nc( nc_inq_varid(ncid, "FROZENsoil", &cv) );
-  temutil::nc( nc_get_vara_int(ncid, cv, start, count, &FROZENsoil[0]) );
-
-  temutil::nc( nc_inq_varid(ncid, "DZsoil", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &DZsoil[0]) );
-  temutil::nc( nc_inq_varid(ncid, "TSsoil", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &TSsoil[0]) );
-  temutil::nc( nc_inq_varid(ncid, "LIQsoil", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &LIQsoil[0]) );
-  temutil::nc( nc_inq_varid(ncid, "ICEsoil", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &ICEsoil[0]) );
-  temutil::nc( nc_inq_varid(ncid, "FROZENFRACsoil", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &FROZENFRACsoil[0]) );
-  temutil::nc( nc_inq_varid(ncid, "rawc", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &rawc[0]) );
-  temutil::nc( nc_inq_varid(ncid, "soma", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &soma[0]) );
-  temutil::nc( nc_inq_varid(ncid, "sompr", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &sompr[0]) );
-  temutil::nc( nc_inq_varid(ncid, "somcr", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &somcr[0]) );
-  temutil::nc( nc_inq_varid(ncid, "orgn", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &orgn[0]) );
-  temutil::nc( nc_inq_varid(ncid, "avln", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &avln[0]) );
-
-  temutil::nc( nc_close(ncid) );
+  sink.get(fname, "TYPEsoil", start, count, &TYPEsoil[0]);
+  sink.get(fname, "AGEsoil", start, count, &AGEsoil[0]);
+  sink.get(fname, "FROZENsoil", start, count, &FROZENsoil[0]);
+
+  sink.get(fname, "DZsoil", start, count, &DZsoil[0]);
+  sink.get(fname, "TSsoil", start, count, &TSsoil[0]);
+  sink.get(fname, "LIQsoil", start, count, &LIQsoil[0]);
+  sink.get(fname, "ICEsoil", start, count, &ICEsoil[0]);
+  sink.get(fname, "FROZENFRACsoil", start, count, &FROZENFRACsoil[0]);
+  sink.get(fname, "rawc", start, count, &rawc[0]);
+  sink.get(fname, "soma", start, count, &soma[0]);
+  sink.get(fname, "sompr", start, count, &sompr[0]);
+  sink.get(fname, "somcr", start, count, &somcr[0]);
+  sink.get(fname, "orgn", start, count, &orgn[0]);
+  sink.get(fname, "avln", start, count, &avln[0]);
 }
 
 /**  Reads arrays of values for variables that have dimensions (Y, X, rocklayer). */
-void RestartData::read_px_rock_vars(const std::string& fname, const int rowidx, const int colidx) {
-
-  BOOST_LOG_SEV(glg, debug) << "Opening restart: " << fname;
-
-  int ncid;
-  temutil::nc( nc_open(fname.c_str(), NC_NOWRITE, &ncid), fname );
-
-  // Check dimension presence? length? size?
-
-  int cv; // a reusable variable handle
+void RestartData::read_px_rock_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx) {
 
   size_t start[3];
   start[0] = rowidx;
@@ -850,24 +723,12 @@ void RestartData::read_px_rock_vars(const std::string& fname, const int rowidx,
   count[1] = 1;
   count[2] = MAX_ROC_LAY;
 
-  temutil::nc( nc_inq_varid(ncid, "TSrock", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &TSrock[0]) );
-  temutil::nc( nc_inq_varid(ncid, "DZrock", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &DZrock[0]) );
-
-  temutil::nc( nc_close(ncid) );
-
+  sink.get(fname, "TSrock", start, count, &TSrock[0]);
+  sink.get(fname, "DZrock", start, count, &DZrock[0]);
 }
 
 /**  Reads arrays of values for variables that have dimensions (Y, X, fronts). */
-void RestartData::read_px_front_vars(const std::string& fname, const int rowidx, const int colidx) {
-
-  BOOST_LOG_SEV(glg, debug) << "Opening restart: " << fname;
-
-  int ncid;
-  temutil::nc( nc_open(fname.c_str(), NC_NOWRITE, &ncid), fname );
-
-  int cv; // a reusable variable handle
+void RestartData::read_px_front_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx) {
 
   size_t start[3];
   start[0] = rowidx;
@@ -879,14 +740,9 @@ void RestartData::read_px_front_vars(const std::string& fname, const int rowidx,
   count[1] = 1;
   count[2] = MAX_NUM_FNT;
 
-  temutil::nc( nc_inq_varid(ncid, "frontFT", &cv) );
-  temutil::nc( nc_get_vara_int(ncid, cv, start, count, &frontFT[0]) );
-
-  temutil::nc( nc_inq_varid(ncid, "frontZ", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &frontZ[0]) );
-
-  temutil::nc( nc_close(ncid) );
+  sink.get(fname, "frontFT", start, count, &frontFT[0]);
 
+  sink.get(fname, "frontZ", start, count, &frontZ[0]);
 }
 
 /**  Reads arrays for variables with dimensions (Y, X, prev<XX>, pft). Used for
@@ -895,14 +751,7 @@ void RestartData::read_px_front_vars(const std::string& fname, const int rowidx,
 * Note: The name of this function is somewhat misleading as it also handles one
 * soil variable!
 */
-void RestartData::read_px_prev_pft_vars(const std::string& fname, const int rowidx, const int colidx) {
-
-  BOOST_LOG_SEV(glg, debug) << "Opening restart: " << fname;
-
-  int ncid;
-  temutil::nc( nc_open(fname.c_str(), NC_NOWRITE, &ncid), fname );
-
-  int cv; // a reusable variable handle
+void RestartData::read_px_prev_pft_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx) {
 
   size_t start[4];
   start[0] = rowidx;
@@ -916,25 +765,16 @@ void RestartData::read_px_prev_pft_vars(const std::string& fname, const int rowi
   count[2] = 10;        // <-- previous 10 years?...
   count[3] = NUM_PFT;
 
-  temutil::nc( nc_inq_varid(ncid, "toptA", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &toptA[0][0]) );
-  temutil::nc( nc_inq_varid(ncid, "eetmxA", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &eetmxA[0][0]) );
-  temutil::nc( nc_inq_varid(ncid, "growingttimeA", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &growingttimeA[0][0]) );
-  temutil::nc( nc_inq_varid(ncid, "unnormleafmxA", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &unnormleafmxA[0][0]) );
+  sink.get(fname, "toptA", start, count, &toptA[0][0]);
+  sink.get(fname, "eetmxA", start, count, &eetmxA[0][0]);
+  sink.get(fname, "growingttimeA", start, count, &growingttimeA[0][0]);
+  sink.get(fname, "unnormleafmxA", start, count, &unnormleafmxA[0][0]);
 
   // Adjust offsets for use with monthly soil variable.
   count[2] = 12;        // <-- previous 12 months
   count[3] = MAX_SOI_LAY;
 
-  temutil::nc( nc_inq_varid(ncid, "prvltrfcnA", &cv) );
-  temutil::nc( nc_get_vara_double(ncid, cv, start, count, &prvltrfcnA[0][0]) );
-
-
-  temutil::nc( nc_close(ncid) );
-
+  sink.get(fname, "prvltrfcnA", start, count, &prvltrfcnA[0][0]);
 }
 
 
@@ -945,6 +785,8 @@ void RestartData::create_empty_file(const std::string& fname,
   BOOST_LOG_SEV(glg, debug) << "Opening new file: "<<fname<<" with 'NC_CLOBBER'";
   int ncid;
 
+  temutil::NetCDFLock lock(temutil::netcdf_mutex());
+
 #ifdef WITHMPI
   BOOST_LOG_SEV(glg, debug) << "Creating new parallel restart file: "<<fname;
   temutil::nc( nc_create_par(fname.c_str(), NC_CLOBBER|NC_NETCDF4|NC_MPIIO, MPI_COMM_WORLD, MPI_INFO_NULL, &ncid), fname );
@@ -1299,84 +1141,42 @@ void RestartData::create_empty_file(const std::string& fname,
 
 
 /** Writes single values for variables have dimensions (Y, X).*/
-void RestartData::write_px_vars(const std::string& fname, const int rowidx, const int colidx) {
-  
-  BOOST_LOG_SEV(glg, debug) << "Opening restart: " << fname;
-  int ncid;
-
-#ifdef WITHMPI
-  temutil::nc( nc_open_par(fname.c_str(), NC_WRITE|NC_MPIIO, MPI_COMM_SELF, MPI_INFO_NULL, &ncid), fname );
-#else
-  temutil::nc( nc_open(fname.c_str(), NC_WRITE, &ncid), fname );
-#endif
-
-  // Check dimension presence? length? size?
-
-  int cv; // a reusable variable handle
+void RestartData::write_px_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx) {
 
   size_t start[2];
   start[0] = rowidx;
   start[1] = colidx;
 
+  size_t count[2];
+  count[0] = 1;
+  count[1] = 1;
+
   // atmosphere stuff
-  temutil::nc( nc_inq_varid(ncid, "dsr", &cv) );
-  temutil::nc( nc_put_var1_int(ncid, cv, start, &dsr) );
-  temutil::nc( nc_inq_varid(ncid, "firea2sorgn", &cv) );
-  temutil::nc( nc_put_var1_double(ncid, cv, start, &firea2sorgn) );
+  sink.put(fname, "dsr", start, count, &dsr);
+  sink.put(fname, "firea2sorgn", start, count, &firea2sorgn);
 
   // vegegetation stuff
-  temutil::nc( nc_inq_varid(ncid, "yrsdist", &cv) );
-  temutil::nc( nc_put_var1_int(ncid, cv, start, &yrsdist) );
+  sink.put(fname, "yrsdist", start, count, &yrsdist);
 
   // snow stuff
-  temutil::nc( nc_inq_varid(ncid, "numsnwl", &cv) );
-  temutil::nc( nc_put_var1_int(ncid, cv, start, &numsnwl) );
-  temutil::nc( nc_inq_varid(ncid, "snwextramass", &cv) );
-  temutil::nc( nc_put_var1_double(ncid, cv, start, &snwextramass) );
+  sink.put(fname, "numsnwl", start, count, &numsnwl);
+  sink.put(fname, "snwextramass", start, count, &snwextramass);
 
   // ground / soil stuff
-  temutil::nc( nc_inq_varid(ncid, "numsl", &cv) );
-  temutil::nc( nc_put_var1_int(ncid, cv, start, &numsl) );
-  temutil::nc( nc_inq_varid(ncid, "monthsfrozen", &cv) );
-  temutil::nc( nc_put_var1_double(ncid, cv, start, &monthsfrozen) );
-  temutil::nc( nc_inq_varid(ncid, "rtfrozendays", &cv) );
-  temutil::nc( nc_put_var1_int(ncid, cv, start, &rtfrozendays) );
-  temutil::nc( nc_inq_varid(ncid, "rtunfrozendays", &cv) );
-  temutil::nc( nc_put_var1_int(ncid, cv, start, &rtunfrozendays) );
-  temutil::nc( nc_inq_varid(ncid, "watertab", &cv) );
-  temutil::nc( nc_put_var1_double(ncid, cv, start, &watertab) );
+  sink.put(fname, "numsl", start, count, &numsl);
+  sink.put(fname, "monthsfrozen", start, count, &monthsfrozen);
+  sink.put(fname, "rtfrozendays", start, count, &rtfrozendays);
+  sink.put(fname, "rtunfrozendays", start, count, &rtunfrozendays);
+  sink.put(fname, "watertab", start, count, &watertab);
 
   // other stuff?
-  temutil::nc( nc_inq_varid(ncid, "wdebrisc", &cv) );
-  temutil::nc( nc_put_var1_double(ncid, cv, start, &wdebrisc) );
-  temutil::nc( nc_inq_varid(ncid, "wdebrisn", &cv) );
-  temutil::nc( nc_put_var1_double(ncid, cv, start, &wdebrisn) );
-
-  temutil::nc( nc_close(ncid) );
-
-  // Also works to use the nc_put_vara_TYPE(...) variation
-  //size_t count[2];
-  //count[0] = 1;
-  //count[1] = 1;
-  //temutil::nc( nc_put_vara_int(ncid, cv, start, count, &dsr) );   // write an array
+  sink.put(fname, "wdebrisc", start, count, &wdebrisc);
+  sink.put(fname, "wdebrisn", start, count, &wdebrisn);
 }
 
 /** Writes arrays of values for variables that have dimensions (Y, X, pft). */
-void RestartData::write_px_pft_vars(const std::string& fname, const int rowidx, const int colidx) {
+void RestartData::write_px_pft_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx) {
 
-  BOOST_LOG_SEV(glg, debug) << "Opening restart: " << fname;
-  int ncid;
-
-#ifdef WITHMPI
-  temutil::nc( nc_open_par(fname.c_str(), NC_WRITE|NC_MPIIO, MPI_COMM_SELF, MPI_INFO_NULL, &ncid), fname );
-#else
-  temutil::nc( nc_open(fname.c_str(), NC_WRITE, &ncid), fname );
-#endif
-
-  // Check dimension presence? length? size?
-
-  int cv; // a reusable variable handle
-  
   size_t start[3];
   start[0] = rowidx;
   start[1] = colidx;
@@ -1387,62 +1187,30 @@ void RestartData::write_px_pft_vars(const std::string& fname, const int rowidx,
   count[1] = 1;
   count[2] = NUM_PFT;
   
-  temutil::nc( nc_inq_varid(ncid, "ifwoody", &cv) );
-  temutil::nc( nc_put_vara_int(ncid, cv, start, count, &ifwoody[0]) );
-  temutil::nc( nc_inq_varid(ncid, "ifdeciwoody", &cv) );
-  temutil::nc( nc_put_vara_int(ncid, cv, start, count, &ifdeciwoody[0]) );
-  temutil::nc( nc_inq_varid(ncid, "ifperenial", &cv) );
-  temutil::nc( nc_put_vara_int(ncid, cv, start, count, &ifperenial[0]) );
-  temutil::nc( nc_inq_varid(ncid, "nonvascular", &cv) );
-  temutil::nc( nc_put_vara_int(ncid, cv, start, count, &nonvascular[0]) );
-  temutil::nc( nc_inq_varid(ncid, "vegage", &cv) );
-  temutil::nc( nc_put_vara_int(ncid, cv, start, count, &vegage[0]) );
+  sink.put(fname, "ifwoody", start, count, &ifwoody[0]);
+  sink.put(fname, "ifdeciwoody", start, count, &ifdeciwoody[0]);
+  sink.put(fname, "ifperenial", start, count, &ifperenial[0]);
+  sink.put(fname, "nonvascular", start, count, &nonvascular[0]);
+  sink.put(fname, "vegage", start, count, &vegage[0]);
   
-  temutil::nc( nc_inq_varid(ncid, "vegcov", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &vegcov[0]) );
-  temutil::nc( nc_inq_varid(ncid, "lai", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &lai[0]) );
-  temutil::nc( nc_inq_varid(ncid, "vegwater", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &vegwater[0]) );
-  temutil::nc( nc_inq_varid(ncid, "vegsnow", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &vegsnow[0]) );
-  temutil::nc( nc_inq_varid(ncid, "labn", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &labn[0]) );
-  temutil::nc( nc_inq_varid(ncid, "deadc", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &deadc[0]) );
-  temutil::nc( nc_inq_varid(ncid, "deadn", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &deadn[0]) );
-  temutil::nc( nc_inq_varid(ncid, "topt", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &topt[0]) );
-  temutil::nc( nc_inq_varid(ncid, "eetmx", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &eetmx[0]) );
-  temutil::nc( nc_inq_varid(ncid, "unnormleaf", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &unnormleaf[0]) );
-  temutil::nc( nc_inq_varid(ncid, "unnormleafmx", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &unnormleafmx[0]) );
-  temutil::nc( nc_inq_varid(ncid, "growingttime", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &growingttime[0]) );
-  temutil::nc( nc_inq_varid(ncid, "foliagemx", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &foliagemx[0]) );
-
-  temutil::nc( nc_close(ncid) );
-
+  sink.put(fname, "vegcov", start, count, &vegcov[0]);
+  sink.put(fname, "lai", start, count, &lai[0]);
+  sink.put(fname, "vegwater", start, count, &vegwater[0]);
+  sink.put(fname, "vegsnow", start, count, &vegsnow[0]);
+  sink.put(fname, "labn", start, count, &labn[0]);
+  sink.put(fname, "deadc", start, count, &deadc[0]);
+  sink.put(fname, "deadn", start, count, &deadn[0]);
+  sink.put(fname, "topt", start, count, &topt[0]);
+  sink.put(fname, "eetmx", start, count, &eetmx[0]);
+  sink.put(fname, "unnormleaf", start, count, &unnormleaf[0]);
+  sink.put(fname, "unnormleafmx", start, count, &unnormleafmx[0]);
+  sink.put(fname, "growingttime", start, count, &growingttime[0]);
+  sink.put(fname, "foliagemx", start, count, &foliagemx[0]);
 }
 
 /** Writes arrays for variables that have dimensions (Y, X, pftpart, pft). */
-void RestartData::write_px_pftpart_pft_vars(const std::string& fname, const int rowidx, const int colidx) {
-
-  BOOST_LOG_SEV(glg, debug) << "Opening restart: " << fname;
-  int ncid;
+void RestartData::write_px_pftpart_pft_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx) {
 
-#ifdef WITHMPI
-  temutil::nc( nc_open_par(fname.c_str(), NC_WRITE|NC_MPIIO, MPI_COMM_SELF, MPI_INFO_NULL, &ncid), fname );
-#else
-  temutil::nc( nc_open(fname.c_str(), NC_WRITE, &ncid), fname );
-#endif
-
-  int cv; // a reusable variable handle
-  
   size_t start[4];
   start[0] = rowidx;
   start[1] = colidx;
@@ -1455,35 +1223,16 @@ void RestartData::write_px_pftpart_pft_vars(const std::string& fname, const int
   count[2] = NUM_PFT_PART;
   count[3] = NUM_PFT;
   
-  temutil::nc( nc_inq_varid(ncid, "vegc", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &vegc[0][0]) );
+  sink.put(fname, "vegc", start, count, &vegc[0][0]);
   
-  temutil::nc( nc_inq_varid(ncid, "strn", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &strn[0][0]) ); 
-
-  temutil::nc( nc_inq_varid(ncid, "vegC2N", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &vegC2N[0][0]) );
-  
-  temutil::nc( nc_close(ncid) );
+  sink.put(fname, "strn", start, count, &strn[0][0]); 
 
+  sink.put(fname, "vegC2N", start, count, &vegC2N[0][0]);
 }
 
 /** Writes arrays for variables with dimensions (Y, X, snowlayer) */
-void RestartData::write_px_snow_vars(const std::string& fname, const int rowidx, const int colidx) {
+void RestartData::write_px_snow_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx) {
 
-  BOOST_LOG_SEV(glg, debug) << "Opening restart: " << fname;
-  int ncid;
-
-#ifdef WITHMPI
-  temutil::nc( nc_open_par(fname.c_str(), NC_WRITE|NC_MPIIO, MPI_COMM_SELF, MPI_INFO_NULL, &ncid), fname );
-#else
-  temutil::nc( nc_open(fname.c_str(), NC_WRITE, &ncid), fname );
-#endif
-
-  // Check dimension presence? length? size?
-
-  int cv; // a reusable variable handle
-  
   size_t start[3];
   start[0] = rowidx;
   start[1] = colidx;
@@ -1494,37 +1243,18 @@ void RestartData::write_px_snow_vars(const std::string& fname, const int rowidx,
   count[1] = 1;
   count[2] = MAX_SNW_LAY;
   
-  temutil::nc( nc_inq_varid(ncid, "TSsnow", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &TSsnow[0]) );
-
-  temutil::nc( nc_inq_varid(ncid, "DZsnow", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &DZsnow[0]) );
-  temutil::nc( nc_inq_varid(ncid, "LIQsnow", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &LIQsnow[0]) );
-  temutil::nc( nc_inq_varid(ncid, "RHOsnow", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &RHOsnow[0]) );
-  temutil::nc( nc_inq_varid(ncid, "ICEsnow", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &ICEsnow[0]) );
-  temutil::nc( nc_inq_varid(ncid, "AGEsnow", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &AGEsnow[0]) );
+  sink.put(fname, "TSsnow", start, count, &TSsnow[0]);
 
-  temutil::nc( nc_close(ncid) );
+  sink.put(fname, "DZsnow", start, count, &DZsnow[0]);
+  sink.put(fname, "LIQsnow", start, count, &LIQsnow[0]);
+  sink.put(fname, "RHOsnow", start, count, &RHOsnow[0]);
+  sink.put(fname, "ICEsnow", start, count, &ICEsnow[0]);
+  sink.put(fname, "AGEsnow", start, count, &AGEsnow[0]);
 }
 
 /** Writes arrays for variables with dimensions (Y, X, rootlayer, pft) */
-void RestartData::write_px_root_pft_vars(const std::string& fname, const int rowidx, const int colidx) {
-
-  BOOST_LOG_SEV(glg, debug) << "Opening restart: " << fname;
-  int ncid;
-
-#ifdef WITHMPI
-  temutil::nc( nc_open_par(fname.c_str(), NC_WRITE|NC_MPIIO, MPI_COMM_SELF, MPI_INFO_NULL, &ncid), fname );
-#else
-  temutil::nc( nc_open(fname.c_str(), NC_WRITE, &ncid), fname );
-#endif
+void RestartData::write_px_root_pft_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx) {
 
-  int cv; // a reusable variable handle
-  
   size_t start[4];
   start[0] = rowidx;
   start[1] = colidx;
@@ -1537,27 +1267,12 @@ void RestartData::write_px_root_pft_vars(const std::string& fname, const int row
   count[2] = MAX_ROT_LAY;
   count[3] = NUM_PFT;
   
-  temutil::nc( nc_inq_varid(ncid, "rootfrac", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &rootfrac[0][0]) );
-  
-  temutil::nc( nc_close(ncid) );
-
+  sink.put(fname, "rootfrac", start, count, &rootfrac[0][0]);
 }
 
 /** Writes arrays for variables with dimensions (Y, X, soillayer) */
-void RestartData::write_px_soil_vars(const std::string& fname, const int rowidx, const int colidx) {
-
-  BOOST_LOG_SEV(glg, debug) << "Opening restart: " << fname;
-  int ncid;
+void RestartData::write_px_soil_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx) {
 
-#ifdef WITHMPI
-  temutil::nc( nc_open_par(fname.c_str(), NC_WRITE|NC_MPIIO, MPI_COMM_SELF, MPI_INFO_NULL, &ncid), fname );
-#else
-  temutil::nc( nc_open(fname.c_str(), NC_WRITE, &ncid), fname );
-#endif
-
-  int cv; // a reusable variable handle
-  
   size_t start[3];
   start[0] = rowidx;
   start[1] = colidx;
@@ -1568,55 +1283,26 @@ void RestartData::write_px_soil_vars(const std::string& fname, const int rowidx,
   count[1] = 1;
   count[2] = MAX_SOI_LAY;
   
-  temutil::nc( nc_inq_varid(ncid, "TYPEsoil", &cv) );
-  temutil::nc( nc_put_vara_int(ncid, cv, start, count, &TYPEsoil[0]) );
-  temutil::nc( nc_inq_varid(ncid, "AGEsoil", &cv) );
-  temutil::nc( nc_put_vara_int(ncid, cv, start, count, &AGEsoil[0]) );
-  temutil::nc( nc_inq_varid(ncid, "FROZENsoil", &cv) );
-  temutil::nc( nc_put_vara_int(ncid, cv, start, count, &FROZENsoil[0]) );
+  sink.put(fname, "TYPEsoil", start, count, &TYPEsoil[0]);
+  sink.put(fname, "AGEsoil", start, count, &AGEsoil[0]);
+  sink.put(fname, "FROZENsoil", start, count, &FROZENsoil[0]);
   
-  temutil::nc( nc_inq_varid(ncid, "DZsoil", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &DZsoil[0]) );
-  temutil::nc( nc_inq_varid(ncid, "TSsoil", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &TSsoil[0]) );
-  temutil::nc( nc_inq_varid(ncid, "LIQsoil", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &LIQsoil[0]) );
-  temutil::nc( nc_inq_varid(ncid, "ICEsoil", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &ICEsoil[0]) );
-  temutil::nc( nc_inq_varid(ncid, "FROZENFRACsoil", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &FROZENFRACsoil[0]) );
-  temutil::nc( nc_inq_varid(ncid, "rawc", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &rawc[0]) );
-  temutil::nc( nc_inq_varid(ncid, "soma", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &soma[0]) );
-  temutil::nc( nc_inq_varid(ncid, "sompr", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &sompr[0]) );
-  temutil::nc( nc_inq_varid(ncid, "somcr", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &somcr[0]) );
-  temutil::nc( nc_inq_varid(ncid, "orgn", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &orgn[0]) );
-  temutil::nc( nc_inq_varid(ncid, "avln", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &avln[0]) );
-
-  temutil::nc( nc_close(ncid) );
+  sink.put(fname, "DZsoil", start, count, &DZsoil[0]);
+  sink.put(fname, "TSsoil", start, count, &TSsoil[0]);
+  sink.put(fname, "LIQsoil", start, count, &LIQsoil[0]);
+  sink.put(fname, "ICEsoil", start, count, &ICEsoil[0]);
+  sink.put(fname, "FROZENFRACsoil", start, count, &FROZENFRACsoil[0]);
+  sink.put(fname, "rawc", start, count, &rawc[0]);
+  sink.put(fname, "soma", start, count, &soma[0]);
+  sink.put(fname, "sompr", start, count, &sompr[0]);
+  sink.put(fname, "somcr", start, count, &somcr[0]);
+  sink.put(fname, "orgn", start, count, &orgn[0]);
+  sink.put(fname, "avln", start, count, &avln[0]);
 }
 
 /** Writes arrays of values for variables that have dimensions (Y, X, rocklayer). */
-void RestartData::write_px_rock_vars(const std::string& fname, const int rowidx, const int colidx) {
+void RestartData::write_px_rock_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx) {
 
-  BOOST_LOG_SEV(glg, debug) << "Opening restart: " << fname;
-  int ncid;
-
-#ifdef WITHMPI
-  temutil::nc( nc_open_par(fname.c_str(), NC_WRITE|NC_MPIIO, MPI_COMM_SELF, MPI_INFO_NULL, &ncid), fname );
-#else
-  temutil::nc( nc_open(fname.c_str(), NC_WRITE, &ncid), fname );
-#endif
-
-  // Check dimension presence? length? size?
-
-  int cv; // a reusable variable handle
-  
   size_t start[3];
   start[0] = rowidx;
   start[1] = colidx;
@@ -1627,29 +1313,13 @@ void RestartData::write_px_rock_vars(const std::string& fname, const int rowidx,
   count[1] = 1;
   count[2] = MAX_ROC_LAY;
   
-  temutil::nc( nc_inq_varid(ncid, "TSrock", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &TSrock[0]) );
-  temutil::nc( nc_inq_varid(ncid, "DZrock", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &DZrock[0]) );
-
-  temutil::nc( nc_close(ncid) );
-
+  sink.put(fname, "TSrock", start, count, &TSrock[0]);
+  sink.put(fname, "DZrock", start, count, &DZrock[0]);
 }
 
 /** Writes arrays of values for variables that have dimensions (Y, X, fronts). */
-void RestartData::write_px_front_vars(const std::string& fname, const int rowidx, const int colidx) {
+void RestartData::write_px_front_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx) {
 
-  BOOST_LOG_SEV(glg, debug) << "Opening restart: " << fname;
-  int ncid;
-
-#ifdef WITHMPI
-  temutil::nc( nc_open_par(fname.c_str(), NC_WRITE|NC_MPIIO, MPI_COMM_SELF, MPI_INFO_NULL, &ncid), fname );
-#else
-  temutil::nc( nc_open(fname.c_str(), NC_WRITE, &ncid), fname );
-#endif
-
-  int cv; // a reusable variable handle
-  
   size_t start[3];
   start[0] = rowidx;
   start[1] = colidx;
@@ -1660,14 +1330,9 @@ void RestartData::write_px_front_vars(const std::string& fname, const int rowidx
   count[1] = 1;
   count[2] = MAX_NUM_FNT;
   
-  temutil::nc( nc_inq_varid(ncid, "frontFT", &cv) );
-  temutil::nc( nc_put_vara_int(ncid, cv, start, count, &frontFT[0]) );
-
-  temutil::nc( nc_inq_varid(ncid, "frontZ", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &frontZ[0]) );
-
-  temutil::nc( nc_close(ncid) );
+  sink.put(fname, "frontFT", start, count, &frontFT[0]);
 
+  sink.put(fname, "frontZ", start, count, &frontZ[0]);
 }
 
 /** Writes arrays for variables with dimensions (Y, X, prev<XX>, pft).
@@ -1676,18 +1341,7 @@ void RestartData::write_px_front_vars(const std::string& fname, const int rowidx
 * Note: This function name is somewhat misleading as it also handles one soil 
 * variable!
 */
-void RestartData::write_px_prev_pft_vars(const std::string& fname, const int rowidx, const int colidx) {
-
-  BOOST_LOG_SEV(glg, debug) << "Opening restart: " << fname;
-  int ncid;
-
-#ifdef WITHMPI
-  temutil::nc( nc_open_par(fname.c_str(), NC_WRITE|NC_MPIIO, MPI_COMM_SELF, MPI_INFO_NULL, &ncid), fname );
-#else
-  temutil::nc( nc_open(fname.c_str(), NC_WRITE, &ncid), fname );
-#endif
-
-  int cv; // a reusable variable handle
+void RestartData::write_px_prev_pft_vars(OutputSink& sink, const std::string& fname, const int rowidx, const int colidx) {
 
   size_t start[4];
   start[0] = rowidx;
@@ -1701,24 +1355,16 @@ void RestartData::write_px_prev_pft_vars(const std::string& fname, const int row
   count[2] = 10;        // <-- previous 10 years?...
   count[3] = NUM_PFT;
 
-  temutil::nc( nc_inq_varid(ncid, "toptA", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &toptA[0][0]) );
-  temutil::nc( nc_inq_varid(ncid, "eetmxA", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &eetmxA[0][0]) );
-  temutil::nc( nc_inq_varid(ncid, "growingttimeA", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &growingttimeA[0][0]) );
-  temutil::nc( nc_inq_varid(ncid, "unnormleafmxA", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &unnormleafmxA[0][0]) );
+  sink.put(fname, "toptA", start, count, &toptA[0][0]);
+  sink.put(fname, "eetmxA", start, count, &eetmxA[0][0]);
+  sink.put(fname, "growingttimeA", start, count, &growingttimeA[0][0]);
+  sink.put(fname, "unnormleafmxA", start, count, &unnormleafmxA[0][0]);
 
   // Adjust offsets for working with the a monthly soil variable.
   count[2] = 12;        // <-- previous 10 years?...
   count[3] = MAX_SOI_LAY;
 
-  temutil::nc( nc_inq_varid(ncid, "prvltrfcnA", &cv) );
-  temutil::nc( nc_put_vara_double(ncid, cv, start, count, &prvltrfcnA[0][0]) );
-
-  temutil::nc( nc_close(ncid) );
-
+  sink.put(fname, "prvltrfcnA", start, count, &prvltrfcnA[0][0]);
 }
 
 
@@ -101,6 +101,7 @@ void Richards::update(Layer *fstsoill, Layer* bdrainl,
   double dtdone = 0.0; //time completed
   bool continue_iterate = true;
   bool lapack_solver = true; //whether to use the newer LAPACK solver or the old Thomas algorithm
+  long n_trials = 0; //trial solutions for the day, accepted or not
 
   while(continue_iterate == true){
     n_substep += 1;
@@ -121,6 +122,7 @@ void Richards::update(Layer *fstsoill, Layer* bdrainl,
     max_tridiag_error = 0.0;
 
     while(try_dtsub){
+      n_trials += 1;
 
       computeLHS(fstsoill, topind, drainind); //compute left hand side of tridiagonal matrix equation
       computeRHS(fstsoill, topind, drainind); //compute right hand side of the tridiagonal matrix equation
@@ -162,8 +164,14 @@ void Richards::update(Layer *fstsoill, Layer* bdrainl,
       }
       if(max_tridiag_error > toler_upper && dtsub > dtmin){
         dtsub = fmax(dtsub/2, dtmin);//solution no good, halve timestep and start again
+        stats.rejections++;
+      }
+      else{
+        try_dtsub = false;
+        if(max_tridiag_error > toler_upper){
+          stats.min_steps++; //kept only because dtsub is already dtmin
+        }
       }
-      else{try_dtsub = false;}
     } //end of trial timestep
 
     //Modify layer liquid in each active layer by calculated
@@ -196,6 +204,12 @@ void Richards::update(Layer *fstsoill, Layer* bdrainl,
     dtsub = fmin(dtsub, delta_t - dtdone); //don't go over delta_t
   } //End of substep loop
   //End of iteration domain
+  stats.solves++;
+  stats.substeps += (long)n_substep;
+  stats.iterations += n_trials;
+  if(n_trials > stats.max_iterations){
+    stats.max_iterations = n_trials;
+  }
   //Check overall column liq results
   double final_liq = 0.0;
   currl = fstsoill;
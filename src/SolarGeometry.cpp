@@ -0,0 +1,131 @@
+/*  SolarGeometry.cpp
+ *
+ *  Per latitude day length and gross irradiance. See SolarGeometry.h
+ */
+
+#include <cmath>
+
+#include <boost/thread/lock_guard.hpp>
+
+#include "../include/SolarGeometry.h"
+#include "../include/TEMUtilityFunctions.h"
+#include "../include/TEMLogger.h"
+
+extern src::severity_logger< severity_level > glg;
+
+boost::mutex SolarGeometry::cache_mutex;
+std::map<float, boost::weak_ptr<const SolarGeometry> > SolarGeometry::cache;
+
+namespace {
+
+/** GIRR (W/m^2) as a function of latitude and month.
+*
+*  More information and formulas can be found here:
+*  http://www.fao.org/docrep/X0490E/x0490e07.htm
+*  (section "Extraterrestrial radiation for daily periods")
+* 
+*  And a table of expected values here:
+*  http://www.fao.org/docrep/X0490E/x0490e0j.htm#annex%202.%20meteorological%20tables
+* 
+*  NOTE: To convert from MJ/m^2/day to W/m^2:
+*        multiply by (1,000,000)/(60*60*24) or ~11.57
+*/
+float calculate_girr(const float lat, const int im) {
+  const float pi = 3.141592654;                // Greek "pi" TODO: fix this to use constant from math library?
+  const float sp = 1368.0 * 3600.0 / 41860.0;  // solar constant
+  float lambda;
+  float sumd;
+  float sig;
+  float eta;
+  float sinbeta;
+  float sb;
+  float sotd;
+  int hour;
+  lambda = lat * pi / 180.0;
+  float gross = 0.0;
+
+  for ( int day = 0; day < DINM[im]; ++day ) {
+
+    // find julian day
+    // http://www.fao.org/docrep/X0490E/x0490e0j.htm#annex%202.%20meteorological%20tables
+    float jd = 0.0;
+    jd = (275 * (im+1)/9) - 30 + (day+1);
+    if( (im+1) < 3 ) {
+      jd = jd + 2;
+    }
+    int julianday = int(jd);
+
+    sumd = 0;
+    sig = -23.4856*cos(2 * pi * (julianday + 10.0)/365.25);
+    sig *= pi / 180.0;
+
+    for ( hour = 0; hour < 24; hour++ ) {
+      eta = (float) ((hour+1) - 12) * pi / 12.0;
+      sinbeta = sin(lambda)*sin(sig) + cos(lambda)*cos(sig)*cos(eta);
+      sotd = 1 - (0.016729 * cos(0.9856 * (julianday - 4.0)
+                                 * pi / 180.0));
+      sb = sp * sinbeta / pow((double)sotd,2.0);
+
+      if (sb >= 0.0) {
+        sumd += sb;
+      }
+    }
+
+    gross += sumd;
+  }
+
+  gross /= (float)DINM[im];
+  gross *= 0.484; // convert from cal/cm2day to W/m^2
+  return gross;
+}
+
+} // end anonymous namespace
+
+
+SolarGeometry::SolarGeometry(float lat) : lat(lat) {
+
+  for (int doy = 0; doy < DINY; ++doy) {
+    daylength[doy] = temutil::length_of_day(lat, doy);
+  }
+
+  for (int im = 0; im < MINY; ++im) {
+    girr[im] = calculate_girr(lat, im);
+  }
+}
+
+/** Looks up the table for a latitude, computing it if no cell at that
+ *  latitude is currently holding one. Tables nobody holds any more are
+ *  dropped from the cache as new ones are added.
+ */
+boost::shared_ptr<const SolarGeometry> SolarGeometry::at_latitude(float lat) {
+
+  // NaN can not be a map key
+  if (std::isnan(lat)) {
+    return boost::shared_ptr<const SolarGeometry>(new SolarGeometry(lat));
+  }
+
+  boost::lock_guard<boost::mutex> lock(cache_mutex);
+
+  std::map<float, boost::weak_ptr<const SolarGeometry> >::iterator itr = cache.find(lat);
+  if (itr != cache.end()) {
+    boost::shared_ptr<const SolarGeometry> table = itr->second.lock();
+    if (table) {
+      return table;
+    }
+  }
+
+  for (itr = cache.begin(); itr != cache.end(); ) {
+    if (itr->second.expired()) {
+      cache.erase(itr++);
+    } else {
+      ++itr;
+    }
+  }
+
+  BOOST_LOG_SEV(glg, debug) << "Computing solar geometry for latitude " << lat;
+
+  boost::shared_ptr<const SolarGeometry> table(new SolarGeometry(lat));
+  cache[lat] = table;
+
+  return table;
+}
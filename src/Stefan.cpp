@@ -45,6 +45,9 @@ void Stefan::updateFronts(const double & tdrv, const double &timestep) {
     freezing1 =1;
   }
 
+  // conductivities of the whole column, ahead of the front search
+  ground->thermal.update(toplayer);
+
   // find the new front
   double newfntz1 = 0.;
   Layer * currl=NULL;
@@ -64,8 +67,9 @@ void Stefan::updateFronts(const double & tdrv, const double &timestep) {
       break; // for bedrock, break
     }
 
-    tkunf = currl->getUnfThermCond();
-    tkfrz = currl->getFrzThermCond();
+    const ThermalProperties::LayerValues& tp = ground->thermal.of(currl);
+    tkunf = tp.unf_tc;
+    tkfrz = tp.frz_tc;
 
     if(tdrv1<0.0) {
       tkres   = tkfrz;
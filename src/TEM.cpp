@@ -31,10 +31,13 @@
 #include <sstream>
 #include <ctime>
 #include <cstdlib>
+#include <cstring>
 #include <cstddef> // for offsetof()
 #include <exception>
+#include <stdexcept>
 #include <map>
 #include <set>
+#include <algorithm>
 
 #include <json/writer.h>
 #include <json/value.h>
@@ -73,13 +76,20 @@
 #include "../include/TEMUtilityFunctions.h"
 #include "../include/Runner.h"
 #include "../include/RestartData.h"
+#include "../include/OutputSink.h"
+#include "../include/OutputWriter.h"
+#include "../include/CellScheduler.h"
+#include "../include/ClimateTile.h"
+#include "../include/RestartCheckpoint.h"
+#include "../include/DailyDrivers.h"
+#include "../include/InputFiles.h"
 
 #include <netcdf.h>
 
 
 /** Write out a status code to a particular pixel in the run status file.
 */
-void write_status_info(const std::string fname, std::string varname, int row, int col, int statusCode);
+void write_status_info(OutputSink& sink, const std::string fname, std::string varname, int row, int col, int statusCode);
 
 
 /** Builds an empty netcdf file for recording the run status. 
@@ -91,6 +101,22 @@ void write_status_info(const std::string fname, std::string varname, int row, in
 void create_empty_run_status_file(const std::string& fname,
     const int ysize, const int xsize);
 
+/** Builds an empty netcdf file for the soil solvers' step counts, with
+ *  one value per calendar month for each cell. */
+void create_empty_solver_stats_file(const std::string& fname,
+    const int ysize, const int xsize);
+
+/** Writes a finished cell's soil solver step counts. */
+void write_solver_stats(const ModelData& md, const Runner& runner,
+                        const int rowidx, const int colidx);
+
+std::string solver_stats_fname(const ModelData& md);
+
+/** Builds the empty daily drivers files written with --write-daily-drivers,
+ *  for the stages to be run. Existing files are kept if 'keep_existing'. */
+void create_daily_drivers_files(const ModelData& md, const int ysize,
+                                const int xsize, const bool keep_existing);
+
 // The main driving function
 void advance_model(const int rowidx, const int colidx,
                    const ModelData&, const bool calmode,
@@ -100,6 +126,68 @@ void advance_model(const int rowidx, const int colidx,
                    const std::string& tr_restart_fname,
                    const std::string& sc_restart_fname);
 
+/** Runs a single cell and records how it went in the run status file. */
+void run_cell(const int rowidx, const int colidx, const bool mask_value,
+              const ModelData& md, const bool calmode,
+              const std::string& run_status_fname,
+              const std::string& pr_restart_fname,
+              const std::string& eq_restart_fname,
+              const std::string& sp_restart_fname,
+              const std::string& tr_restart_fname,
+              const std::string& sc_restart_fname);
+
+/** Records a cell that has stopped with an exception. */
+void record_cell_exception(const ModelData& md, const std::string& run_status_fname,
+                           const int rowidx, const int colidx, const std::exception& e);
+
+/** Closes this rank's independent handles on files ending with suffix. */
+void release_shared_files(const ModelData& md, const std::string& suffix);
+
+/** Drains the output writer and marks the cells it failed to write. */
+int finish_output_writer(const ModelData& md, const std::string& run_status_fname);
+
+/** Runs every active cell in a tile of rows one year at a time. */
+void run_tile_time_major(const int first_row, const int row_count,
+                         const std::vector< std::vector<int> >& run_mask,
+                         const ModelData& md, const bool calmode,
+                         const std::string& run_status_fname,
+                         const std::string& pr_restart_fname,
+                         const std::string& eq_restart_fname,
+                         const std::string& sp_restart_fname,
+                         const std::string& tr_restart_fname,
+                         const std::string& sc_restart_fname);
+
+// Stage helpers shared by advance_model(..) and the time-major loop
+void initialize_runner(Runner& runner);
+int setup_stage(Runner& runner, const ModelData& modeldata,
+                const std::string& stage, const int rowidx, const int colidx,
+                const std::string& prev_restart_fname);
+void finish_stage(Runner& runner, const ModelData& modeldata,
+                  const std::string& stage, const int rowidx, const int colidx,
+                  const std::string& restart_fname);
+void verify_restart_handoff(Runner& runner, const ModelData& modeldata,
+                            const std::string& restart_fname,
+                            const int rowidx, const int colidx);
+void load_restart(RestartData& restartdata, const ModelData& modeldata,
+                  const std::string& restart_fname,
+                  const int rowidx, const int colidx);
+void save_restart(RestartData& restartdata, const ModelData& modeldata,
+                  const std::string& restart_fname,
+                  const int rowidx, const int colidx);
+void create_restart_file(const ModelData& modeldata, const std::string& restart_fname,
+                         const int num_rows, const int num_cols, const int id);
+
+// Mid-stage checkpoints of a cell, for --resume
+std::string cell_checkpoint_fname(const ModelData& modeldata, const int rowidx, const int colidx);
+bool stage_done(const Runner& runner, const std::string& stage);
+void run_stage_years(Runner& runner, const ModelData& modeldata, const std::string& stage,
+                     const std::string& stage_run, const int stage_yrs);
+
+/** The output files, and the variables in each, whose writes are gathered
+ *  a block of rows at a time. */
+std::map<std::string, std::vector<std::string> > gathered_output_files(
+    const ModelData& md, const std::string& run_status_fname);
+
 
 // draft pretty-printers...
 void pp_2dvec(const std::vector<std::vector<int> > & vv);
@@ -170,6 +258,18 @@ int main(int argc, char* argv[]){
   BOOST_LOG_SEV(glg, info) << "Update model settings based on command line flags/options...";
   modeldata.update(args);
 
+  if (args->get_compile_params()) {
+    BOOST_LOG_SEV(glg, info) << "Compiling the parameters in " << modeldata.parameter_dir;
+    int problems = CohortLookup::compile_parameters(modeldata.parameter_dir);
+    if (problems > 0) {
+      std::cout << "Problems with the parameters in " << modeldata.parameter_dir
+                << "; no compiled file written. See the log.\n";
+      return 1;
+    }
+    std::cout << "Wrote " << modeldata.parameter_dir << CohortLookup::COMPILED_FILE << "\n";
+    return 0;
+  }
+
   // Further verification that the cmd line args and the config file don't have
   // conflicting settings
 
@@ -208,7 +308,7 @@ int main(int argc, char* argv[]){
   setvbuf(stdout, NULL, _IONBF, 0);
   setvbuf(stderr, NULL, _IONBF, 0);
   
-  time_t stime, etime, cell_stime, cell_etime;
+  time_t stime, etime;
   stime = time(0);
   modeldata.cell_stime = stime;
 
@@ -229,11 +329,66 @@ int main(int argc, char* argv[]){
 
   // Make some convenient handles for later...
   std::string run_status_fname = modeldata.output_dir + "run_status.nc";
-  std::string pr_restart_fname = modeldata.output_dir + "restart-pr.nc";
-  std::string eq_restart_fname = modeldata.output_dir + "restart-eq.nc";
-  std::string sp_restart_fname = modeldata.output_dir + "restart-sp.nc";
-  std::string tr_restart_fname = modeldata.output_dir + "restart-tr.nc";
-  std::string sc_restart_fname = modeldata.output_dir + "restart-sc.nc";
+
+  // A resumed run only runs the cells that the interrupted run didn't
+  // finish, so the finished ones are taken out of the run mask.
+  if (modeldata.resume) {
+    if (!boost::filesystem::exists(run_status_fname)) {
+      BOOST_LOG_SEV(glg, fatal) << "Can't resume: no " << run_status_fname;
+      std::cout << "Can't resume: no " << run_status_fname << "\n";
+      return 1;
+    }
+    std::vector< std::vector<int> > run_status = temutil::read_run_mask(run_status_fname, "run_status");
+    int finished = 0;
+    int remaining = 0;
+    for (int rowidx=0; rowidx<num_rows; rowidx++) {
+      for (int colidx=0; colidx<num_cols; colidx++) {
+        if (run_mask[rowidx][colidx] && run_status[rowidx][colidx] == STATUS_SUCCESS) {
+          run_mask[rowidx][colidx] = 0;
+          finished++;
+        } else if (run_mask[rowidx][colidx]) {
+          remaining++;
+        }
+      }
+    }
+    BOOST_LOG_SEV(glg, monitor) << "Resuming run: " << finished << " cells already finished, "
+                                << remaining << " to run.";
+  }
+
+  // Forcing read with --read-daily-drivers has to be there for every year
+  // that will be run
+  if (!modeldata.daily_drivers_dir.empty()) {
+    const char* stages[] = {"eq", "sp", "tr", "sc"};
+    try {
+      for (int is = 0; is < 4; is++) {
+        int nyears = DailyDrivers::file_years(modeldata, stages[is]);
+        if (nyears > 0) {
+          DailyDrivers::check_file(DailyDrivers::filename(modeldata.daily_drivers_dir, stages[is]), nyears);
+        }
+      }
+    } catch (const std::runtime_error& e) {
+      BOOST_LOG_SEV(glg, fatal) << "Can't read daily drivers: " << e.what();
+      std::cout << "Can't read daily drivers: " << e.what() << "\n";
+      return 1;
+    }
+  }
+
+  // A checkpoint holds the output a cell has not yet handed to the sink.
+  // When output is gathered in the sink a block of rows at a time, output
+  // from before the checkpoint may never have reached the files.
+  if (modeldata.checkpoint_interval > 0 &&
+      (modeldata.collective_output || args->get_loop_order() == "time-major")) {
+    BOOST_LOG_SEV(glg, warn) << "Checkpoints are only saved by the space-major loop "
+                             << "without collective output. Ignoring checkpoint_interval.";
+    modeldata.checkpoint_interval = 0;
+  }
+  std::string restart_ext = (modeldata.restart_format == "binary") ?
+                            RestartCheckpoint::EXTENSION : ".nc";
+  std::string pr_restart_fname = modeldata.output_dir + "restart-pr" + restart_ext;
+  std::string eq_restart_fname = modeldata.output_dir + "restart-eq" + restart_ext;
+  std::string sp_restart_fname = modeldata.output_dir + "restart-sp" + restart_ext;
+  std::string tr_restart_fname = modeldata.output_dir + "restart-tr" + restart_ext;
+  std::string sc_restart_fname = modeldata.output_dir + "restart-sc" + restart_ext;
 
 //Setting defaults which will be overwritten if MPI is used
 int id = 0;
@@ -243,13 +398,44 @@ int ntasks = 1;
   BOOST_LOG_SEV(glg, monitor) << "Built and running with MPI";
 
   // Intended for passing argc and argv, the arguments to MPI_Init
-  // are currently unnecessary.
-  MPI_Init(NULL, NULL);
+  // are currently unnecessary. The cell scheduler claims cells from any
+  // OpenMP thread, which needs MPI_THREAD_MULTIPLE.
+  int mpi_thread_support;
+  MPI_Init_thread(NULL, NULL, MPI_THREAD_MULTIPLE, &mpi_thread_support);
+  BOOST_LOG_SEV(glg, debug) << "MPI thread support level: " << mpi_thread_support;
 
   MPI_Comm_rank(MPI_COMM_WORLD, &id);
   MPI_Comm_size(MPI_COMM_WORLD, &ntasks);
 #endif
 
+  // Converting a restart file between formats is done on its own; the
+  // NetCDF side needs MPI to be set up when built with it.
+  if (!args->get_convert_restart().empty()) {
+    std::vector<std::string> files = args->get_convert_restart();
+    int status = 0;
+    if (files.size() != 2 || ntasks > 1) {
+      std::cout << "--convert-restart takes two files, IN and OUT, and is run "
+                << "as a single process.\n";
+      status = 1;
+    } else {
+      try {
+        if (RestartCheckpoint::is_checkpoint(files[0])) {
+          RestartCheckpoint::checkpoint_to_netcdf(files[0], files[1]);
+        } else {
+          RestartCheckpoint::netcdf_to_checkpoint(files[0], files[1]);
+        }
+        std::cout << "Wrote " << files[1] << "\n";
+      } catch (std::exception& e) {
+        BOOST_LOG_SEV(glg, fatal) << "Unable to convert " << files[0] << ": " << e.what();
+        status = 1;
+      }
+    }
+#ifdef WITHMPI
+    MPI_Finalize();
+#endif
+    return status;
+  }
+
   // Limit output directory and file setup to a single process.
   // variable 'id' is artificially set to 0 if not built with MPI.
   if(id==0){
@@ -258,7 +444,7 @@ int ntasks = 1;
     BOOST_LOG_SEV(glg, info) << "Checking for output directory: " << modeldata.output_dir;
     boost::filesystem::path out_dir_path(modeldata.output_dir);
     if( boost::filesystem::exists(out_dir_path) ){
-      if (args->get_no_output_cleanup() || (modeldata.restart_from.length() > 0)) {
+      if (args->get_no_output_cleanup() || (modeldata.restart_from.length() > 0) || modeldata.resume) {
         BOOST_LOG_SEV(glg, warn) << "WARNING!! Not cleaning up output directory! "
                                  << "Old and potentially confusing files may be "
                                  << "present from previous runs!!";
@@ -269,6 +455,9 @@ int ntasks = 1;
     }
     BOOST_LOG_SEV(glg, info) << "Creating output directory: "<<modeldata.output_dir;
     boost::filesystem::create_directories(out_dir_path);
+    if (modeldata.checkpoint_interval > 0) {
+      boost::filesystem::create_directories(modeldata.output_dir + "checkpoints/");
+    }
 
 
     // Creating file to store configuration information to be packaged
@@ -316,52 +505,87 @@ int ntasks = 1;
   // Attempting to restrict file creation to one process (in the conditional
   // statements above) causes a silent hang in nc_create_par(...)
 
-  // Creating empty restart files for stages that will be run.
-  //  This avoids overwriting any restart files that might be in use.
-  BOOST_LOG_SEV(glg, info) << "Creating restart files for stages to be run";
-  if(args->get_pr_yrs() > 0){
-    BOOST_LOG_SEV(glg, info) << "Creating empty PR restart file";
-    RestartData::create_empty_file(pr_restart_fname, num_rows, num_cols);
-  }
-  if(args->get_eq_yrs() > 0){
-    BOOST_LOG_SEV(glg, info) << "Creating empty EQ restart file";
-    RestartData::create_empty_file(eq_restart_fname, num_rows, num_cols);
-  }
-  if(args->get_sp_yrs() > 0){
-    BOOST_LOG_SEV(glg, info) << "Creating empty SP restart file";
-    RestartData::create_empty_file(sp_restart_fname, num_rows, num_cols);
-  }
-  if(args->get_tr_yrs() > 0){
-    BOOST_LOG_SEV(glg, info) << "Creating empty TR restart file";
-    RestartData::create_empty_file(tr_restart_fname, num_rows, num_cols);
-  }
-  if(args->get_sc_yrs() > 0){
-    BOOST_LOG_SEV(glg, info) << "Creating empty SC restart file";
-    RestartData::create_empty_file(sc_restart_fname, num_rows, num_cols);
-  }
-
-  // Create empty run status file
-  BOOST_LOG_SEV(glg, info) << "Creating empty run status file.";
-  create_empty_run_status_file(run_status_fname, num_rows, num_cols);
-
-  // Create empty output files now so that later, as the program
-  // proceeds, there is somewhere to append output data...
-  BOOST_LOG_SEV(glg, info) << "Creating a set of empty NetCDF output files";
-  bool copy_gm = true;
-  if(modeldata.eq_yrs > 0 && modeldata.nc_eq){
-    modeldata.create_netCDF_output_files(num_rows, num_cols, "eq", modeldata.eq_yrs, copy_gm);
-    if(modeldata.eq_yrs > 100 && modeldata.daily_netcdf_outputs.size() > 0){
-      BOOST_LOG_SEV(glg, fatal) << "Daily outputs specified with EQ run greater than 100 years! Reconsider...";
+  // A resumed run carries on writing to the files the interrupted run
+  // created, so none of them are created again.
+  if (modeldata.resume) {
+    BOOST_LOG_SEV(glg, info) << "Resuming: using the existing restart, run status and output files";
+    // The Runners still need the output specs to know what output to hold
+    if ((modeldata.eq_yrs > 0 && modeldata.nc_eq) || (modeldata.sp_yrs > 0 && modeldata.nc_sp)
+        || (modeldata.tr_yrs > 0 && modeldata.nc_tr) || (modeldata.sc_yrs > 0 && modeldata.nc_sc)) {
+      modeldata.read_output_spec();
+    }
+    // Unless the interrupted run was not keeping solver stats
+    if (modeldata.solver_stats && !boost::filesystem::exists(solver_stats_fname(modeldata))) {
+      create_empty_solver_stats_file(solver_stats_fname(modeldata), num_rows, num_cols);
+    }
+    if (modeldata.write_daily_drivers) {
+      create_daily_drivers_files(modeldata, num_rows, num_cols, true);
+    }
+  } else {
+    // Creating empty restart files for stages that will be run.
+    //  This avoids overwriting any restart files that might be in use.
+    BOOST_LOG_SEV(glg, info) << "Creating restart files for stages to be run";
+    if(args->get_pr_yrs() > 0 && modeldata.persist_restart("pr")){
+      BOOST_LOG_SEV(glg, info) << "Creating empty PR restart file";
+      create_restart_file(modeldata, pr_restart_fname, num_rows, num_cols, id);
+    }
+    if(args->get_eq_yrs() > 0 && modeldata.persist_restart("eq")){
+      BOOST_LOG_SEV(glg, info) << "Creating empty EQ restart file";
+      create_restart_file(modeldata, eq_restart_fname, num_rows, num_cols, id);
+    }
+    if(args->get_sp_yrs() > 0 && modeldata.persist_restart("sp")){
+      BOOST_LOG_SEV(glg, info) << "Creating empty SP restart file";
+      create_restart_file(modeldata, sp_restart_fname, num_rows, num_cols, id);
+    }
+    if(args->get_tr_yrs() > 0 && modeldata.persist_restart("tr")){
+      BOOST_LOG_SEV(glg, info) << "Creating empty TR restart file";
+      create_restart_file(modeldata, tr_restart_fname, num_rows, num_cols, id);
+    }
+    if(args->get_sc_yrs() > 0 && modeldata.persist_restart("sc")){
+      BOOST_LOG_SEV(glg, info) << "Creating empty SC restart file";
+      create_restart_file(modeldata, sc_restart_fname, num_rows, num_cols, id);
+    }
+
+#ifdef WITHMPI
+    // Binary checkpoints are created by the first process alone
+    if (modeldata.restart_format == "binary") {
+      MPI_Barrier(MPI_COMM_WORLD);
+    }
+#endif
+
+    // Create empty run status file
+    BOOST_LOG_SEV(glg, info) << "Creating empty run status file.";
+    create_empty_run_status_file(run_status_fname, num_rows, num_cols);
+
+    if (modeldata.solver_stats) {
+      BOOST_LOG_SEV(glg, info) << "Creating empty solver stats file.";
+      create_empty_solver_stats_file(solver_stats_fname(modeldata), num_rows, num_cols);
+    }
+
+    if (modeldata.write_daily_drivers) {
+      BOOST_LOG_SEV(glg, info) << "Creating empty daily drivers files.";
+      create_daily_drivers_files(modeldata, num_rows, num_cols, false);
+    }
+
+    // Create empty output files now so that later, as the program
+    // proceeds, there is somewhere to append output data...
+    BOOST_LOG_SEV(glg, info) << "Creating a set of empty NetCDF output files";
+    bool copy_gm = true;
+    if(modeldata.eq_yrs > 0 && modeldata.nc_eq){
+      modeldata.create_netCDF_output_files(num_rows, num_cols, "eq", modeldata.eq_yrs, copy_gm);
+      if(modeldata.eq_yrs > 100 && modeldata.daily_netcdf_outputs.size() > 0){
+        BOOST_LOG_SEV(glg, fatal) << "Daily outputs specified with EQ run greater than 100 years! Reconsider...";
+      }
+    }
+    if(modeldata.sp_yrs > 0 && modeldata.nc_sp){
+      modeldata.create_netCDF_output_files(num_rows, num_cols, "sp", modeldata.sp_yrs, copy_gm);
+    }
+    if(modeldata.tr_yrs > 0 && modeldata.nc_tr){
+      modeldata.create_netCDF_output_files(num_rows, num_cols, "tr", modeldata.tr_yrs, copy_gm);
+    }
+    if(modeldata.sc_yrs > 0 && modeldata.nc_sc){
+      modeldata.create_netCDF_output_files(num_rows, num_cols, "sc", modeldata.sc_yrs, copy_gm);
     }
-  }
-  if(modeldata.sp_yrs > 0 && modeldata.nc_sp){
-    modeldata.create_netCDF_output_files(num_rows, num_cols, "sp", modeldata.sp_yrs, copy_gm);
-  }
-  if(modeldata.tr_yrs > 0 && modeldata.nc_tr){
-    modeldata.create_netCDF_output_files(num_rows, num_cols, "tr", modeldata.tr_yrs, copy_gm);
-  }
-  if(modeldata.sc_yrs > 0 && modeldata.nc_sc){
-    modeldata.create_netCDF_output_files(num_rows, num_cols, "sc", modeldata.sc_yrs, copy_gm);
   }
 
   // Warn if CMTNUM output is not enabled.
@@ -406,6 +630,45 @@ int ntasks = 1;
     }
   }
 
+  // Output files are opened once and kept open in the sink. Every Runner
+  // gets a copy of modeldata, and with it the pointers to the sink and the
+  // (optional) dedicated NetCDF writer stage.
+  modeldata.output_sink = new OutputSink();
+  int output_failures = 0; // Cells the asynchronous writer failed to write
+  bool gathered_output = modeldata.collective_output
+                         || args->get_loop_order() == "time-major";
+  if (modeldata.async_output && gathered_output) {
+    BOOST_LOG_SEV(glg, warn) << "The asynchronous writer is not used with "
+                             << "collective output or the time-major loop. "
+                             << "Ignoring async_output.";
+  }
+  else if (modeldata.async_output && modeldata.checkpoint_interval > 0) {
+    BOOST_LOG_SEV(glg, warn) << "The asynchronous writer is not used with checkpoints, "
+                             << "which need the output before them to be in the files. "
+                             << "Ignoring async_output.";
+  }
+  else if (modeldata.async_output) {
+    BOOST_LOG_SEV(glg, info) << "Using asynchronous NetCDF output writer.";
+    modeldata.output_writer = new OutputWriter(modeldata.output_sink,
+                                               modeldata.output_queue_size,
+                                               modeldata.output_io_threads);
+  }
+
+  // Climate can be read a tile of rows at a time and shared by the cells
+  // in the tile, instead of a column at a time for each cell.
+  if (modeldata.climate_tile_rows > 0) {
+    int chunk = ClimateTile::chunk_rows(modeldata.hist_climate_file, "tair");
+    int tile_rows = ((modeldata.climate_tile_rows + chunk - 1) / chunk) * chunk;
+    BOOST_LOG_SEV(glg, info) << "Reading climate in tiles of " << tile_rows << " rows.";
+    modeldata.climate_tiles = new ClimateTileCache(tile_rows, modeldata.climate_tile_cache);
+  }
+
+  // Binary restart checkpoints are mapped as they are first used. A
+  // binary restart_from file is read through them whatever the format.
+  if (modeldata.restart_format == "binary" || RestartCheckpoint::is_checkpoint(modeldata.restart_from)) {
+    modeldata.restart_checkpoints = new RestartCheckpointCache();
+  }
+
   if (args->get_loop_order() == "space-major") {
 
     // y <==> row <==> lat
@@ -446,115 +709,526 @@ int ntasks = 1;
     MPI_Comm_rank(MPI_COMM_WORLD, &id);
     MPI_Comm_size(MPI_COMM_WORLD, &ntasks);
 
-    int total_cells = num_rows*num_cols;
-
     BOOST_LOG_SEV(glg, debug) << "id: "<<id<<" of ntasks: "<<ntasks;
 
-    #pragma omp parallel for schedule(dynamic)
-    for(int curr_cell=id; curr_cell<total_cells; curr_cell+=ntasks){
+    if (modeldata.collective_output) {
 
-      int rowidx = curr_cell / num_cols;
-      int colidx = curr_cell % num_cols;
+      // Each rank takes a block of whole rows at a time, so that a block
+      // is a single hyperslab in every output file. The blocks are dealt
+      // out round robin and every rank goes through the same number of
+      // rounds, with an empty block if it has run out, because the writes
+      // at the end of each round are collective.
+      int block_rows = modeldata.collective_block_rows;
+      int block_count = (num_rows + block_rows - 1) / block_rows;
+      int rounds = (block_count + ntasks - 1) / ntasks;
 
-      bool mask_value = run_mask[rowidx][colidx];
-      BOOST_LOG_SEV(glg, monitor) << "MPI rank: "<<id<<", cell: "<<rowidx\
-                                  << ", "<<colidx<<" run: "<<mask_value;
+      BOOST_LOG_SEV(glg, info) << "Using collective output: " << block_count
+                               << " blocks of " << block_rows << " rows in "
+                               << rounds << " rounds.";
 
-#else
-    BOOST_LOG_SEV(glg, debug) << "Not built with MPI";
+      modeldata.output_sink->open_collective(gathered_output_files(modeldata, run_status_fname));
 
-   #pragma omp parallel for collapse(2) schedule(dynamic)
-    for(int rowidx=0; rowidx<num_rows; rowidx++){
-      for(int colidx=0; colidx<num_cols; colidx++){
+      for(int round=0; round<rounds; round++){
 
-        bool mask_value = run_mask[rowidx].at(colidx);
+        int block = round*ntasks + id;
+        int first_row = 0;
+        int row_count = 0;
+        if(block < block_count){
+          first_row = block*block_rows;
+          row_count = std::min(block_rows, num_rows - first_row);
+        }
 
-#endif
+        modeldata.output_sink->begin_block(first_row, row_count);
 
-        if (true == mask_value) {
+        int block_cells = row_count*num_cols;
 
-          // I think this is safe w/in our OpenMP block because I am
-          // handling the exception here...
-          // Not sure about other OpenMP pragama blocks w/in this one? Any
-          // Exceptions would leak out of the inner pragma and be handled
-          // by this try/catch??
-          try {
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic)
+#endif
+        for(int curr_cell=0; curr_cell<block_cells; curr_cell++){
 
-            cell_stime = time(0);
+          int rowidx = first_row + curr_cell / num_cols;
+          int colidx = curr_cell % num_cols;
 
-            advance_model(rowidx, colidx, modeldata, args->get_cal_mode(), pr_restart_fname, eq_restart_fname, sp_restart_fname, tr_restart_fname, sc_restart_fname);
+          bool mask_value = run_mask[rowidx][colidx];
+          BOOST_LOG_SEV(glg, monitor) << "MPI rank: "<<id<<", cell: "<<rowidx\
+                                      << ", "<<colidx<<" run: "<<mask_value;
 
-            cell_etime = time(0);
+          run_cell(rowidx, colidx, mask_value, modeldata, args->get_cal_mode(), run_status_fname, pr_restart_fname, eq_restart_fname, sp_restart_fname, tr_restart_fname, sc_restart_fname);
+        }
 
-            BOOST_LOG_SEV(glg, info) << "Finished cell " << rowidx << ", " << colidx << ". Writing status file...";
-            std::cout << "cell " << rowidx << ", " << colidx << " complete." << std::endl;
-            write_status_info(run_status_fname, "run_status", rowidx, colidx, STATUS_SUCCESS);
-            write_status_info(run_status_fname, "total_runtime", rowidx, colidx, difftime(cell_etime, cell_stime));
- 
-          }
-          catch (const temutil::CellTimeExceeded& e) {
-            BOOST_LOG_SEV(glg, warn) << "Time Exception (row, col): (" << rowidx << ", " << colidx << "): " << e.what();
+        modeldata.output_sink->write_block();
+      }
+    }
+    else {
+#else
+    BOOST_LOG_SEV(glg, debug) << "Not built with MPI";
+    {
+#endif
 
-            write_status_info(run_status_fname, "run_status", rowidx, colidx, STATUS_TIMEOUT); // <- what if this throws??
-            BOOST_LOG_SEV(glg, warn) << "End of Time Exception handler";
+      // Cells are handed out most expensive first, to whichever thread
+      // (or rank) is free next. See CellScheduler.h
+      CellScheduler scheduler(run_mask, modeldata);
 
-          }
-          catch (std::exception& e) {
+#ifdef _OPENMP
+      #pragma omp parallel
+#endif
+      {
+        int rowidx, colidx;
+        while (scheduler.next_cell(rowidx, colidx)) {
 
-            BOOST_LOG_SEV(glg, warn) << "EXCEPTION!! (row, col): (" << rowidx << ", " << colidx << "): " << e.what();
+          bool mask_value = run_mask[rowidx][colidx];
+          BOOST_LOG_SEV(glg, monitor) << "Rank: "<<id<<", cell: "<<rowidx\
+                                      << ", "<<colidx<<" run: "<<mask_value;
 
-            // IS THIS THREAD SAFE??
-            // IS IT SAFE WITH MPI??
-            std::ofstream outfile;
-            outfile.open((modeldata.output_dir + "fail_log.txt").c_str(), std::ios_base::app); // Append mode
-            outfile << "EXCEPTION!! At pixel at (row, col): ("<<rowidx <<", "<<colidx<<") "<< e.what() <<"\n";
-            outfile.close();
+          double cell_stime = temutil::wall_seconds();
 
-            // Write to fail_mask.nc file?? or json? might be good for visualization
-            write_status_info(run_status_fname, "run_status", rowidx, colidx, STATUS_FAIL); // <- what if this throws??
-            BOOST_LOG_SEV(glg, warn) << "End of exception handler.";
+          run_cell(rowidx, colidx, mask_value, modeldata, args->get_cal_mode(), run_status_fname, pr_restart_fname, eq_restart_fname, sp_restart_fname, tr_restart_fname, sc_restart_fname);
 
+          if (mask_value) {
+            scheduler.cell_done(temutil::wall_seconds() - cell_stime);
           }
-        }//End of active cell
-        else {
-          BOOST_LOG_SEV(glg, monitor) << "Skipping cell (" << rowidx << ", " << colidx << ")";
-          write_status_info(run_status_fname, "run_status", rowidx, colidx, STATUS_MASKED);
         }
- 
-#ifdef WITHMPI
+      }
+
+      std::string report = scheduler.utilization_report();
+      if (!report.empty()) {
+        BOOST_LOG_SEV(glg, info) << report;
+        std::cout << report;
+      }
     }
+
+#ifdef WITHMPI
+    // The writer has to be drained and the files closed before MPI goes away.
+    output_failures += finish_output_writer(modeldata, run_status_fname);
+    modeldata.output_sink->close_all();
     MPI_Finalize();
+#endif
+
+  } else if (args->get_loop_order() == "time-major") {
+
+    // Cells are run a tile of whole rows at a time. Every active cell in
+    // the tile is held in memory and the tile is stepped through the run
+    // one year at a time. Output for the tile is gathered in the sink and
+    // written with one call per variable once the tile is done. Under MPI
+    // the tiles are dealt out to the ranks round robin.
+    int tile_rows = modeldata.time_major_tile_rows;
+    int tile_count = (num_rows + tile_rows - 1) / tile_rows;
+    int rounds = (tile_count + ntasks - 1) / ntasks;
+
+    BOOST_LOG_SEV(glg, info) << "Time-major loop: " << tile_count << " tiles of "
+                             << tile_rows << " rows.";
 
+#ifdef WITHMPI
+    // Every rank steps through the same number of rounds, so the blocks
+    // are always written collectively rather than each rank holding its
+    // own handle on the shared files for the whole run.
+    if (!modeldata.collective_output) {
+      BOOST_LOG_SEV(glg, info) << "Time-major loop under MPI: writing output collectively.";
+    }
+    modeldata.output_sink->open_collective(gathered_output_files(modeldata, run_status_fname));
 #else
-      }//end col loop
-    }//end row loop
+    modeldata.output_sink->open_gathered(gathered_output_files(modeldata, run_status_fname));
+#endif
+
+    for(int round=0; round<rounds; round++){
+
+      int tile = round*ntasks + id;
+      int first_row = 0;
+      int row_count = 0;
+      if(tile < tile_count){
+        first_row = tile*tile_rows;
+        row_count = std::min(tile_rows, num_rows - first_row);
+      }
 
+      modeldata.output_sink->begin_block(first_row, row_count);
+
+      run_tile_time_major(first_row, row_count, run_mask, modeldata, args->get_cal_mode(), run_status_fname, pr_restart_fname, eq_restart_fname, sp_restart_fname, tr_restart_fname, sc_restart_fname);
+
+      modeldata.output_sink->write_block();
+    }
+
+#ifdef WITHMPI
+    modeldata.output_sink->close_all();
+    MPI_Finalize();
 #endif
- 
-  } else if (args->get_loop_order() == "time-major") {
-    BOOST_LOG_SEV(glg, warn) << "DO NOTHING. NOT IMPLEMENTED YET.";
-    // for each year
 
-      // Read in Climate - all locations, one year/timestep
+  }
 
-      // Read in Vegetation - all locations
-      // Read in Drainage - all locations
-      // Read in Fire - all locations
-    
-      // for each cohort
-        // updateMonthly(...)
+  if (modeldata.output_writer) {
+    output_failures += finish_output_writer(modeldata, run_status_fname);
+    std::cout << modeldata.output_writer->stats_report() << std::endl;
+    delete modeldata.output_writer;
+    modeldata.output_writer = NULL;
+  }
+  modeldata.output_sink->close_all();
+  delete modeldata.output_sink;
+  modeldata.output_sink = NULL;
+
+  if (modeldata.climate_tiles) {
+    BOOST_LOG_SEV(glg, info) << modeldata.climate_tiles->stats_report();
+    delete modeldata.climate_tiles;
+    modeldata.climate_tiles = NULL;
+  }
 
+  if (modeldata.restart_checkpoints) {
+    modeldata.restart_checkpoints->flush_all();
+    delete modeldata.restart_checkpoints;
+    modeldata.restart_checkpoints = NULL;
   }
 
+  InputFiles::close_all();
+
   BOOST_LOG_SEV(glg, info) << "Done with run (loop order: " << args->get_loop_order() << ")";
 
   etime = time(0);
   BOOST_LOG_SEV(glg, info) << "Total Seconds: " << difftime(etime, stime);
   //cout as well as log, since Atlas runs have logging disabled.
   std::cout << "Total Seconds: " << difftime(etime, stime) << std::endl;
+
+  if (output_failures > 0) {
+    std::cout << "Output could not be written for " << output_failures
+              << " cell(s); see run_status.nc and fail_log.txt" << std::endl;
+    return 1;
+  }
   return 0;
 } /* End main() */
 
+/** Runs a single cell and records how it went in the run status file.
+ *  Exceptions from the cell are handled here, so this is safe to call from
+ *  within an OpenMP loop.
+ */
+void run_cell(const int rowidx, const int colidx, const bool mask_value,
+              const ModelData& md, const bool calmode,
+              const std::string& run_status_fname,
+              const std::string& pr_restart_fname,
+              const std::string& eq_restart_fname,
+              const std::string& sp_restart_fname,
+              const std::string& tr_restart_fname,
+              const std::string& sc_restart_fname) {
+
+  if (true == mask_value) {
+
+    try {
+
+      time_t cell_stime = time(0);
+
+      advance_model(rowidx, colidx, md, calmode, pr_restart_fname, eq_restart_fname, sp_restart_fname, tr_restart_fname, sc_restart_fname);
+
+      time_t cell_etime = time(0);
+
+      BOOST_LOG_SEV(glg, info) << "Finished cell " << rowidx << ", " << colidx << ". Writing status file...";
+      std::cout << "cell " << rowidx << ", " << colidx << " complete." << std::endl;
+      write_status_info(*md.output_sink, run_status_fname, "run_status", rowidx, colidx, STATUS_SUCCESS);
+      write_status_info(*md.output_sink, run_status_fname, "total_runtime", rowidx, colidx, difftime(cell_etime, cell_stime));
+
+      // The cell is finished, so its checkpoint is no longer needed
+      boost::system::error_code ec;
+      boost::filesystem::remove(cell_checkpoint_fname(md, rowidx, colidx), ec);
+
+    }
+    catch (std::exception& e) {
+      record_cell_exception(md, run_status_fname, rowidx, colidx, e);
+    }
+  }//End of active cell
+  else {
+    BOOST_LOG_SEV(glg, monitor) << "Skipping cell (" << rowidx << ", " << colidx << ")";
+    // On a resumed run this is a cell that is masked or already finished,
+    // and its status is already in the file
+    if (!md.resume) {
+      write_status_info(*md.output_sink, run_status_fname, "run_status", rowidx, colidx, STATUS_MASKED);
+    }
+  }
+
+  release_shared_files(md, run_status_fname);
+  release_shared_files(md, solver_stats_fname(md));
+}
+
+/** Under MPI each rank writes to the shared output, restart and status
+ *  files through its own independent handle, and each handle caches the
+ *  file's metadata. Closing the handles as soon as a cell is done with a
+ *  stage's files flushes that metadata before another rank extends the
+ *  file, instead of every rank holding a stale copy for the whole run.
+ *  The sink reopens a file if it is written to again. Files written
+ *  collectively are left open.
+ */
+void release_shared_files(const ModelData& md, const std::string& suffix) {
+#ifdef WITHMPI
+  md.output_sink->close_stage(suffix);
+#endif
+}
+
+/** Records a cell that has stopped with an exception: a cell that ran out
+ *  of time is marked as timed out, anything else is logged to the fail log
+ *  and marked as failed.
+ */
+void record_cell_exception(const ModelData& md, const std::string& run_status_fname,
+                           const int rowidx, const int colidx, const std::exception& e) {
+
+  if (dynamic_cast<const temutil::CellTimeExceeded*>(&e)) {
+    BOOST_LOG_SEV(glg, warn) << "Time Exception (row, col): (" << rowidx << ", " << colidx << "): " << e.what();
+
+    write_status_info(*md.output_sink, run_status_fname, "run_status", rowidx, colidx, STATUS_TIMEOUT); // <- what if this throws??
+    BOOST_LOG_SEV(glg, warn) << "End of Time Exception handler";
+    return;
+  }
+
+  BOOST_LOG_SEV(glg, warn) << "EXCEPTION!! (row, col): (" << rowidx << ", " << colidx << "): " << e.what();
+
+  // IS THIS THREAD SAFE??
+  // IS IT SAFE WITH MPI??
+  std::ofstream outfile;
+  outfile.open((md.output_dir + "fail_log.txt").c_str(), std::ios_base::app); // Append mode
+  outfile << "EXCEPTION!! At pixel at (row, col): ("<<rowidx <<", "<<colidx<<") "<< e.what() <<"\n";
+  outfile.close();
+
+  // Write to fail_mask.nc file?? or json? might be good for visualization
+  write_status_info(*md.output_sink, run_status_fname, "run_status", rowidx, colidx, STATUS_FAIL); // <- what if this throws??
+  BOOST_LOG_SEV(glg, warn) << "End of exception handler.";
+}
+
+/** Waits for the asynchronous writer to empty its queue, then marks every
+ *  cell with output it could not write as failed, as if the cell itself
+ *  had thrown. Returns the number of such cells.
+ */
+int finish_output_writer(const ModelData& md, const std::string& run_status_fname) {
+  if (!md.output_writer) {
+    return 0;
+  }
+
+  md.output_writer->finish();
+
+  std::vector<std::pair<int, int> > failed = md.output_writer->take_failed_cells();
+  for (unsigned int i = 0; i < failed.size(); i++) {
+    std::runtime_error e("Writer failed to write output for this cell");
+    record_cell_exception(md, run_status_fname, failed[i].first, failed[i].second, e);
+  }
+
+  if (!failed.empty()) {
+    BOOST_LOG_SEV(glg, fatal) << "Output is incomplete for " << failed.size() << " cell(s).";
+  }
+  return failed.size();
+}
+
+/** A cell held in memory by the time-major loop. The runner is deleted,
+ *  and left null, as soon as the cell fails.
+ */
+struct TileCell {
+  int row;
+  int col;
+  Runner* runner;
+  int stage_yrs;  // Years in the current stage, which can vary for EQ
+  double seconds; // Time spent running this cell
+};
+
+/** Stops a cell of a time-major tile after an exception. */
+void stop_tile_cell(TileCell& cell, const ModelData& md,
+                    const std::string& run_status_fname, const std::exception& e) {
+  record_cell_exception(md, run_status_fname, cell.row, cell.col, e);
+  delete cell.runner;
+  cell.runner = NULL;
+}
+
+/** Runs every active cell in a tile of rows one year at a time: each
+ *  stage is set up for all the cells, then all the cells are run through
+ *  year 0, then year 1, and so on. Each step is spread over the OpenMP
+ *  threads. A cell that fails drops out of the tile; the rest carry on.
+ */
+void run_tile_time_major(const int first_row, const int row_count,
+                         const std::vector< std::vector<int> >& run_mask,
+                         const ModelData& md, const bool calmode,
+                         const std::string& run_status_fname,
+                         const std::string& pr_restart_fname,
+                         const std::string& eq_restart_fname,
+                         const std::string& sp_restart_fname,
+                         const std::string& tr_restart_fname,
+                         const std::string& sc_restart_fname) {
+
+  std::vector<TileCell> cells;
+  for (int rowidx=first_row; rowidx<first_row+row_count; rowidx++) {
+    for (int colidx=0; colidx<(int)run_mask[rowidx].size(); colidx++) {
+      if (run_mask[rowidx][colidx]) {
+        TileCell cell = {rowidx, colidx, NULL, 0, 0.0};
+        cells.push_back(cell);
+      } else {
+        BOOST_LOG_SEV(glg, monitor) << "Skipping cell (" << rowidx << ", " << colidx << ")";
+        if (!md.resume) {
+          write_status_info(*md.output_sink, run_status_fname, "run_status", rowidx, colidx, STATUS_MASKED);
+        }
+      }
+    }
+  }
+  int cell_count = cells.size();
+
+  BOOST_LOG_SEV(glg, info) << "Time-major tile, rows " << first_row << " to "
+                           << first_row + row_count - 1 << ": " << cell_count
+                           << " active cells.";
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic)
+#endif
+  for (int ic=0; ic<cell_count; ic++) {
+    TileCell& cell = cells[ic];
+    double stime = temutil::wall_seconds();
+    try {
+      cell.runner = new Runner(md, calmode, cell.row, cell.col);
+      initialize_runner(*cell.runner);
+    } catch (std::exception& e) {
+      stop_tile_cell(cell, md, run_status_fname, e);
+    }
+    cell.seconds += temutil::wall_seconds() - stime;
+  }
+
+  const char* stages[] = { "pr", "eq", "sp", "tr", "sc" };
+  const char* stage_runs[] = { "pre-run", "eq-run", "sp-run", "tr-run", "sc-run" };
+  const int stage_yrs[] = { md.pr_yrs, md.eq_yrs, md.sp_yrs, md.tr_yrs, md.sc_yrs };
+  const std::string* restart_fnames[] = { &pr_restart_fname, &eq_restart_fname,
+      &sp_restart_fname, &tr_restart_fname, &sc_restart_fname };
+
+  for (int is=0; is<5; is++) {
+    if (stage_yrs[is] <= 0) {
+      continue;
+    }
+    const std::string stage = stages[is];
+    const std::string stage_run = stage_runs[is];
+    const std::string& prev_restart_fname = (is > 0) ? *restart_fnames[is-1] : "";
+
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for (int ic=0; ic<cell_count; ic++) {
+      TileCell& cell = cells[ic];
+      if (!cell.runner) {
+        continue;
+      }
+      double stime = temutil::wall_seconds();
+      try {
+        cell.stage_yrs = setup_stage(*cell.runner, md, stage, cell.row, cell.col, prev_restart_fname);
+      } catch (std::exception& e) {
+        stop_tile_cell(cell, md, run_status_fname, e);
+      }
+      cell.seconds += temutil::wall_seconds() - stime;
+    }
+
+    int max_yrs = 0;
+    for (int ic=0; ic<cell_count; ic++) {
+      if (cells[ic].runner) {
+        max_yrs = std::max(max_yrs, cells[ic].stage_yrs);
+      }
+    }
+
+    BOOST_LOG_SEV(glg, monitor) << "Time-major tile, running " << stage << " stage, "
+                                << max_yrs << " years.";
+
+    for (int iy=0; iy<max_yrs; iy++) {
+#ifdef _OPENMP
+      #pragma omp parallel for schedule(dynamic)
+#endif
+      for (int ic=0; ic<cell_count; ic++) {
+        TileCell& cell = cells[ic];
+        if (!cell.runner || iy >= cell.stage_yrs) {
+          continue;
+        }
+        double stime = temutil::wall_seconds();
+        try {
+          cell.runner->run_year(iy, 0, cell.stage_yrs, stage_run);
+        } catch (std::exception& e) {
+          stop_tile_cell(cell, md, run_status_fname, e);
+        }
+        cell.seconds += temutil::wall_seconds() - stime;
+      }
+    }
+
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for (int ic=0; ic<cell_count; ic++) {
+      TileCell& cell = cells[ic];
+      if (!cell.runner) {
+        continue;
+      }
+      double stime = temutil::wall_seconds();
+      try {
+        finish_stage(*cell.runner, md, stage, cell.row, cell.col, *restart_fnames[is]);
+      } catch (std::exception& e) {
+        stop_tile_cell(cell, md, run_status_fname, e);
+      }
+      cell.seconds += temutil::wall_seconds() - stime;
+    }
+  }
+
+  for (int ic=0; ic<cell_count; ic++) {
+    TileCell& cell = cells[ic];
+    if (!cell.runner) {
+      continue;
+    }
+    BOOST_LOG_SEV(glg, info) << "Finished cell " << cell.row << ", " << cell.col << ". Writing status file...";
+    std::cout << "cell " << cell.row << ", " << cell.col << " complete." << std::endl;
+    write_status_info(*md.output_sink, run_status_fname, "run_status", cell.row, cell.col, STATUS_SUCCESS);
+    write_status_info(*md.output_sink, run_status_fname, "total_runtime", cell.row, cell.col, cell.seconds);
+    write_solver_stats(md, *cell.runner, cell.row, cell.col);
+    delete cell.runner;
+    cell.runner = NULL;
+  }
+}
+
+/** Every output file that will be written in this run, with the variables
+ *  in it, plus the run status file. Must come out the same on every rank.
+ */
+std::map<std::string, std::vector<std::string> > gathered_output_files(
+    const ModelData& md, const std::string& run_status_fname) {
+
+  std::vector<std::string> stage_suffixes;
+  if(md.eq_yrs > 0 && md.nc_eq){ stage_suffixes.push_back("_eq.nc"); }
+  if(md.sp_yrs > 0 && md.nc_sp){ stage_suffixes.push_back("_sp.nc"); }
+  if(md.tr_yrs > 0 && md.nc_tr){ stage_suffixes.push_back("_tr.nc"); }
+  if(md.sc_yrs > 0 && md.nc_sc){ stage_suffixes.push_back("_sc.nc"); }
+
+  std::map<std::string, std::vector<std::string> > file_vars;
+
+  const std::map<std::string, OutputSpec>* output_maps[] = {
+    &md.yearly_netcdf_outputs, &md.monthly_netcdf_outputs, &md.daily_netcdf_outputs
+  };
+  for(int im=0; im<3; im++){
+    std::map<std::string, OutputSpec>::const_iterator map_itr;
+    for(map_itr = output_maps[im]->begin(); map_itr != output_maps[im]->end(); ++map_itr){
+      const OutputSpec& spec = map_itr->second;
+      for(unsigned int is=0; is<stage_suffixes.size(); is++){
+        std::string filename = spec.file_path + spec.filename_prefix + stage_suffixes[is];
+        file_vars[filename].push_back(spec.var_name);
+      }
+    }
+  }
+
+  file_vars[run_status_fname].push_back("run_status");
+  file_vars[run_status_fname].push_back("total_runtime");
+
+  if (md.solver_stats) {
+    const char* solvers[] = {"soil_temp", "soil_water"};
+    const char* counts[] = {"solves", "substeps", "rejections", "min_steps",
+                            "iterations", "max_iterations"};
+    for (int is=0; is<2; is++) {
+      for (int ic=0; ic<6; ic++) {
+        file_vars[solver_stats_fname(md)].push_back(std::string(solvers[is]) + "_" + counts[ic]);
+      }
+    }
+  }
+
+  if (md.write_daily_drivers) {
+    const char* stages[] = {"eq", "sp", "tr", "sc"};
+    for (int is = 0; is < 4; is++) {
+      if (DailyDrivers::file_years(md, stages[is]) > 0) {
+        std::string fname = DailyDrivers::filename(md.output_dir, stages[is]);
+        for (int iv = 0; iv < DailyDrivers::var_count(); iv++) {
+          file_vars[fname].push_back(DailyDrivers::var_name(iv));
+        }
+      }
+    }
+  }
+
+  return file_vars;
+}
+
 /** Pretty print a 2D vector of ints */
 void pp_2dvec(const std::vector<std::vector<int> > & vv) {
 
@@ -576,6 +1250,7 @@ std::vector<float> read_new_co2_file(const std::string &filename) {
   int ncid;
   
   BOOST_LOG_SEV(glg, debug) << "Opening dataset: " << filename;
+  temutil::NetCDFLock lock(temutil::netcdf_mutex());
   temutil::nc( nc_open(filename.c_str(), NC_NOWRITE, &ncid), filename );
   
   BOOST_LOG_SEV(glg, debug) << "Find out how much data there is...";
@@ -601,18 +1276,8 @@ std::vector<float> read_new_co2_file(const std::string &filename) {
 /** Advance model. Attempt to drive the model thru the run-stages.
  * May throw exceptions. (Which kind?)
 */
-void advance_model(const int rowidx, const int colidx,
-                   const ModelData& modeldata, const bool calmode,
-                   const std::string& pr_restart_fname,
-                   const std::string& eq_restart_fname,
-                   const std::string& sp_restart_fname,
-                   const std::string& tr_restart_fname,
-                   const std::string& sc_restart_fname) {
-
-  BOOST_LOG_SEV(glg, info) << "Running cell (" << rowidx << ", " << colidx << ")";
-
-  BOOST_LOG_SEV(glg, info) << "Setup the Runner object...";
-  Runner runner(modeldata, calmode, rowidx, colidx);
+/** Gets a freshly constructed Runner ready for its first stage. */
+void initialize_runner(Runner& runner) {
 
   BOOST_LOG_SEV(glg, debug) << runner.cohort.ground.layer_report_string("depth thermal");
 
@@ -624,11 +1289,28 @@ void advance_model(const int rowidx, const int colidx,
   runner.cohort.initialize_state_parameters();  // sets data based on values in cohortlookup
   BOOST_LOG_SEV(glg, debug) << "right after initialize_internal_pointers() and initialize_state_parameters()"
                             << runner.cohort.ground.layer_report_string("depth ptr");
+}
 
+/** Sets the module switches for a stage ("pr", "eq", "sp", "tr" or "sc")
+ *  and loads the state the stage starts from. Returns the number of years
+ *  to run the stage for.
+ *
+ *  The SP, TR and SC stages start from the restart file written by the
+ *  previous stage, unless the user has given a restart file to use.
+ */
+int setup_stage(Runner& runner, const ModelData& modeldata,
+                const std::string& stage, const int rowidx, const int colidx,
+                const std::string& prev_restart_fname) {
 
-  // PRE RUN STAGE (PR)
-  if (modeldata.pr_yrs > 0) {
-    BOOST_LOG_NAMED_SCOPE("PRE-RUN");
+  ModelData* md = runner.cohort.md;
+
+  if (runner.calcontroller_ptr) {
+    runner.calcontroller_ptr->handle_stage_start();
+  }
+
+  int stage_yrs = 0;
+
+  if (stage == "pr") {
     /** Env-only "pre-run" stage.
          - should use only the env module
          - number of years to run can be controlled on cmd line
@@ -637,74 +1319,44 @@ void advance_model(const int rowidx, const int colidx,
          - FIX: need to set yrs since dsb ?
          - FIX: should ignore calibration directives?
     */
-
     assert(modeldata.restart_from.empty() && 
       "You can't restart a pre-run! Make sure restart_from config setting is blank (empty string) or turn off pr years.");
 
-    if (runner.calcontroller_ptr) {
-      runner.calcontroller_ptr->handle_stage_start();
-    }
-
     // turn off everything but env
-    runner.cohort.md->set_envmodule(runner.cohort.md->pr_env);
-    runner.cohort.md->set_bgcmodule(runner.cohort.md->pr_bgc);
-    runner.cohort.md->set_nfeed(runner.cohort.md->pr_nfeed);
-    runner.cohort.md->set_avlnflg(runner.cohort.md->pr_avln);
-    runner.cohort.md->set_baseline(runner.cohort.md->pr_baseline);
-    runner.cohort.md->set_dsbmodule(runner.cohort.md->pr_dsb);
-    runner.cohort.md->set_dslmodule(runner.cohort.md->pr_dsl);
-    runner.cohort.md->set_dynamic_lai_module(runner.cohort.md->pr_dyn_lai);
+    md->set_envmodule(md->pr_env);
+    md->set_bgcmodule(md->pr_bgc);
+    md->set_nfeed(md->pr_nfeed);
+    md->set_avlnflg(md->pr_avln);
+    md->set_baseline(md->pr_baseline);
+    md->set_dsbmodule(md->pr_dsb);
+    md->set_dslmodule(md->pr_dsl);
+    md->set_dynamic_lai_module(md->pr_dyn_lai);
 
     BOOST_LOG_SEV(glg, debug) << "Ground, right before 'pre-run'. "
                               << runner.cohort.ground.layer_report_string("depth thermal");
 
-    runner.run_years(0, modeldata.pr_yrs, "pre-run"); // climate is prepared w/in here.
-
-    BOOST_LOG_SEV(glg, debug) << "Ground, right after 'pre-run'"
-                              << runner.cohort.ground.layer_report_string("depth thermal");
-
-    // Update restartdata structure from the running state
-    runner.cohort.set_restartdata_from_state();
-
-    runner.cohort.restartdata.verify_logical_values();
-    BOOST_LOG_SEV(glg, debug) << "RestartData post PR";
-    runner.cohort.restartdata.restartdata_to_log();
-
-    BOOST_LOG_SEV(glg, info) << "Writing RestartData to: " << pr_restart_fname;
-    runner.cohort.restartdata.write_pixel_to_ncfile(pr_restart_fname, rowidx, colidx);
-
-    if (runner.calcontroller_ptr) {
-      runner.calcontroller_ptr->handle_stage_end("pr");
-    }
-
+    return modeldata.pr_yrs;
   }
 
-  // EQUILIBRIUM STAGE (EQ)
-  if (modeldata.eq_yrs > 0) {
-    BOOST_LOG_NAMED_SCOPE("EQ");
+  if (stage == "eq") {
     BOOST_LOG_SEV(glg, monitor) << "Equilibrium Initial Year Count: " << modeldata.eq_yrs;
 
-    //assert( (modeldata.restart_from.length() < 1) && "You can't restart an equilibrium run!");
     assert( modeldata.restart_from.empty()  && 
       "You can't restart an eq run. Either turn off eq years, or set restart_from to an empty string!");
-    
-    if (runner.calcontroller_ptr) {
-      runner.calcontroller_ptr->handle_stage_start();
-    }
 
-    runner.cohort.md->set_envmodule(runner.cohort.md->eq_env);
-    runner.cohort.md->set_bgcmodule(runner.cohort.md->eq_bgc);
-    runner.cohort.md->set_nfeed(runner.cohort.md->eq_nfeed);
-    runner.cohort.md->set_avlnflg(runner.cohort.md->eq_avln);
-    runner.cohort.md->set_baseline(runner.cohort.md->eq_baseline);
-    runner.cohort.md->set_dsbmodule(runner.cohort.md->eq_dsb);
-    runner.cohort.md->set_dslmodule(runner.cohort.md->eq_dsl);
-    runner.cohort.md->set_dynamic_lai_module(runner.cohort.md->eq_dyn_lai);
+    md->set_envmodule(md->eq_env);
+    md->set_bgcmodule(md->eq_bgc);
+    md->set_nfeed(md->eq_nfeed);
+    md->set_avlnflg(md->eq_avln);
+    md->set_baseline(md->eq_baseline);
+    md->set_dsbmodule(md->eq_dsb);
+    md->set_dslmodule(md->eq_dsl);
+    md->set_dynamic_lai_module(md->eq_dyn_lai);
 
     // This variable ensures that OpenMP threads do not modify
     // the shared modeldata.eq_yrs value.
     int fri_adj_eq_yrs = modeldata.eq_yrs;//EQ years adjusted by FRI if necessary
-    if (runner.cohort.md->get_dsbmodule()) {
+    if (md->get_dsbmodule()) {
       // The transition to SP must occur at the completion of a
       // fire cycle (i.e. a year or two prior to the next fire).
       // To ensure this, re-set modeldata's EQ year count to an
@@ -724,212 +1376,320 @@ void advance_model(const int rowidx, const int colidx,
       }
     }
 
-    // Run model
     BOOST_LOG_SEV(glg, monitor) << "Running Equilibrium, " << fri_adj_eq_yrs << " years.";
-    runner.run_years(0, fri_adj_eq_yrs, "eq-run");
-
-    // Update restartdata structure from the running state
-    runner.cohort.set_restartdata_from_state();
-
-    runner.cohort.restartdata.verify_logical_values();
-    BOOST_LOG_SEV(glg, debug) << "RestartData post EQ";
-    runner.cohort.restartdata.restartdata_to_log();
-
-    BOOST_LOG_SEV(glg, info) << "Writing RestartData to: " << eq_restart_fname;
-    runner.cohort.restartdata.write_pixel_to_ncfile(eq_restart_fname, rowidx, colidx);
-
-    if (modeldata.eq_yrs < runner.cohort.fire.getFRI()) {
-      BOOST_LOG_SEV(glg, warn) << "The model did not run enough years to complete a disturbance cycle!";
-    }
-
-    if (runner.calcontroller_ptr) {
-      runner.calcontroller_ptr->handle_stage_end("eq");
-    }
-
+    return fri_adj_eq_yrs;
   }
 
-  // SPINUP STAGE (SP)
-  if (modeldata.sp_yrs > 0) {
-    BOOST_LOG_NAMED_SCOPE("SP");
+  if (stage == "sp") {
     BOOST_LOG_SEV(glg, monitor) << "Running Spinup, " << modeldata.sp_yrs << " years.";
-
-    if (runner.calcontroller_ptr) {
-      runner.calcontroller_ptr->handle_stage_start();
-    }
-
-    runner.cohort.md->set_envmodule(runner.cohort.md->sp_env);
-    runner.cohort.md->set_bgcmodule(runner.cohort.md->sp_bgc);
-    runner.cohort.md->set_nfeed(runner.cohort.md->sp_nfeed);
-    runner.cohort.md->set_avlnflg(runner.cohort.md->sp_avln);
-    runner.cohort.md->set_baseline(runner.cohort.md->sp_baseline);
-    runner.cohort.md->set_dsbmodule(runner.cohort.md->sp_dsb);
-    runner.cohort.md->set_dslmodule(runner.cohort.md->sp_dsl);
-    runner.cohort.md->set_dynamic_lai_module(runner.cohort.md->sp_dyn_lai);
+    md->set_envmodule(md->sp_env);
+    md->set_bgcmodule(md->sp_bgc);
+    md->set_nfeed(md->sp_nfeed);
+    md->set_avlnflg(md->sp_avln);
+    md->set_baseline(md->sp_baseline);
+    md->set_dsbmodule(md->sp_dsb);
+    md->set_dslmodule(md->sp_dsl);
+    md->set_dynamic_lai_module(md->sp_dyn_lai);
 
     runner.cohort.climate.monthlycontainers2log();
+    stage_yrs = modeldata.sp_yrs;
+  }
+  else if (stage == "tr") {
+    BOOST_LOG_SEV(glg, monitor) << "Running Transient, " << modeldata.tr_yrs << " years";
+    md->set_envmodule(md->tr_env);
+    md->set_bgcmodule(md->tr_bgc);
+    md->set_nfeed(md->tr_nfeed);
+    md->set_avlnflg(md->tr_avln);
+    md->set_baseline(md->tr_baseline);
+    md->set_dsbmodule(md->tr_dsb);
+    md->set_dslmodule(md->tr_dsl);
+    md->set_dynamic_lai_module(md->tr_dyn_lai);
+    stage_yrs = modeldata.tr_yrs;
+  }
+  else if (stage == "sc") {
+    BOOST_LOG_SEV(glg, monitor) << "Running Scenario, " << modeldata.sc_yrs << " years.";
+    md->set_envmodule(md->sc_env);
+    md->set_bgcmodule(md->sc_bgc);
+    md->set_nfeed(md->sc_nfeed);
+    md->set_avlnflg(md->sc_avln);
+    md->set_baseline(md->sc_baseline);
+    md->set_dsbmodule(md->sc_dsb);
+    md->set_dslmodule(md->sc_dsl);
+    md->set_dynamic_lai_module(md->sc_dyn_lai);
+    stage_yrs = modeldata.sc_yrs;
+  }
 
-    if ( modeldata.restart_from.empty() ) {
-      BOOST_LOG_SEV(glg, warn) << "No restart file specified for SP stage. "
-                               << "Using default EQ restart file from previous stage of this run: " << eq_restart_fname;
-      BOOST_LOG_SEV(glg, debug) << "Loading RestartData from: " << eq_restart_fname;
-      runner.cohort.restartdata.update_from_ncfile(eq_restart_fname, rowidx, colidx);
-    } else {
-      BOOST_LOG_SEV(glg, info) << "User specified restart file for SP stage: " << modeldata.restart_from;
-      BOOST_LOG_SEV(glg, info) << "Restarting from: " << modeldata.restart_from;
-      runner.cohort.restartdata.update_from_ncfile(modeldata.restart_from, rowidx, colidx);
+  // SP, TR and SC start from the previous stage's restart record. If that
+  // stage ran in this Runner the record is still in restartdata and the
+  // file doesn't need to be read back.
+  // A cell resuming part way through this stage starts from the state in
+  // its checkpoint instead.
+  if ( runner.checkpoint_stage == stage ) {
+    BOOST_LOG_SEV(glg, info) << "Starting " << stage << " stage from the cell's checkpoint, year "
+                             << runner.checkpoint_year;
+  } else if ( modeldata.restart_from.empty() &&
+       modeldata.restart_handoff != "file" && runner.restartdata_fname == prev_restart_fname ) {
+    BOOST_LOG_SEV(glg, debug) << "Starting " << stage << " stage from the RestartData "
+                              << "held in memory for " << prev_restart_fname;
+    if (modeldata.restart_handoff == "verify") {
+      verify_restart_handoff(runner, modeldata, prev_restart_fname, rowidx, colidx);
     }
-    // FIX: if restart file has -9999, then soil temps can end up
-    // impossibly low should check for valid values prior to actual use
+  } else if ( modeldata.restart_from.empty() ) {
+    BOOST_LOG_SEV(glg, warn) << "No restart file specified for " << stage << " stage. "
+                             << "Using default restart file from previous stage of this run: " << prev_restart_fname;
+    BOOST_LOG_SEV(glg, debug) << "Loading RestartData from: " << prev_restart_fname;
+    load_restart(runner.cohort.restartdata, modeldata, prev_restart_fname, rowidx, colidx);
+  } else {
+    BOOST_LOG_SEV(glg, info) << "User specified restart file for " << stage << " stage: " << modeldata.restart_from;
+    BOOST_LOG_SEV(glg, info) << "Restarting from: " << modeldata.restart_from;
+    load_restart(runner.cohort.restartdata, modeldata, modeldata.restart_from, rowidx, colidx);
+  }
+  // FIX: if restart file has -9999, then soil temps can end up
+  // impossibly low should check for valid values prior to actual use
 
-    // Maybe a diffcult to maintain in the future
-    // when/if more variables are added?
+  if (stage != "sc") {
     runner.cohort.restartdata.verify_logical_values();
+  }
 
-    BOOST_LOG_SEV(glg, debug) << "RestartData pre SP";
-    runner.cohort.restartdata.restartdata_to_log();
+  BOOST_LOG_SEV(glg, debug) << "RestartData pre " << stage;
+  runner.cohort.restartdata.restartdata_to_log();
 
-    // Copy values from the updated restart data to cohort and cd
-    runner.cohort.set_state_from_restartdata();
+  // Copy values from the updated restart data to cohort and cd
+  runner.cohort.set_state_from_restartdata();
 
-    // Run model
-    runner.run_years(0, modeldata.sp_yrs, "sp-run");
+  if (stage == "tr" && modeldata.sc_yrs > 0) {
+    // Read the projected climate while TR runs so it is ready for SC
+    runner.cohort.prefetch_proj_climate(modeldata.proj_climate_file);
+  }
 
-    // Update restartdata structure from the running state
-    runner.cohort.set_restartdata_from_state();
+  if (stage == "sc") {
+    // Loading projected data instead of historic. FIX?
+    runner.cohort.load_proj_climate(modeldata.proj_climate_file);
+    runner.cohort.load_proj_co2(modeldata.proj_co2_file);
+    runner.cohort.load_proj_explicit_fire(modeldata.proj_exp_fire_file);
+  }
 
-    BOOST_LOG_SEV(glg, debug) << "RestartData post SP";
-    runner.cohort.restartdata.restartdata_to_log();
+  if (stage == "tr" || stage == "sc") {
+    BOOST_LOG_SEV(glg, warn) << "MAKE SURE YOUR FIRE INPUTS ARE SETUP CORRECTLY!";
+  }
 
-    BOOST_LOG_SEV(glg, info) << "Writing RestartData out to: " << sp_restart_fname;
-    runner.cohort.restartdata.write_pixel_to_ncfile(sp_restart_fname, rowidx, colidx);
+  return stage_yrs;
+}
 
-    if (runner.calcontroller_ptr) {
-      runner.calcontroller_ptr->handle_stage_end("sp");
-    }
+/** Checks that the RestartData handed to the next stage in memory is
+ *  bitwise identical to what reading the restart file back would give.
+ */
+void verify_restart_handoff(Runner& runner, const ModelData& modeldata,
+                            const std::string& restart_fname,
+                            const int rowidx, const int colidx) {
+
+  // Start from a byte copy so that members that aren't in the file, and
+  // any padding, match
+  RestartData from_file;
+  std::memcpy((void*)&from_file, (const void*)&runner.cohort.restartdata, sizeof(RestartData));
+  load_restart(from_file, modeldata, restart_fname, rowidx, colidx);
+
+  if (std::memcmp((const void*)&from_file, (const void*)&runner.cohort.restartdata,
+                  sizeof(RestartData)) != 0) {
+    BOOST_LOG_SEV(glg, fatal) << "RestartData held in memory differs from " << restart_fname;
+    throw std::runtime_error("RestartData held in memory differs from the restart file " + restart_fname);
+  }
+  BOOST_LOG_SEV(glg, debug) << "RestartData held in memory matches " << restart_fname;
+}
 
+/** Reads a cell's RestartData from a NetCDF restart file or, for a .bin
+ *  file, a binary checkpoint. */
+void load_restart(RestartData& restartdata, const ModelData& modeldata,
+                  const std::string& restart_fname,
+                  const int rowidx, const int colidx) {
+  if (RestartCheckpoint::is_checkpoint(restart_fname)) {
+    // Stage checkpoints are mapped for writing from the start so the
+    // mapping isn't replaced when the stage saves to them.
+    bool writable = (restart_fname != modeldata.restart_from);
+    modeldata.restart_checkpoints->get(restart_fname, writable)->read(restartdata, rowidx, colidx);
+  } else {
+    restartdata.update_from_ncfile(*modeldata.output_sink, restart_fname, rowidx, colidx);
   }
+}
 
-  // TRANSIENT STAGE (TR)
-  if (modeldata.tr_yrs > 0) {
-    BOOST_LOG_NAMED_SCOPE("TR");
-    BOOST_LOG_SEV(glg, monitor) << "Running Transient, " << modeldata.tr_yrs << " years";
+/** Writes a cell's RestartData to a NetCDF restart file or, for a .bin
+ *  file, a binary checkpoint. */
+void save_restart(RestartData& restartdata, const ModelData& modeldata,
+                  const std::string& restart_fname,
+                  const int rowidx, const int colidx) {
+  if (RestartCheckpoint::is_checkpoint(restart_fname)) {
+    modeldata.restart_checkpoints->get(restart_fname, true)->write(restartdata, rowidx, colidx);
+  } else {
+    restartdata.write_pixel_to_ncfile(*modeldata.output_sink, restart_fname, rowidx, colidx);
+  }
+}
 
-    if (runner.calcontroller_ptr) {
-      runner.calcontroller_ptr->handle_stage_start();
+/** Creates an empty restart file in the run's restart format. Every
+ *  process takes part in creating a NetCDF file; a binary checkpoint is
+ *  created by the first process only.
+ */
+void create_restart_file(const ModelData& modeldata, const std::string& restart_fname,
+                         const int num_rows, const int num_cols, const int id) {
+  if (modeldata.restart_format == "binary") {
+    if (id == 0) {
+      RestartCheckpoint::create(restart_fname, num_rows, num_cols);
     }
+  } else {
+    RestartData::create_empty_file(restart_fname, num_rows, num_cols);
+  }
+}
 
-    runner.cohort.md->set_envmodule(runner.cohort.md->tr_env);
-    runner.cohort.md->set_bgcmodule(runner.cohort.md->tr_bgc);
-    runner.cohort.md->set_nfeed(runner.cohort.md->tr_nfeed);
-    runner.cohort.md->set_avlnflg(runner.cohort.md->tr_avln);
-    runner.cohort.md->set_baseline(runner.cohort.md->tr_baseline);
-    runner.cohort.md->set_dsbmodule(runner.cohort.md->tr_dsb);
-    runner.cohort.md->set_dslmodule(runner.cohort.md->tr_dsl);
-    runner.cohort.md->set_dynamic_lai_module(runner.cohort.md->tr_dyn_lai);
-
-    if ( modeldata.restart_from.empty() ) {
-      BOOST_LOG_SEV(glg, warn) << "No restart file specified for TR stage. "
-                               << "Using default SP restart file from previous stage of this run: " << sp_restart_fname;
-      BOOST_LOG_SEV(glg, debug) << "Loading RestartData from: " << sp_restart_fname;
-      runner.cohort.restartdata.update_from_ncfile(sp_restart_fname, rowidx, colidx);
-    } else {
-      BOOST_LOG_SEV(glg, info) << "User specified restart file for SP stage: " << modeldata.restart_from;
-      BOOST_LOG_SEV(glg, info) << "Restarting from: " << modeldata.restart_from;
-      runner.cohort.restartdata.update_from_ncfile(modeldata.restart_from, rowidx, colidx);
-    }
+/** Saves the state at the end of a stage to the stage's restart file. */
+void finish_stage(Runner& runner, const ModelData& modeldata,
+                  const std::string& stage, const int rowidx, const int colidx,
+                  const std::string& restart_fname) {
+
+  if (stage == "pr") {
+    BOOST_LOG_SEV(glg, debug) << "Ground, right after 'pre-run'"
+                              << runner.cohort.ground.layer_report_string("depth thermal");
+  }
 
+  // Update restartdata structure from the running state
+  runner.cohort.set_restartdata_from_state();
 
+  if (stage == "pr" || stage == "eq") {
     runner.cohort.restartdata.verify_logical_values();
+  }
 
-    BOOST_LOG_SEV(glg, debug) << "RestartData pre TR";
-    runner.cohort.restartdata.restartdata_to_log();
-
-    // Copy values from the updated restart data to cohort and cd
-    runner.cohort.set_state_from_restartdata();
+  BOOST_LOG_SEV(glg, debug) << "RestartData post " << stage;
+  runner.cohort.restartdata.restartdata_to_log();
 
-    BOOST_LOG_SEV(glg, warn) << "MAKE SURE YOUR FIRE INPUTS ARE SETUP CORRECTLY!";
+  if (modeldata.persist_restart(stage)) {
+    BOOST_LOG_SEV(glg, info) << "Writing RestartData to: " << restart_fname;
+    save_restart(runner.cohort.restartdata, modeldata, restart_fname, rowidx, colidx);
+  }
+  runner.restartdata_fname = restart_fname;
 
-    // Run model
-    runner.run_years(0, modeldata.tr_yrs, "tr-run");
+  if (stage == "eq" && modeldata.eq_yrs < runner.cohort.fire.getFRI()) {
+    BOOST_LOG_SEV(glg, warn) << "The model did not run enough years to complete a disturbance cycle!";
+  }
 
-    // Update restartdata structure from the running state
-    runner.cohort.set_restartdata_from_state();
+  if (runner.calcontroller_ptr) {
+    runner.calcontroller_ptr->handle_stage_end(stage);
+  }
 
-    BOOST_LOG_SEV(glg, debug) << "RestartData post TR";
-    runner.cohort.restartdata.restartdata_to_log();
+  // This stage's output ("_tr.nc"), restart ("-tr.nc") and daily
+  // drivers files
+  release_shared_files(modeldata, stage + ".nc");
+}
 
-    BOOST_LOG_SEV(glg, info) << "Writing RestartData out to: " << tr_restart_fname;
-    runner.cohort.restartdata.write_pixel_to_ncfile(tr_restart_fname, rowidx, colidx);
+/** The file holding a cell's mid-stage checkpoint. */
+std::string cell_checkpoint_fname(const ModelData& modeldata, const int rowidx, const int colidx) {
+  std::stringstream ss;
+  ss << modeldata.output_dir << "checkpoints/cell-" << rowidx << "-" << colidx << ".ckpt";
+  return ss.str();
+}
 
-    if (runner.calcontroller_ptr) {
-      runner.calcontroller_ptr->handle_stage_end("tr");
-    }
+/** Whether a cell resuming from a checkpoint had already finished a
+ *  stage, i.e. the stage comes before the one the checkpoint was saved in.
+ */
+bool stage_done(const Runner& runner, const std::string& stage) {
+  const std::string stage_order = "pr,eq,sp,tr,sc";
+  return !runner.checkpoint_stage.empty() &&
+         stage_order.find(stage) < stage_order.find(runner.checkpoint_stage);
+}
 
+/** Runs the years of a stage for a cell, saving a checkpoint every
+ *  checkpoint_interval years. A cell resuming part way through the stage
+ *  starts from its checkpoint.
+ */
+void run_stage_years(Runner& runner, const ModelData& modeldata, const std::string& stage,
+                     const std::string& stage_run, const int stage_yrs) {
+
+  int start_year = 0;
+  if (runner.checkpoint_stage == stage) {
+    // setup_stage(..) doesn't load any state for PR and EQ
+    runner.set_state_from_checkpoint();
+    start_year = runner.checkpoint_year;
+    runner.checkpoint_stage.clear();
   }
 
-  // SCENARIO STAGE (SC)
-  if (modeldata.sc_yrs > 0) {
-    BOOST_LOG_NAMED_SCOPE("SC");
-    BOOST_LOG_SEV(glg, monitor) << "Running Scenario, " << modeldata.sc_yrs << " years.";
-
-    if (runner.calcontroller_ptr) {
-      runner.calcontroller_ptr->handle_stage_start();
-    }
+  if (modeldata.checkpoint_interval <= 0) {
+    runner.run_years(start_year, stage_yrs, stage_run);
+    return;
+  }
 
-    runner.cohort.md->set_envmodule(runner.cohort.md->sc_env);
-    runner.cohort.md->set_bgcmodule(runner.cohort.md->sc_bgc);
-    runner.cohort.md->set_nfeed(runner.cohort.md->sc_nfeed);
-    runner.cohort.md->set_avlnflg(runner.cohort.md->sc_avln);
-    runner.cohort.md->set_baseline(runner.cohort.md->sc_baseline);
-    runner.cohort.md->set_dsbmodule(runner.cohort.md->sc_dsb);
-    runner.cohort.md->set_dslmodule(runner.cohort.md->sc_dsl);
-    runner.cohort.md->set_dynamic_lai_module(runner.cohort.md->sc_dyn_lai);
-
-    // update the cohort's restart data object
-
-    if ( modeldata.restart_from.empty() ) {
-      BOOST_LOG_SEV(glg, warn) << "No restart file specified for SC stage. "
-                               << "Using default TR restart file from previous stage of this run: " << tr_restart_fname;
-      BOOST_LOG_SEV(glg, debug) << "Loading RestartData from: " << tr_restart_fname;
-      runner.cohort.restartdata.update_from_ncfile(tr_restart_fname, rowidx, colidx);
-    } else {
-      BOOST_LOG_SEV(glg, info) << "User specified restart file for SC stage: " << modeldata.restart_from;
-      BOOST_LOG_SEV(glg, info) << "Restarting from: " << modeldata.restart_from;
-      runner.cohort.restartdata.update_from_ncfile(modeldata.restart_from, rowidx, colidx);
+  BOOST_LOG_NAMED_SCOPE("Y") {
+  for (int iy = start_year; iy < stage_yrs; ++iy) {
+    runner.run_year(iy, 0, stage_yrs, stage_run);
+
+    int next_year = iy + 1;
+    if (next_year % modeldata.checkpoint_interval == 0 && next_year < stage_yrs) {
+      // Everything handed to the sink so far has to be in the files before
+      // the checkpoint says it is
+      modeldata.output_sink->sync_all();
+      runner.save_checkpoint(cell_checkpoint_fname(modeldata, runner.y, runner.x),
+                             stage, next_year);
     }
+  }} // end year loop (and named scope)
+}
 
+void advance_model(const int rowidx, const int colidx,
+                   const ModelData& modeldata, const bool calmode,
+                   const std::string& pr_restart_fname,
+                   const std::string& eq_restart_fname,
+                   const std::string& sp_restart_fname,
+                   const std::string& tr_restart_fname,
+                   const std::string& sc_restart_fname) {
 
-    BOOST_LOG_SEV(glg, debug) << "RestartData pre SC";
-    runner.cohort.restartdata.restartdata_to_log();
-
-    // Copy values from the updated restart data to cohort and cd
-    runner.cohort.set_state_from_restartdata();
-
-    // Loading projected data instead of historic. FIX?
-    runner.cohort.load_proj_climate(modeldata.proj_climate_file);
-    runner.cohort.load_proj_co2(modeldata.proj_co2_file);
-    runner.cohort.load_proj_explicit_fire(modeldata.proj_exp_fire_file);
+  BOOST_LOG_SEV(glg, info) << "Running cell (" << rowidx << ", " << colidx << ")";
 
-    BOOST_LOG_SEV(glg, warn) << "MAKE SURE YOUR FIRE INPUTS ARE SETUP CORRECTLY!";
+  BOOST_LOG_SEV(glg, info) << "Setup the Runner object...";
+  Runner runner(modeldata, calmode, rowidx, colidx);
+  initialize_runner(runner);
 
-    // Run model
-    runner.run_years(0, modeldata.sc_yrs, "sc-run");
+  // A resumed cell with a checkpoint skips the stages it had finished
+  if (modeldata.resume) {
+    runner.load_checkpoint(cell_checkpoint_fname(modeldata, rowidx, colidx));
+  }
 
-    // Update restartdata structure from the running state
-    runner.cohort.set_restartdata_from_state();
+  // PRE RUN STAGE (PR)
+  if (modeldata.pr_yrs > 0 && !stage_done(runner, "pr")) {
+    BOOST_LOG_NAMED_SCOPE("PRE-RUN");
+    int stage_yrs = setup_stage(runner, modeldata, "pr", rowidx, colidx, "");
+    run_stage_years(runner, modeldata, "pr", "pre-run", stage_yrs); // climate is prepared w/in here.
+    finish_stage(runner, modeldata, "pr", rowidx, colidx, pr_restart_fname);
+  }
 
-    BOOST_LOG_SEV(glg, debug) << "RestartData post SC";
-    runner.cohort.restartdata.restartdata_to_log();
+  // EQUILIBRIUM STAGE (EQ)
+  if (modeldata.eq_yrs > 0 && !stage_done(runner, "eq")) {
+    BOOST_LOG_NAMED_SCOPE("EQ");
+    int stage_yrs = setup_stage(runner, modeldata, "eq", rowidx, colidx, "");
+    run_stage_years(runner, modeldata, "eq", "eq-run", stage_yrs);
+    finish_stage(runner, modeldata, "eq", rowidx, colidx, eq_restart_fname);
+  }
 
-    BOOST_LOG_SEV(glg, info) << "Writing RestartData out to: " << sc_restart_fname;
-    runner.cohort.restartdata.write_pixel_to_ncfile(sc_restart_fname, rowidx, colidx);
+  // SPINUP STAGE (SP)
+  if (modeldata.sp_yrs > 0 && !stage_done(runner, "sp")) {
+    BOOST_LOG_NAMED_SCOPE("SP");
+    int stage_yrs = setup_stage(runner, modeldata, "sp", rowidx, colidx, eq_restart_fname);
+    run_stage_years(runner, modeldata, "sp", "sp-run", stage_yrs);
+    finish_stage(runner, modeldata, "sp", rowidx, colidx, sp_restart_fname);
+  }
 
-    if (runner.calcontroller_ptr) {
-      runner.calcontroller_ptr->handle_stage_end("sc");
-    }
+  // TRANSIENT STAGE (TR)
+  if (modeldata.tr_yrs > 0 && !stage_done(runner, "tr")) {
+    BOOST_LOG_NAMED_SCOPE("TR");
+    int stage_yrs = setup_stage(runner, modeldata, "tr", rowidx, colidx, sp_restart_fname);
+    run_stage_years(runner, modeldata, "tr", "tr-run", stage_yrs);
+    finish_stage(runner, modeldata, "tr", rowidx, colidx, tr_restart_fname);
+  }
 
+  // SCENARIO STAGE (SC)
+  if (modeldata.sc_yrs > 0 && !stage_done(runner, "sc")) {
+    BOOST_LOG_NAMED_SCOPE("SC");
+    int stage_yrs = setup_stage(runner, modeldata, "sc", rowidx, colidx, tr_restart_fname);
+    run_stage_years(runner, modeldata, "sc", "sc-run", stage_yrs);
+    finish_stage(runner, modeldata, "sc", rowidx, colidx, sc_restart_fname);
   }
 
+  write_solver_stats(modeldata, runner, rowidx, colidx);
+
   // NOTE: Could have an option to set some time constants based on
   //       some sizes/dimensions of the input driving data...
 
@@ -973,6 +1733,7 @@ void create_empty_run_status_file(const std::string& fname,
   BOOST_LOG_SEV(glg, debug) << "Creating new file: "<<fname<<" with 'NC_CLOBBER'";
   int ncid;
 
+  temutil::NetCDFLock lock(temutil::netcdf_mutex());
 
 #ifdef WITHMPI
 
@@ -1043,20 +1804,118 @@ void create_empty_run_status_file(const std::string& fname,
 
 }
 
-void write_status_info(const std::string fname, std::string varname, int row, int col, int statusCode) {
+std::string solver_stats_fname(const ModelData& md) {
+  return md.output_dir + "solver_stats.nc";
+}
 
+void create_empty_solver_stats_file(const std::string& fname,
+    const int ysize, const int xsize) {
+
+  BOOST_LOG_SEV(glg, debug) << "Creating new file: "<<fname<<" with 'NC_CLOBBER'";
   int ncid;
-  int statusV;
+
+  temutil::NetCDFLock lock(temutil::netcdf_mutex());
+#ifdef WITHMPI
+  temutil::nc( nc_create_par(fname.c_str(), NC_CLOBBER|NC_NETCDF4|NC_MPIIO, MPI_COMM_WORLD, MPI_INFO_NULL, &ncid), fname );
+#else
+  temutil::nc( nc_create(fname.c_str(), NC_CLOBBER, &ncid), fname );
+#endif
+
+  int dimids[3];
+  temutil::nc( nc_def_dim(ncid, "month", 12, &dimids[0]) );
+  temutil::nc( nc_def_dim(ncid, "Y", ysize, &dimids[1]) );
+  temutil::nc( nc_def_dim(ncid, "X", xsize, &dimids[2]) );
+
+  // Counts can run past the range of an int over a long run, and the
+  // classic format has no 64 bit integers
+  const char* solvers[] = {"soil_temp", "soil_water"};
+  const char* solver_desc[] = {"soil temperature (TemperatureUpdator::iterate)",
+                               "soil water (Richards::update)"};
+  const char* counts[] = {"solves", "substeps", "rejections", "min_steps",
+                          "iterations", "max_iterations"};
+  const char* count_desc[] = {"daily solves", "accepted sub-steps",
+                              "sub-steps rejected and retried with half the step",
+                              "sub-steps accepted only at the minimum step",
+                              "trial solutions", "most trial solutions in one solve"};
+
+  for (int is=0; is<2; is++) {
+    for (int ic=0; ic<6; ic++) {
+      std::string varname = std::string(solvers[is]) + "_" + counts[ic];
+      std::string desc = std::string(solver_desc[is]) + ": " + count_desc[ic]
+                         + ", summed over every year run for each calendar month";
+      int varid;
+      temutil::nc( nc_def_var(ncid, varname.c_str(), NC_DOUBLE, 3, dimids, &varid) );
+      temutil::nc( nc_put_att_double(ncid, varid, "_FillValue", NC_DOUBLE, 1, &MISSING_D) );
+      temutil::nc( nc_put_att_text(ncid, varid, "long_name", desc.length(), desc.c_str()) );
+    }
+  }
+
+  temutil::nc( nc_put_att_text(ncid, NC_GLOBAL, "Git_SHA", strlen(GIT_SHA), GIT_SHA) );
+
+  try {
+    temutil::nc( nc_enddef(ncid) );
+  } catch (const temutil::NetCDFDefineModeException& e) {
+    BOOST_LOG_SEV(glg, info) << "Error ending define mode: " << e.what();
+  }
+
+  temutil::nc( nc_close(ncid) );
+}
+
+void create_daily_drivers_files(const ModelData& md, const int ysize,
+                                const int xsize, const bool keep_existing) {
+  const char* stages[] = {"eq", "sp", "tr", "sc"};
+  for (int is = 0; is < 4; is++) {
+    int nyears = DailyDrivers::file_years(md, stages[is]);
+    std::string fname = DailyDrivers::filename(md.output_dir, stages[is]);
+    if (nyears > 0 && !(keep_existing && boost::filesystem::exists(fname))) {
+      DailyDrivers::create_file(fname, nyears, ysize, xsize);
+    }
+  }
+}
+
+void write_solver_stats(const ModelData& md, const Runner& runner,
+                        const int rowidx, const int colidx) {
+  if (!md.solver_stats) {
+    return;
+  }
+
+  const std::string fname = solver_stats_fname(md);
+  size_t start[3] = {0, (size_t)rowidx, (size_t)colidx};
+  size_t count[3] = {12, 1, 1};
+
+  const SolverStats* stats[] = {runner.soil_temp_stats, runner.soil_water_stats};
+  const char* solvers[] = {"soil_temp", "soil_water"};
+
+  for (int is=0; is<2; is++) {
+    double solves[12], substeps[12], rejections[12], min_steps[12],
+           iterations[12], max_iterations[12];
+    for (int im=0; im<12; im++) {
+      solves[im]         = stats[is][im].solves;
+      substeps[im]       = stats[is][im].substeps;
+      rejections[im]     = stats[is][im].rejections;
+      min_steps[im]      = stats[is][im].min_steps;
+      iterations[im]     = stats[is][im].iterations;
+      max_iterations[im] = stats[is][im].max_iterations;
+    }
+    std::string prefix = std::string(solvers[is]) + "_";
+    md.output_sink->put(fname, prefix + "solves", start, count, solves);
+    md.output_sink->put(fname, prefix + "substeps", start, count, substeps);
+    md.output_sink->put(fname, prefix + "rejections", start, count, rejections);
+    md.output_sink->put(fname, prefix + "min_steps", start, count, min_steps);
+    md.output_sink->put(fname, prefix + "iterations", start, count, iterations);
+    md.output_sink->put(fname, prefix + "max_iterations", start, count, max_iterations);
+  }
+}
+
+void write_status_info(OutputSink& sink, const std::string fname, std::string varname, int row, int col, int statusCode) {
 
   int NDIMS = 2;
 
-  size_t start[NDIMS], count[NDIMS];
+  size_t start[NDIMS];
   // Set point to write
   start[0] = row;
   start[1] = col;
 
-  BOOST_LOG_SEV(glg, debug) << "Opening status file: " << fname;
-
 #ifdef WITHMPI
 
   // These are for logging identification only.
@@ -1064,31 +1923,11 @@ void write_status_info(const std::string fname, std::string varname, int row, in
   MPI_Comm_rank(MPI_COMM_WORLD, &id);
   MPI_Comm_size(MPI_COMM_WORLD, &ntasks);
 
-  // Open dataset
-  temutil::nc( nc_open_par(fname.c_str(), NC_WRITE|NC_MPIIO, MPI_COMM_SELF, MPI_INFO_NULL, &ncid), fname );
-  //temutil::nc( nc_inq_varid(ncid, "run_status", &statusV) );
-  temutil::nc( nc_inq_varid(ncid, varname.c_str(), &statusV) );
-  temutil::nc( nc_var_par_access(ncid, statusV, NC_INDEPENDENT) );
-
-  // Write data
   BOOST_LOG_SEV(glg, info) << "(MPI " << id << "/" << ntasks << ") WRITING "<< varname << " for pixel (row, col): " << row << ", " << col << "\n";
-  temutil::nc( nc_put_var1_int(ncid, statusV, start,  &statusCode) );
-
-  /* Close the netcdf file. */
-  BOOST_LOG_SEV(glg, debug) << "(MPI " << id << "/" << ntasks << ") Closing PARALLEL file." << row << ", " << col << "\n";
-  temutil::nc( nc_close(ncid) );
 #else
-
-  // Open dataset
-  temutil::nc( nc_open(fname.c_str(), NC_WRITE, &ncid), fname );
-  temutil::nc( nc_inq_varid(ncid, varname.c_str(), &statusV) );
-  
-  // Write data
   BOOST_LOG_SEV(glg, info) << "WRITING "<< varname <<" for (row, col): " << row << ", " << col << "\n";
-  temutil::nc( nc_put_var1_int(ncid, statusV, start, &statusCode) );
-
-  /* Close the netcdf file. */
-  temutil::nc( nc_close(ncid) );
-
 #endif
+
+  // The status file is held open in the sink along with the output files
+  sink.put_int(fname, varname, start, statusCode);
 }
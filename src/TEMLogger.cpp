@@ -198,6 +198,14 @@ void setup_logging(const std::string& target_severity_level, const std::string&
     exit(-1);
   }
 
+#ifdef TEM_LOG_MIN_SEVERITY
+  if (EnumParser<severity_level>().parseEnum(target_severity_level) < TEM_LOG_MIN_SEVERITY) {
+    std::cout << "NOTE: this build only has log messages at level '"
+              << TEM_LOG_MIN_SEVERITY << "' and above; lower levels were "
+              << "removed at compile time (TEM_LOG_MIN_SEVERITY)\n";
+  }
+#endif
+
   //If logging is set to disabled, set the core flag
   if(target_severity_level.find("disabled") != std::string::npos){
     std::cout << "Logging disabled\n";
@@ -13,6 +13,7 @@
 #include <sstream>
 #include <limits>
 #include <regex>
+#include <chrono>
 
 #include <json/reader.h>
 #include <json/value.h>
@@ -196,6 +197,15 @@ namespace temutil {
   }
 
 
+  /** Seconds on a steady clock, for timing parts of a run. Only the
+   *  difference between two calls means anything. Unlike omp_get_wtime()
+   *  this is available in builds without OpenMP.
+   */
+  double wall_seconds() {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
   /** Returns true for 'on' and false for 'off'.
    * Throws exception if s is not "on" or "off".
    * might want to inherit from std exception or do something else?
@@ -258,12 +268,15 @@ namespace temutil {
     return root;
   }
 
-  /** rough draft for reading a run-mask (2D vector of ints)
+  /** rough draft for reading a run-mask (2D vector of ints). Also reads
+   *  other (Y, X) int variables, such as run_status in run_status.nc.
   */
-  std::vector< std::vector<int> > read_run_mask(const std::string &filename) {
+  std::vector< std::vector<int> > read_run_mask(const std::string &filename,
+                                                const std::string &var_name) {
     int ncid;
     
     BOOST_LOG_SEV(glg, debug) << "Opening dataset: " << filename;
+    NetCDFLock lock(netcdf_mutex());
     temutil::nc( nc_open(filename.c_str(), NC_NOWRITE, &ncid), filename );
     
     BOOST_LOG_SEV(glg, debug) << "Find out how much data there is...";
@@ -281,7 +294,7 @@ namespace temutil {
     
     BOOST_LOG_SEV(glg, debug) << "Read the run flag data from the file into the 2D vector...";
     int runV;
-    temutil::nc( nc_inq_varid(ncid, "run", &runV) );
+    temutil::nc( nc_inq_varid(ncid, var_name.c_str(), &runV) );
 
     BOOST_LOG_SEV(glg, debug) << "Grab one row at a time";
     BOOST_LOG_SEV(glg, debug) << "(need contiguous memory, and vector<vector> are not contiguous)";
@@ -328,6 +341,7 @@ namespace temutil {
 
     int ncid;
 
+    NetCDFLock lock(netcdf_mutex());
 #ifdef WITHMPI
     temutil::nc( nc_open_par(fname.c_str(), NC_NOWRITE|NC_MPIIO, MPI_COMM_WORLD, MPI_INFO_NULL, &ncid), fname );
 #else
@@ -371,6 +385,7 @@ namespace temutil {
 
     int ncid;
 
+    NetCDFLock lock(netcdf_mutex());
 #ifdef WITHMPI
     temutil::nc( nc_open_par(fname.c_str(), NC_NOWRITE|NC_MPIIO, MPI_COMM_WORLD, MPI_INFO_NULL, &ncid), fname );
 #else
@@ -444,6 +459,26 @@ namespace temutil {
     handle_error(status, filepath);
   }
 
+  /** The lock held around all NetCDF calls. See TEMUtilityFunctions.h */
+  boost::recursive_mutex& netcdf_mutex() {
+    static boost::recursive_mutex m;
+    return m;
+  }
+
+  /** Size in bytes of one value of the given NetCDF data type. Only covers
+   *  the types used for dvmdostem output variables.
+   */
+  size_t nc_type_size(int nc_data_type) {
+    switch (nc_data_type) {
+      case NC_INT:    return sizeof(int);
+      case NC_FLOAT:  return sizeof(float);
+      case NC_DOUBLE: return sizeof(double);
+      default:
+        throw std::runtime_error("Unsupported NetCDF output data type: " +
+                                 boost::lexical_cast<std::string>(nc_data_type));
+    }
+  }
+
   template <typename DTYPE>
   DTYPE get_scalar(const std::string &filename,
                    const std::string &var,
@@ -453,6 +488,7 @@ namespace temutil {
     BOOST_LOG_SEV(glg, debug) << "Getting variable: " << var;
 
     int ncid;
+    NetCDFLock lock(netcdf_mutex());
     temutil::nc( nc_open(filename.c_str(), NC_NOWRITE, &ncid), filename );
 
 
@@ -540,6 +576,7 @@ namespace temutil {
     BOOST_LOG_SEV(glg, debug) << "Getting variable: " << var;
 
     int ncid;
+    NetCDFLock lock(netcdf_mutex());
     temutil::nc( nc_open(filename.c_str(), NC_NOWRITE, &ncid), filename );
 
     int timeD;
@@ -616,6 +653,7 @@ namespace temutil {
     BOOST_LOG_SEV(glg, debug) << "Getting variable: " << var;
 
     int ncid;
+    NetCDFLock lock(netcdf_mutex());
     temutil::nc( nc_open(filename.c_str(), NC_NOWRITE, &ncid), filename );
 
     int timeseries_var;
@@ -652,8 +690,19 @@ namespace temutil {
     BOOST_LOG_SEV(glg, debug) << "Opening dataset: " << fname;
 
     int ncid;
+    NetCDFLock lock(netcdf_mutex());
     temutil::nc( nc_open(fname.c_str(), NC_NOWRITE, &ncid), fname );
 
+    int start_year = get_timeseries_start_year(ncid);
+
+    temutil::nc( nc_close(ncid) );
+
+    return start_year;
+  }
+
+  /** As above, for a file that is already open. Caller holds the NetCDF lock. */
+  int get_timeseries_start_year(int ncid){
+
     int timeV;
     temutil::nc( nc_inq_varid(ncid, "time", &timeV) );
 
@@ -664,8 +713,6 @@ namespace temutil {
     temutil::nc( nc_get_att_text(ncid, timeV, "units", timeAttUnits) );
     std::string timeAttUnits_s(timeAttUnits);
 
-    temutil::nc( nc_close(ncid) );
-
     //Pattern match the year value out of timeAttUnits
     //Example attribute units string: "days since 2016-1-1 0:0:0"
     std::regex year_exp("[0-9][0-9][0-9][0-9]");
@@ -688,13 +735,24 @@ namespace temutil {
   */
   int get_timeseries_end_year(const std::string& fname){
 
-    int start_year = get_timeseries_start_year(fname);
-
     BOOST_LOG_SEV(glg, debug) << "Opening dataset: " << fname;
 
     int ncid;
+    NetCDFLock lock(netcdf_mutex());
     temutil::nc( nc_open(fname.c_str(), NC_NOWRITE, &ncid), fname );
 
+    int end_year = get_timeseries_end_year(ncid);
+
+    temutil::nc( nc_close(ncid) );
+
+    return end_year;
+  }
+
+  /** As above, for a file that is already open. Caller holds the NetCDF lock. */
+  int get_timeseries_end_year(int ncid){
+
+    int start_year = get_timeseries_start_year(ncid);
+
     //Information about the time *dimension*
     int timeD;
     size_t timeD_len;
@@ -733,12 +791,12 @@ namespace temutil {
   */
   std::pair<float, float> get_latlon(const std::string& filename, int y, int x) {
 
-    //Variables needed outside the openmp block
+    //Variables needed outside the locked block
     float lat_value;
     float lon_value;
 
-    #pragma omp critical(load_input)
     {
+      NetCDFLock lock(netcdf_mutex());
       BOOST_LOG_SEV(glg, debug) << "Opening dataset: " << filename;
       int ncid;
       temutil::nc( nc_open(filename.c_str(), NC_NOWRITE, &ncid), filename );
@@ -760,7 +818,7 @@ namespace temutil {
       temutil::nc( nc_get_var1_float(ncid, lonV, start, &lon_value));
 
       temutil::nc( nc_close(ncid) );
-    }//End critical(get_latlon)
+    }//End NetCDF lock
 
     return std::pair<float, float>(lat_value, lon_value);
   }
@@ -769,6 +827,7 @@ namespace temutil {
   int get_fri(const std::string &filename, int y, int x) {
     BOOST_LOG_SEV(glg, debug) << "Opening dataset: " << filename;
     int ncid;
+    NetCDFLock lock(netcdf_mutex());
     temutil::nc( nc_open(filename.c_str(), NC_NOWRITE, &ncid), filename );
 
     int yD, xD;
@@ -856,11 +915,11 @@ namespace temutil {
   */
   int get_veg_class(const std::string &filename2, int y2, int x2) {
 
-    //Variable needed outside the omp block
+    //Variable needed outside the locked block
     int veg_class_value;
 
-    #pragma omp critical(load_input)
     {
+      NetCDFLock lock(netcdf_mutex());
       BOOST_LOG_SEV(glg, debug) << "Opening dataset: " << filename2;
       int ncid2;
       temutil::nc( nc_open(filename2.c_str(), NC_NOWRITE, &ncid2), filename2 );
@@ -885,7 +944,7 @@ namespace temutil {
       temutil::nc( nc_get_var1_int(ncid2, veg_classificationV, start, &veg_class_value)  );
 
       temutil::nc( nc_close(ncid2) );
-    }//End critical(get_veg_class)
+    }//End NetCDF lock
 
     return veg_class_value;
   }
@@ -895,11 +954,11 @@ namespace temutil {
 
     BOOST_LOG_SEV(glg, debug) << "Opening dataset: " << filename;
 
-    //This variable is needed outside the omp block 
+    //This variable is needed outside the locked block
     int drainage_class_value;
 
-    #pragma omp critical(load_input)
     {
+      NetCDFLock lock(netcdf_mutex());
       int ncid;
       temutil::nc( nc_open(filename.c_str(), NC_NOWRITE, &ncid), filename );
 
@@ -918,7 +977,7 @@ namespace temutil {
       temutil::nc( nc_get_var1_int(ncid, drainage_classV, start, &drainage_class_value)  );
 
       temutil::nc( nc_close(ncid) );
-    }//End critical(get_drainage)
+    }//End NetCDF lock
 
     return drainage_class_value;
   }
@@ -1096,7 +1155,7 @@ namespace temutil {
 
     if ( !par_file.is_open() ) {
       BOOST_LOG_SEV(glg, fatal) << "Problem opening " << filename << "!";
-      exit(-1);
+      throw std::runtime_error("Problem opening parameter file: " + filename);
     }
 
     std::string cmtstr = cmtnum2str(cmtnum);
@@ -1186,10 +1245,12 @@ namespace temutil {
 
     // check the size
     if (datalist.size() != linesofdata) {
-      BOOST_LOG_SEV(glg, warn) << "Expected " << linesofdata << ". "
-                              << "Found " << datalist.size() << ". "
-                              << "(" << fname << ", community " << cmtnumber << ")";
-      exit(-1);
+      std::stringstream msg;
+      msg << "Expected " << linesofdata << " lines of data. "
+          << "Found " << datalist.size() << ". "
+          << "(" << fname << ", community " << cmtnumber << ")";
+      BOOST_LOG_SEV(glg, fatal) << msg.str();
+      throw std::runtime_error(msg.str());
     }
     
     return datalist;
@@ -60,6 +60,10 @@ void TemperatureUpdator::updateTemps(const double & tdrv, Layer *fstvalidl,
     tit[i] = MISSING_D;
   }
 
+  // layer water and ice are fixed while temperatures are updated, so the
+  //   properties of the column are evaluated once, up front
+  ground->thermal.update(fstvalidl);
+
   bool setfntl = true; //set frontlayer temperature by weighting
                        //  'frozenfrac' of the layer
 
@@ -156,8 +160,8 @@ void TemperatureUpdator::processColumnNofront(Layer* fstvalidl, const double & t
     dx[ind] = currl->dz;
     dx[ind] = temutil::NON_ZERO(dx[ind], 1);
     t[ind] = currl->tem;
-    tca[ind] = currl->getThermalConductivity();
-    double hcap = currl->getHeatCapacity();
+    tca[ind] = ground->thermal.thermalConductivity(currl);
+    double hcap = ground->thermal.heatCapacity(currl);
     double pce = abs(currl->pce_f - currl->pce_t);
     hca[ind] = (pce + hcap);
     cn[ind] = tca[ind] / dx[ind];
@@ -230,8 +234,8 @@ void TemperatureUpdator::processAboveFronts(Layer* fstvalidl, Layer*fstfntl,
     dx[ind] = currl->dz;
     dx[ind] = temutil::NON_ZERO(dx[ind], 1);
     t[ind] = currl->tem;
-    tca[ind] = currl->getThermalConductivity();
-    double hcap = currl->getHeatCapacity();
+    tca[ind] = ground->thermal.thermalConductivity(currl);
+    double hcap = ground->thermal.heatCapacity(currl);
     double pce = abs(currl->pce_f - currl->pce_t);
     hca[ind] = (pce + hcap);
     cn[ind] = tca[ind] / dx[ind];
@@ -256,11 +260,11 @@ void TemperatureUpdator::processAboveFronts(Layer* fstvalidl, Layer*fstfntl,
   dx[ind] = temutil::NON_ZERO(dx[ind], 1);
   double hcap;
   if (frnttype == 1) {
-    tca[ind] = fstfntl->getFrzThermCond();
-    hcap = fstfntl->getFrzVolHeatCapa();
+    tca[ind] = ground->thermal.of(fstfntl).frz_tc;
+    hcap = ground->thermal.of(fstfntl).frz_vhc;
   } else {
-    tca[ind] = fstfntl->getUnfThermCond();
-    hcap = fstfntl->getUnfVolHeatCapa();
+    tca[ind] = ground->thermal.of(fstfntl).unf_tc;
+    hcap = ground->thermal.of(fstfntl).unf_vhc;
   }
   double pce = abs(fstfntl->pce_f-fstfntl->pce_t);
   hca[ind] = (pce + hcap);
@@ -328,11 +332,11 @@ void TemperatureUpdator::processBetweenFronts(Layer*fstfntl, Layer*lstfntl,
   dx[ind] = temutil::NON_ZERO(dx[ind], 1);
   double hcap;
   if (frnttype1 == 1) {
-    tca[ind] = fstfntl->getUnfThermCond();
-    hcap = fstfntl->getUnfVolHeatCapa();
+    tca[ind] = ground->thermal.of(fstfntl).unf_tc;
+    hcap = ground->thermal.of(fstfntl).unf_vhc;
   } else {
-    tca[ind] = fstfntl->getFrzThermCond();
-    hcap = fstfntl->getFrzVolHeatCapa();
+    tca[ind] = ground->thermal.of(fstfntl).frz_tc;
+    hcap = ground->thermal.of(fstfntl).frz_vhc;
   }
   double pce = abs(fstfntl->pce_f-fstfntl->pce_t);
   hca[ind] = (pce + hcap);
@@ -350,8 +354,8 @@ void TemperatureUpdator::processBetweenFronts(Layer*fstfntl, Layer*lstfntl,
     t[ind] = currl->tem;
     dx[ind] = currl->dz;
     dx[ind] = temutil::NON_ZERO(dx[ind], 1);
-    tca[ind] = currl->getThermalConductivity();
-    hcap = currl->getHeatCapacity();
+    tca[ind] = ground->thermal.thermalConductivity(currl);
+    hcap = ground->thermal.heatCapacity(currl);
     pce = abs(currl->pce_f - currl->pce_t);
     hca[ind] = pce + hcap;
     cn[ind] = tca[ind]/dx[ind];
@@ -375,11 +379,11 @@ void TemperatureUpdator::processBetweenFronts(Layer*fstfntl, Layer*lstfntl,
   }
   dx[ind] = temutil::NON_ZERO(dx[ind], 1);
   if (frnttype2 == 1) {
-    tca[ind] = lstfntl->getFrzThermCond();
-    hcap = lstfntl->getFrzVolHeatCapa();
+    tca[ind] = ground->thermal.of(lstfntl).frz_tc;
+    hcap = ground->thermal.of(lstfntl).frz_vhc;
   } else {
-    tca[ind] = lstfntl->getUnfThermCond();
-    hcap = lstfntl->getUnfVolHeatCapa();
+    tca[ind] = ground->thermal.of(lstfntl).unf_tc;
+    hcap = ground->thermal.of(lstfntl).unf_vhc;
   }
   pce = abs(lstfntl->pce_f-lstfntl->pce_t);
   hca[ind] = (pce + hcap);
@@ -455,11 +459,11 @@ void TemperatureUpdator::processBelowFronts(Layer*lstfntl,
   dx[ind] = temutil::NON_ZERO(dx[ind], 1);
   double hcap;
   if (frnttype == 1) {
-    tca[ind] = lstfntl->getUnfThermCond();
-    hcap = lstfntl->getUnfVolHeatCapa();
+    tca[ind] = ground->thermal.of(lstfntl).unf_tc;
+    hcap = ground->thermal.of(lstfntl).unf_vhc;
   } else {
-    tca[ind] = lstfntl->getFrzThermCond();
-    hcap = lstfntl->getFrzVolHeatCapa();
+    tca[ind] = ground->thermal.of(lstfntl).frz_tc;
+    hcap = ground->thermal.of(lstfntl).frz_vhc;
   }
   double pce = abs(lstfntl->pce_f-lstfntl->pce_t);
   hca[ind] = (pce + hcap);
@@ -474,8 +478,8 @@ void TemperatureUpdator::processBelowFronts(Layer*lstfntl,
     t[ind] = currl->tem;
     dx[ind] = currl->dz;
     dx[ind] = temutil::NON_ZERO(dx[ind], 1);
-    tca[ind] = currl->getThermalConductivity();
-    hcap = currl->getHeatCapacity();
+    tca[ind] = ground->thermal.thermalConductivity(currl);
+    hcap = ground->thermal.heatCapacity(currl);
     pce = abs(currl->pce_f - currl->pce_t);
     hca[ind] = pce + hcap;
     cn[ind] = tca[ind]/dx[ind];
@@ -558,6 +562,7 @@ void TemperatureUpdator::iterate(const int &startind, const int &endind) {
     int st = updateOneTimeStep(startind, endind);
 
     if (st == -1) {
+      stats.rejections++;
       // half the time step
       tstep = tstep / 2;
 
@@ -567,6 +572,10 @@ void TemperatureUpdator::iterate(const int &startind, const int &endind) {
 
       tschanged = true;
     } else if (st == 0) {
+      stats.substeps++;
+      if (tstep <= TSTEPMIN) {
+        stats.min_steps++;
+      }
       // find one solution for one timestep, advance to next one
       for (int i = startind; i <= endind; i++) {
         tis[i] = tld[i];
@@ -594,6 +603,12 @@ void TemperatureUpdator::iterate(const int &startind, const int &endind) {
       }
     }
   } // end of while
+
+  stats.solves++;
+  stats.iterations += itsum;
+  if (itsum > stats.max_iterations) {
+    stats.max_iterations = itsum;
+  }
   } // Closes BOOST named scope
 }
 
@@ -0,0 +1,139 @@
+/*! \file
+ * See ThermalProperties.h
+ */
+
+#include "../include/ThermalProperties.h"
+#include "../include/SoilLayer.h"
+#include "../include/SnowLayer.h"
+#include "../include/ParentLayer.h"
+
+ThermalProperties::ThermalProperties() {
+  invalidate();
+};
+
+void ThermalProperties::invalidate() {
+  for (int i = 0; i <= LayerPool::CAPACITY; i++) {
+    entries[i].layer = NULL;
+  }
+
+  scratch.layer = NULL;
+};
+
+void ThermalProperties::update(Layer* toplayer) {
+  Layer* currl = toplayer;
+
+  while (currl != NULL) {
+    of(currl);
+    currl = currl->nextl;
+  }
+};
+
+/** The values for a layer, re-evaluated only if the layer has changed
+ *  since they were last evaluated. */
+const ThermalProperties::LayerValues& ThermalProperties::of(Layer* l) {
+  Entry& e = (l->indl >= 1 && l->indl <= LayerPool::CAPACITY) ?
+             entries[l->indl] : scratch;
+
+  if (!current(e, l)) {
+    evaluate(e, l);
+  }
+
+  return e.values;
+};
+
+double ThermalProperties::thermalConductivity(Layer* l) {
+  const LayerValues& v = of(l);
+  double tc = MISSING_D;
+
+  if(l->isSoil || l->isSnow) {
+    if(l->frozen==1) {
+      tc = v.frz_tc;
+    } else {
+      tc = v.unf_tc;
+    }
+  } else if (l->isRock) {
+    tc = v.frz_tc;
+  }
+
+  l->tcond = tc;
+  return tc;
+};
+
+double ThermalProperties::heatCapacity(Layer* l) {
+  const LayerValues& v = of(l);
+  double hcap = MISSING_D;
+
+  if(l->isSoil) {
+    if(l->frozen==-1) {
+      hcap = v.unf_vhc;
+    } else if(l->frozen ==1) {
+      hcap = v.frz_vhc;
+    } else if(l->frozen ==0) {
+      hcap = v.mix_vhc;
+    }
+  } else if(l->isSnow || l->isRock) {
+    hcap = v.frz_vhc;
+  }
+
+  return hcap;
+};
+
+bool ThermalProperties::current(const Entry& e, const Layer* l) const {
+  return e.layer == l && e.tkey == l->tkey
+         && e.liq == l->liq && e.ice == l->ice && e.dz == l->dz
+         && e.rho == l->rho && e.poro == l->poro;
+};
+
+/** Evaluates the five properties of a layer with the qualified (so not
+ *  virtual) functions of its class. */
+void ThermalProperties::evaluate(Entry& e, Layer* l) {
+  LayerValues& v = e.values;
+
+  switch (l->tkey) {
+  case Layer::I_MOSS:
+  case Layer::I_FIB:
+  case Layer::I_HUM:
+  case Layer::I_MINE: {
+    SoilLayer* sl = static_cast<SoilLayer*>(l);
+    v.frz_tc  = sl->SoilLayer::getFrzThermCond();
+    v.unf_tc  = sl->SoilLayer::getUnfThermCond();
+    v.frz_vhc = sl->SoilLayer::getFrzVolHeatCapa();
+    v.unf_vhc = sl->SoilLayer::getUnfVolHeatCapa();
+    v.mix_vhc = sl->SoilLayer::getMixVolHeatCapa();
+    break;
+  }
+  case Layer::I_SNOW: {
+    SnowLayer* snl = static_cast<SnowLayer*>(l);
+    v.frz_tc  = snl->SnowLayer::getFrzThermCond();
+    v.unf_tc  = v.frz_tc;
+    v.frz_vhc = snl->SnowLayer::getFrzVolHeatCapa();
+    v.unf_vhc = v.frz_vhc;
+    v.mix_vhc = v.frz_vhc;
+    break;
+  }
+  case Layer::I_ROCK: {
+    ParentLayer* pl = static_cast<ParentLayer*>(l);
+    v.frz_tc  = pl->ParentLayer::getFrzThermCond();
+    v.unf_tc  = v.frz_tc;
+    v.frz_vhc = pl->ParentLayer::getFrzVolHeatCapa();
+    v.unf_vhc = v.frz_vhc;
+    v.mix_vhc = v.frz_vhc;
+    break;
+  }
+  default:
+    v.frz_tc  = l->getFrzThermCond();
+    v.unf_tc  = l->getUnfThermCond();
+    v.frz_vhc = l->getFrzVolHeatCapa();
+    v.unf_vhc = l->getUnfVolHeatCapa();
+    v.mix_vhc = l->getMixVolHeatCapa();
+    break;
+  }
+
+  e.layer = l;
+  e.tkey = l->tkey;
+  e.liq = l->liq;
+  e.ice = l->ice;
+  e.dz = l->dz;
+  e.rho = l->rho;
+  e.poro = l->poro;
+};
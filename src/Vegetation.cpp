@@ -36,56 +36,34 @@ Vegetation::Vegetation() {
 Vegetation::Vegetation(int cmtnum, const ModelData* mdp) {
 
 
-  // This seems horribly brittle now as it really depends on the order and
-  // presence of the lines in the parameter file...
-
   BOOST_LOG_SEV(glg, info) << "Vegetation constructor. Community type: " << cmtnum;
 
-  BOOST_LOG_SEV(glg, info) << "Setting Vegetation internal values from file: "
-                           << mdp->parameter_dir << "cmt_dimvegetation.txt";
-
+  BOOST_LOG_SEV(glg, info) << "Setting Vegetation internal values from the "
+                           << "cached parameters in " << mdp->parameter_dir;
 
   // MAYBE WE DON'T NEED TO SET PARAMETERS HERE? -
   // They are set later in CohortLookup, and then read into the veg structure.
 
-  // get a list of data for the cmt number
-  std::list<std::string> l = temutil::parse_parameter_file(
-      mdp->parameter_dir + "cmt_dimvegetation.txt", cmtnum, 40
+  // The lookup for this community type, shared with the cohort, so that
+  // cmt_dimvegetation.txt isn't parsed a second time for every cell.
+  boost::shared_ptr<const CohortLookup> lu = CohortLookup::cached(
+      mdp->parameter_dir, temutil::cmtnum2str(cmtnum)
   );
 
-
-  // FIX THIS?? Why are some parameters not being set?? (ifwoody, etc..)
-
-  // pop each line off the front of the list
-  // and assign to the right data member.
-  temutil::pfll2data_pft(l, vegdimpar.cov);
-  l.pop_front(); // ifwoody
-  l.pop_front(); // ifdeciwoody
-  l.pop_front(); // ifperenial
-  l.pop_front(); // nonvascular
-  temutil::pfll2data_pft(l, vegdimpar.sla);
-  temutil::pfll2data_pft(l, vegdimpar.klai);
-  temutil::pfll2data_pft(l, vegdimpar.minleaf);
-  temutil::pfll2data_pft(l, vegdimpar.aleaf);
-  temutil::pfll2data_pft(l, vegdimpar.bleaf);
-  temutil::pfll2data_pft(l, vegdimpar.cleaf);
-  temutil::pfll2data_pft(l, vegdimpar.kfoliage);
-  l.front();
-  temutil::pfll2data_pft(l, vegdimpar.cov);
-  temutil::pfll2data_pft(l, vegdimpar.m1);
-  temutil::pfll2data_pft(l, vegdimpar.m2);
-  temutil::pfll2data_pft(l, vegdimpar.m3);
-  temutil::pfll2data_pft(l, vegdimpar.m4);
-
-//  for (int i = 0; i < MAX_ROT_LAY; i++) {
-//    temutil::pfll2data_pft(l, vegdimpar.frootfrac[i]);
-//  }
-//
-//  temutil::pfll2data_pft(l, vegdimpar.lai);
-//
-//  for (int im = 0; im < MINY; im++) {
-//    temutil::pfll2data_pft( l, vegdimpar.static_lai[im]);
-//  }
+  for (int ip = 0; ip < NUM_PFT; ip++) {
+    vegdimpar.sla[ip] = lu->sla[ip];
+    vegdimpar.klai[ip] = lu->klai[ip];
+    vegdimpar.minleaf[ip] = lu->minleaf[ip];
+    vegdimpar.aleaf[ip] = lu->aleaf[ip];
+    vegdimpar.bleaf[ip] = lu->bleaf[ip];
+    vegdimpar.cleaf[ip] = lu->cleaf[ip];
+    vegdimpar.kfoliage[ip] = lu->kfoliage[ip];
+    vegdimpar.cov[ip] = lu->cov[ip];
+    vegdimpar.m1[ip] = lu->m1[ip];
+    vegdimpar.m2[ip] = lu->m2[ip];
+    vegdimpar.m3[ip] = lu->m3[ip];
+    vegdimpar.m4[ip] = lu->m4[ip];
+  }
 }
 
 Vegetation::~Vegetation() {
@@ -27,6 +27,7 @@
 #include "../include/WildFire.h"
 
 #include "../include/TEMUtilityFunctions.h"
+#include "../include/InputFiles.h"
 #include "../include/TEMLogger.h"
 
 extern src::severity_logger< severity_level > glg;
@@ -40,23 +41,14 @@ WildFire::WildFire(const std::string& fri_fname,
                    const double cell_aspect, const double cell_elevation,
                    const int y, const int x) {
 
-  #pragma omp critical(load_input)
-  {
-    BOOST_LOG_SEV(glg, info) << "Setting up FRI fire data...";
-    this->fri = temutil::get_scalar<int>(fri_fname, "fri", y, x);
-    this->fri_severity = temutil::get_scalar<int>(fri_fname, "fri_severity", y, x);
-    this->fri_jday_of_burn = temutil::get_scalar<int>(fri_fname, "fri_jday_of_burn", y, x);
-    this->fri_area_of_burn = temutil::get_scalar<int>(fri_fname, "fri_area_of_burn", y, x);
-  }//End critical(fri)
-
-  #pragma omp critical(load_input)
-  {
-    BOOST_LOG_SEV(glg, info) << "Setting up explicit fire data...";
-    this->exp_burn_mask = temutil::get_timeseries<int>(exp_fname, "exp_burn_mask", y, x);
-    this->exp_fire_severity = temutil::get_timeseries<int>(exp_fname, "exp_fire_severity", y, x);
-    this->exp_jday_of_burn = temutil::get_timeseries<int>(exp_fname, "exp_jday_of_burn", y, x);
-    this->exp_area_of_burn = temutil::get_timeseries<int64_t>(exp_fname, "exp_area_of_burn", y, x);
-  }//End critical(exp_fir) 
+  BOOST_LOG_SEV(glg, info) << "Setting up FRI fire data...";
+  InputPass(fri_fname, y, x).scalar("fri", this->fri)
+                            .scalar("fri_severity", this->fri_severity)
+                            .scalar("fri_jday_of_burn", this->fri_jday_of_burn)
+                            .scalar("fri_area_of_burn", this->fri_area_of_burn)
+                            .read();
+
+  this->load_projected_explicit_data(exp_fname, y, x);
 
   this->slope = cell_slope;
   this->asp = cell_aspect;
@@ -68,11 +60,12 @@ WildFire::WildFire(const std::string& fri_fname,
 }
 
 void WildFire::load_projected_explicit_data(const std::string& exp_fname, int y, int x) {
-    BOOST_LOG_SEV(glg, info) << "Setting up explicit fire data...";
-    this->exp_burn_mask = temutil::get_timeseries<int>(exp_fname, "exp_burn_mask", y, x);
-    this->exp_fire_severity = temutil::get_timeseries<int>(exp_fname, "exp_fire_severity", y, x);
-    this->exp_jday_of_burn = temutil::get_timeseries<int>(exp_fname, "exp_jday_of_burn", y, x);
-    this->exp_area_of_burn = temutil::get_timeseries<int64_t>(exp_fname, "exp_area_of_burn", y, x);
+  BOOST_LOG_SEV(glg, info) << "Setting up explicit fire data...";
+  InputPass(exp_fname, y, x).series("exp_burn_mask", this->exp_burn_mask)
+                            .series("exp_fire_severity", this->exp_fire_severity)
+                            .series("exp_jday_of_burn", this->exp_jday_of_burn)
+                            .series("exp_area_of_burn", this->exp_area_of_burn)
+                            .read();
 }
 
 /** Assemble and return a string with a bunch of data from this class */